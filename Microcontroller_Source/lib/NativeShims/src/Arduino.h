@@ -0,0 +1,86 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#ifndef ENGINEERING_PROJECT_NATIVE_ARDUINO_H
+#define ENGINEERING_PROJECT_NATIVE_ARDUINO_H
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+// Only what the firmware outside Display and the USB and flash classes uses is provided. The time, ADC and GPIO
+// functions are driven by the tests through NativeShims.h.
+
+#define HIGH        0x1
+#define LOW         0x0
+
+#define INPUT       0x01
+#define OUTPUT      0x03
+#define INPUT_PULLUP    0x05
+
+#define RISING      0x01
+#define FALLING     0x02
+#define CHANGE      0x03
+
+#define IRAM_ATTR
+
+typedef struct hw_timer_s hw_timer_t;
+
+uint32_t millis();
+uint32_t micros();
+
+void pinMode(uint8_t Pin, uint8_t Mode);
+void digitalWrite(uint8_t Pin, uint8_t Value);
+int digitalRead(uint8_t Pin);
+uint16_t analogRead(uint8_t Pin);
+void analogReadResolution(uint8_t Bits);
+void analogWrite(uint8_t Pin, int Value);
+void analogWriteFrequency(uint32_t Frequency);
+void analogWriteResolution(uint8_t Bits);
+
+uint8_t digitalPinToInterrupt(uint8_t Pin);
+void attachInterrupt(uint8_t Interrupt, void (*InterruptHandler)(), int Mode);
+void noInterrupts();
+void interrupts();
+
+hw_timer_t* timerBegin(uint8_t Timer, uint16_t Divider, bool CountUp);
+void timerAttachInterrupt(hw_timer_t* Timer, void (*InterruptHandler)(), bool Edge);
+void timerAlarmWrite(hw_timer_t* Timer, uint64_t AlarmValue, bool AutoReload);
+void timerAlarmEnable(hw_timer_t* Timer);
+uint64_t timerRead(hw_timer_t* Timer);
+
+class EspClass
+{
+public:
+	uint32_t getCycleCount();
+};
+
+class HostSerial
+{
+public:
+	void begin(unsigned long Baud);
+	void end();
+	int available();
+	int availableForWrite();
+	size_t readBytes(uint8_t* Buffer, size_t Length);
+	size_t write(const uint8_t* Buffer, size_t Size);
+	size_t print(const char* Text);
+	size_t println(const char* Text);
+};
+
+extern EspClass ESP;
+extern HostSerial Serial;
+
+#endif //ENGINEERING_PROJECT_NATIVE_ARDUINO_H
@@ -0,0 +1,54 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include "Misc/SerialHandler.h"
+
+#include <iostream>
+
+
+// The host build has no USB port to wait for, so messages are written straight to stdout, where the test runner shows them.
+
+
+void SerialHandler::Init(bool)
+{
+}
+
+std::vector<uint8_t> SerialHandler::ReadAllData()
+{
+	return {};
+}
+
+std::string SerialHandler::ReadAllDataAsString()
+{
+	return {};
+}
+
+void SerialHandler::SetState(bool)
+{
+}
+
+void SerialHandler::SafeWriteLn(const std::string& TextOut, const bool ShouldWrite)
+{
+	SafeWriteLn(TextOut.c_str(), ShouldWrite);
+}
+
+void SerialHandler::SafeWriteLn(const char* TextOut, const bool ShouldWrite)
+{
+	if (ShouldWrite)
+	{
+		std::cout << TextOut << std::endl;
+	}
+}
+
+void SerialHandler::TryWriteBufferToSerial()
+{
+}
@@ -0,0 +1,237 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include "NativeShims.h"
+
+#include <Arduino.h>
+#include <array>
+#include <chrono>
+#include <iostream>
+
+
+#define PIN_COUNT                   22
+#define CPU_CYCLES_PER_MICROSECOND  160
+
+
+EspClass ESP;
+HostSerial Serial;
+
+static uint32_t clockMicros = 0;
+static std::array<uint16_t, PIN_COUNT> analogReadValues = {};
+static std::array<uint8_t, PIN_COUNT> pinStates = {};
+static uint16_t (*analogReadSource)(uint8_t Pin) = nullptr;
+static void (*digitalWriteHook)(uint8_t Pin, uint8_t Value) = nullptr;
+
+
+/**
+ * @brief  Puts the clock back to 0, and clears every pin, ADC value and hook.
+*/
+void NativeShims::Reset()
+{
+	clockMicros = 0;
+	analogReadValues = {};
+	pinStates = {};
+	analogReadSource = nullptr;
+	digitalWriteHook = nullptr;
+}
+
+/**
+ * @brief                Moves the simulated clock on.
+ *
+ * @param  Microseconds  How far to move it.
+*/
+void NativeShims::AdvanceMicros(const uint32_t Microseconds)
+{
+	clockMicros += Microseconds;
+}
+
+/**
+ * @brief           Sets what analogRead returns for a pin, when no analogRead source has been given.
+ *
+ * @param  Pin      The pin to set.
+ * @param  AdcCode  The ADC code it reads.
+*/
+void NativeShims::SetAnalogReadValue(const uint8_t Pin, const uint16_t AdcCode)
+{
+	analogReadValues.at(Pin) = AdcCode;
+}
+
+/**
+ * @brief                      Has analogRead call a function instead of returning the values set for each pin.
+ *
+ * @param  AnalogReadFunction  The function to call, or nullptr to go back to the values set for each pin.
+*/
+void NativeShims::SetAnalogReadSource(uint16_t (*AnalogReadFunction)(uint8_t Pin))
+{
+	analogReadSource = AnalogReadFunction;
+}
+
+/**
+ * @brief                        Has digitalWrite call a function every time a pin is written.
+ *
+ * @param  DigitalWriteFunction  The function to call, or nullptr for none.
+*/
+void NativeShims::SetDigitalWriteHook(void (*DigitalWriteFunction)(uint8_t Pin, uint8_t Value))
+{
+	digitalWriteHook = DigitalWriteFunction;
+}
+
+/**
+ * @brief       Gets the level a pin was last written to.
+ *
+ * @param  Pin  The pin to get.
+ *
+ * @returns     HIGH or LOW.
+*/
+uint8_t NativeShims::GetPinState(const uint8_t Pin)
+{
+	return pinStates.at(Pin);
+}
+
+
+uint32_t millis()
+{
+	return micros() / 1000;
+}
+
+uint32_t micros()
+{
+	clockMicros++;
+	return clockMicros;
+}
+
+void pinMode(uint8_t, uint8_t)
+{
+}
+
+void digitalWrite(const uint8_t Pin, const uint8_t Value)
+{
+	pinStates.at(Pin) = Value;
+	if (digitalWriteHook != nullptr)
+	{
+		digitalWriteHook(Pin, Value);
+	}
+}
+
+int digitalRead(const uint8_t Pin)
+{
+	return pinStates.at(Pin);
+}
+
+uint16_t analogRead(const uint8_t Pin)
+{
+	return (analogReadSource != nullptr) ? analogReadSource(Pin) : analogReadValues.at(Pin);
+}
+
+void analogReadResolution(uint8_t)
+{
+}
+
+void analogWrite(uint8_t, int)
+{
+}
+
+void analogWriteFrequency(uint32_t)
+{
+}
+
+void analogWriteResolution(uint8_t)
+{
+}
+
+uint8_t digitalPinToInterrupt(const uint8_t Pin)
+{
+	return Pin;
+}
+
+void attachInterrupt(uint8_t, void (*)(), int)
+{
+}
+
+void noInterrupts()
+{
+}
+
+void interrupts()
+{
+}
+
+// There is no timer to interrupt from on the host, so the hardware timer modes report that it couldn't be started.
+hw_timer_t* timerBegin(uint8_t, uint16_t, bool)
+{
+	return nullptr;
+}
+
+void timerAttachInterrupt(hw_timer_t*, void (*)(), bool)
+{
+}
+
+void timerAlarmWrite(hw_timer_t*, uint64_t, bool)
+{
+}
+
+void timerAlarmEnable(hw_timer_t*)
+{
+}
+
+uint64_t timerRead(hw_timer_t*)
+{
+	return 0;
+}
+
+uint32_t EspClass::getCycleCount()
+{
+	const auto hostNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	return static_cast<uint32_t>(hostNanoseconds * CPU_CYCLES_PER_MICROSECOND / 1000);
+}
+
+void HostSerial::begin(unsigned long)
+{
+}
+
+void HostSerial::end()
+{
+}
+
+int HostSerial::available()
+{
+	return 0;
+}
+
+int HostSerial::availableForWrite()
+{
+	return 0;
+}
+
+size_t HostSerial::readBytes(uint8_t*, size_t)
+{
+	return 0;
+}
+
+size_t HostSerial::write(const uint8_t* Buffer, const size_t Size)
+{
+	std::cout.write(reinterpret_cast<const char*>(Buffer), static_cast<std::streamsize>(Size));
+	return Size;
+}
+
+size_t HostSerial::print(const char* Text)
+{
+	std::cout << Text;
+	return std::strlen(Text);
+}
+
+size_t HostSerial::println(const char* Text)
+{
+	std::cout << Text << std::endl;
+	return std::strlen(Text) + 1;
+}
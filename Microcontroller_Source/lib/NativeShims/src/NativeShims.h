@@ -0,0 +1,35 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#ifndef ENGINEERING_PROJECT_NATIVE_SHIMS_H
+#define ENGINEERING_PROJECT_NATIVE_SHIMS_H
+
+#include <cstdint>
+
+/**
+ * @brief  Drives the host build's stand-ins for the Arduino core from the tests.
+ *
+ * The clock is simulated, so a test decides exactly how long passes between two calls. Each read of millis() or micros()
+ * moves it on by 1 us, so code that waits on the clock still finishes. ESP.getCycleCount() follows the host's own clock
+ * instead, at the ESP32-C3's 160 cycles per microsecond, so the firmware's cycle counts come out as host nanoseconds.
+*/
+class NativeShims
+{
+public:
+	static void Reset();
+	static void AdvanceMicros(uint32_t Microseconds);
+	static void SetAnalogReadValue(uint8_t Pin, uint16_t AdcCode);
+	static void SetAnalogReadSource(uint16_t (*AnalogReadFunction)(uint8_t Pin));
+	static void SetDigitalWriteHook(void (*DigitalWriteFunction)(uint8_t Pin, uint8_t Value));
+	static uint8_t GetPinState(uint8_t Pin);
+};
+
+#endif //ENGINEERING_PROJECT_NATIVE_SHIMS_H
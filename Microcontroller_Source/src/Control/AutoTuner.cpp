@@ -0,0 +1,446 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "AutoTuner.h"
+
+#include <Arduino.h>
+#include <cmath>
+
+#include "Control/PIDController.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+#define RELAY_HIGH_OUTPUT_PERCENT       60.0f
+#define RELAY_LOW_OUTPUT_PERCENT        0.0f
+#define RELAY_HYSTERESIS_DEG_CENT       0.2f
+
+#define OSCILLATIONS_TO_DISCARD         1       // The first oscillation still contains the warm-up transient.
+#define OSCILLATIONS_TO_MEASURE         4
+#define MAX_TUNING_TIME_MS              (60 * 60 * 1000)
+#define MAX_OVERSHOOT_DEG_CENT          10.0f
+
+
+bool AutoTuner::debug_Start = false;
+bool AutoTuner::debug_SetCurrentTemperature = false;
+bool AutoTuner::debug_calculateGains = false;
+
+bool AutoTuner::isRelayOutputHigh = false;
+bool AutoTuner::newlyTunedGainsAreAvailable = false;
+uint8_t AutoTuner::oscillationsCompleted = 0;
+uint32_t AutoTuner::relayHighReadingCount = 0;
+uint32_t AutoTuner::millisValueAtStart = 0;
+uint32_t AutoTuner::millisValueAtLastHighToLowSwitch = 0;
+float AutoTuner::temperatureSetPointDegCent = 0.0;
+float AutoTuner::outputMaxValue = 0.0;
+float AutoTuner::outputLimitPercent = 100.0;
+float AutoTuner::relayHighOutputSum = 0.0;
+float AutoTuner::highestTemperatureThisCycle = 0.0;
+float AutoTuner::lowestTemperatureThisCycle = 0.0;
+float AutoTuner::oscillationPeriodSumMs = 0.0;
+float AutoTuner::oscillationAmplitudeSum = 0.0;
+AutoTuner::pidGains AutoTuner::tunedGains = {};
+AutoTuner::TuningRules AutoTuner::tuningRule = TyreusLuybenPID;
+AutoTuner::AutoTunerStates AutoTuner::currentState = Idle;
+
+
+/**
+ * @brief        Initialises the Auto Tuner class.
+ *
+ * @param  Rule  The tuning rule used to turn the measured oscillation into PID gains.
+*/
+void AutoTuner::Init(const TuningRules Rule)
+{
+	enableDebugTriggers();
+
+	tuningRule = Rule;
+}
+
+/**
+ * @brief                              Starts a relay feedback tuning run.
+ *
+ * @param  TemperatureSetPointDegCent  The temperature to oscillate around, in °C.
+ * @param  OutputMaxValue              The PID Controller's Output Max setting, used to scale the gains.
+*/
+void AutoTuner::Start(const float TemperatureSetPointDegCent, const float OutputMaxValue)
+{
+	temperatureSetPointDegCent = TemperatureSetPointDegCent;
+	outputMaxValue = OutputMaxValue;
+	oscillationsCompleted = 0;
+	oscillationPeriodSumMs = 0.0;
+	oscillationAmplitudeSum = 0.0;
+	relayHighOutputSum = 0.0;
+	relayHighReadingCount = 0;
+	millisValueAtStart = millis();
+	currentState = WaitingForFirstCrossing;
+
+	// Start by heating. If the air is already above the set point, the first reading will switch the relay off again.
+	switchRelayOutput(true);
+
+	if (debug_Start)
+	{
+		std::string startMsg = Utils::StringFormat("Auto-tune started around %0.1f°C", temperatureSetPointDegCent);
+		SerialHandler::SafeWriteLn(startMsg, true);
+	}
+}
+
+/**
+ * @brief  Aborts a tuning run, if one is active.
+*/
+void AutoTuner::Stop()
+{
+	if (!IsActive())
+	{
+		return;
+	}
+
+	SerialHandler::SafeWriteLn("Auto-tune was stopped.", debug_Start);
+	endTuningRun(Idle);
+}
+
+/**
+ * @brief  Checks if the tuning run has taken too long.
+*/
+void AutoTuner::Update()
+{
+	if (!IsActive())
+	{
+		return;
+	}
+
+	if ((millis() - millisValueAtStart) >= MAX_TUNING_TIME_MS)
+	{
+		fail("Auto-tune timed out before a stable oscillation was measured.");
+	}
+}
+
+/**
+ * @brief   Gets the state the Auto Tuner is currently in.
+ *
+ * @return  The current state.
+*/
+AutoTuner::AutoTunerStates AutoTuner::GetState()
+{
+	return currentState;
+}
+
+/**
+ * @brief   Gets the power level the relay is currently asking for.
+ *
+ * @return  The power level as a percentage between 0 and 100.
+*/
+float AutoTuner::GetHeaterPowerLevel()
+{
+	if (!IsActive())
+	{
+		return 0.0;
+	}
+
+	return isRelayOutputHigh ? getRelayHighOutputPercent() : RELAY_LOW_OUTPUT_PERCENT;
+}
+
+/**
+ * @brief                 Fetches the gains calculated by the last successful tuning run, if they haven't been fetched already.
+ *
+ * @param  TunedSettings  Set to the tuned gains, if there are new ones.
+ *
+ * @return                True if new gains were fetched. False otherwise.
+*/
+bool AutoTuner::GetNewlyTunedSettings(std::array<PIDFloatDataPacket, 3>* TunedSettings)
+{
+	if (!newlyTunedGainsAreAvailable)
+	{
+		return false;
+	}
+	newlyTunedGainsAreAvailable = false;
+
+	*TunedSettings = getTunedSettings();
+	return true;
+}
+
+/**
+ * @brief   Checks if a tuning run is currently in progress.
+ *
+ * @return  True if a run is in progress. False otherwise.
+*/
+bool AutoTuner::IsActive()
+{
+	return (currentState == WaitingForFirstCrossing) || (currentState == MeasuringOscillations);
+}
+
+/**
+ * @brief                Caps the relay's high power level, for when the heater can't be given its full power.
+ *
+ * @param  LimitPercent  The highest power level the heater can currently be given, as a percentage.
+*/
+void AutoTuner::SetOutputLimitPercent(const float LimitPercent)
+{
+	outputLimitPercent = LimitPercent;
+}
+
+/**
+ * @brief                      Provides the Auto Tuner with a new temperature reading, and switches the relay if required.
+ *
+ * @param  CurrentTemperature  The new temperature reading in °C.
+*/
+void AutoTuner::SetCurrentTemperature(const float CurrentTemperature)
+{
+	if (!IsActive())
+	{
+		return;
+	}
+
+	if (CurrentTemperature >= (temperatureSetPointDegCent + MAX_OVERSHOOT_DEG_CENT))
+	{
+		fail("Auto-tune aborted because the temperature overshot the set point too far.");
+		return;
+	}
+
+	if (CurrentTemperature > highestTemperatureThisCycle)
+	{
+		highestTemperatureThisCycle = CurrentTemperature;
+	}
+	if (CurrentTemperature < lowestTemperatureThisCycle)
+	{
+		lowestTemperatureThisCycle = CurrentTemperature;
+	}
+
+	// Readings arrive at a steady rate, so averaging the high level over them weights it by how long it was delivered for.
+	if (isRelayOutputHigh && (currentState == MeasuringOscillations) && (oscillationsCompleted >= OSCILLATIONS_TO_DISCARD))
+	{
+		relayHighOutputSum += getRelayHighOutputPercent();
+		relayHighReadingCount++;
+	}
+
+	if (isRelayOutputHigh && (CurrentTemperature > (temperatureSetPointDegCent + RELAY_HYSTERESIS_DEG_CENT)))
+	{
+		switchRelayOutput(false);
+
+		// Each switch from high to low marks the boundary between two oscillations.
+		const uint32_t millisValueNow = millis();
+		if (currentState == WaitingForFirstCrossing)
+		{
+			currentState = MeasuringOscillations;
+			millisValueAtLastHighToLowSwitch = millisValueNow;
+		}
+		else
+		{
+			recordOscillation(millisValueNow);
+		}
+
+		highestTemperatureThisCycle = CurrentTemperature;
+		lowestTemperatureThisCycle = CurrentTemperature;
+	}
+	else if (!isRelayOutputHigh && (CurrentTemperature < (temperatureSetPointDegCent - RELAY_HYSTERESIS_DEG_CENT)))
+	{
+		switchRelayOutput(true);
+	}
+
+	if (debug_SetCurrentTemperature)
+	{
+		std::string relayStateMsg = Utils::StringFormat("Auto-tune temperature: %0.2f, relay: %s, oscillations completed: %u",
+		                                                CurrentTemperature, isRelayOutputHigh ? "High" : "Low", oscillationsCompleted);
+		SerialHandler::SafeWriteLn(relayStateMsg, true);
+	}
+}
+
+/**
+ * @brief                Changes the relay's output level.
+ *
+ * @param  ShouldBeHigh  True if the relay should ask for the high power level. False for the low power level.
+*/
+void AutoTuner::switchRelayOutput(const bool ShouldBeHigh)
+{
+	isRelayOutputHigh = ShouldBeHigh;
+}
+
+/**
+ * @brief   Gets the relay's high power level, capped to whatever the heater can currently be given.
+ *
+ * @return  The power level as a percentage.
+*/
+float AutoTuner::getRelayHighOutputPercent()
+{
+	return (outputLimitPercent < RELAY_HIGH_OUTPUT_PERCENT) ? outputLimitPercent : RELAY_HIGH_OUTPUT_PERCENT;
+}
+
+/**
+ * @brief                  Records the period and amplitude of the oscillation that just finished.
+ *
+ * @param  MillisValueNow  The millis() value at the end of the oscillation.
+*/
+void AutoTuner::recordOscillation(const uint32_t MillisValueNow)
+{
+	const uint32_t oscillationPeriodMs = MillisValueNow - millisValueAtLastHighToLowSwitch;
+	millisValueAtLastHighToLowSwitch = MillisValueNow;
+
+	oscillationsCompleted++;
+	if (oscillationsCompleted <= OSCILLATIONS_TO_DISCARD)
+	{
+		return;
+	}
+
+	oscillationPeriodSumMs += static_cast<float>(oscillationPeriodMs);
+	oscillationAmplitudeSum += (highestTemperatureThisCycle - lowestTemperatureThisCycle) / 2;
+
+	if (oscillationsCompleted >= (OSCILLATIONS_TO_DISCARD + OSCILLATIONS_TO_MEASURE))
+	{
+		finish();
+	}
+}
+
+/**
+ * @brief  Calculates the PID gains from the measured oscillations and passes them to the PID Controller.
+*/
+void AutoTuner::finish()
+{
+	const float averageAmplitude = oscillationAmplitudeSum / OSCILLATIONS_TO_MEASURE;
+	const float ultimatePeriodMinutes = oscillationPeriodSumMs / OSCILLATIONS_TO_MEASURE / 1000 / 60;
+	if (averageAmplitude <= RELAY_HYSTERESIS_DEG_CENT)
+	{
+		fail("Auto-tune failed because the oscillation was smaller than the relay's hysteresis.");
+		return;
+	}
+
+	// Describing function of a relay with hysteresis. The amplitude is corrected for the hysteresis band. The relay's high
+	// level is the one that was actually delivered, as a derated heater would otherwise make the plant look more sensitive.
+	const float relayHighOutputPercent = (relayHighReadingCount > 0) ?
+		relayHighOutputSum / static_cast<float>(relayHighReadingCount) :
+		RELAY_HIGH_OUTPUT_PERCENT;
+	const float relayAmplitude = (relayHighOutputPercent - RELAY_LOW_OUTPUT_PERCENT) / 2;
+	const float correctedAmplitude = std::sqrt(averageAmplitude * averageAmplitude - RELAY_HYSTERESIS_DEG_CENT * RELAY_HYSTERESIS_DEG_CENT);
+	const float ultimateGainPercent = 4 * relayAmplitude / (static_cast<float>(M_PI) * correctedAmplitude);
+
+	// The PID Controller's output is scaled so that Output Max corresponds to 100% power.
+	const float ultimateGain = ultimateGainPercent * outputMaxValue / 100;
+
+	tunedGains = calculateGains(tuningRule, ultimateGain, ultimatePeriodMinutes);
+	for (const PIDFloatDataPacket& tunedSetting : getTunedSettings())
+	{
+		PIDController::ChangeFloatSetting(tunedSetting);
+	}
+	newlyTunedGainsAreAvailable = true;
+
+	endTuningRun(Complete);
+
+	if (debug_calculateGains)
+	{
+		std::string resultsMsg = Utils::StringFormat("Auto-tune measured Ku: %0.3f, Tu: %0.3f minutes", ultimateGain, ultimatePeriodMinutes);
+		SerialHandler::SafeWriteLn(resultsMsg, true);
+
+		const char* ruleNames[] = {"Ziegler-Nichols PI", "Ziegler-Nichols PID", "Tyreus-Luyben PI", "Tyreus-Luyben PID"};
+		for (uint8_t rule = ZieglerNicholsPI; rule <= TyreusLuybenPID; ++rule)
+		{
+			const pidGains ruleGains = calculateGains(static_cast<TuningRules>(rule), ultimateGain, ultimatePeriodMinutes);
+			std::string ruleGainsMsg = Utils::StringFormat("%s gains: P %0.3f, I %0.3f, D %0.3f", ruleNames[rule],
+			                                               ruleGains.ProportionalGain, ruleGains.IntegralGain, ruleGains.DerivativeGain);
+			SerialHandler::SafeWriteLn(ruleGainsMsg, true);
+		}
+	}
+}
+
+/**
+ * @brief                         Turns the ultimate gain and period into PID gains.
+ *
+ * @param  Rule                   The tuning rule to use.
+ * @param  UltimateGain           The ultimate gain, in PID Controller output units per °C.
+ * @param  UltimatePeriodMinutes  The ultimate period in minutes, to match the PID Controller's time base.
+ *
+ * @return                        The calculated gains.
+*/
+AutoTuner::pidGains AutoTuner::calculateGains(const TuningRules Rule, const float UltimateGain, const float UltimatePeriodMinutes)
+{
+	float proportionalGain;
+	float integralTimeMinutes;
+	float derivativeTimeMinutes;
+
+	switch (Rule)
+	{
+		case ZieglerNicholsPI:
+			proportionalGain = 0.45f * UltimateGain;
+			integralTimeMinutes = UltimatePeriodMinutes / 1.2f;
+			derivativeTimeMinutes = 0.0;
+			break;
+
+		case ZieglerNicholsPID:
+			proportionalGain = 0.6f * UltimateGain;
+			integralTimeMinutes = UltimatePeriodMinutes / 2;
+			derivativeTimeMinutes = UltimatePeriodMinutes / 8;
+			break;
+
+		case TyreusLuybenPI:
+			proportionalGain = UltimateGain / 3.2f;
+			integralTimeMinutes = UltimatePeriodMinutes * 2.2f;
+			derivativeTimeMinutes = 0.0;
+			break;
+
+		case TyreusLuybenPID:
+		default:
+			proportionalGain = UltimateGain / 2.2f;
+			integralTimeMinutes = UltimatePeriodMinutes * 2.2f;
+			derivativeTimeMinutes = UltimatePeriodMinutes / 6.3f;
+			break;
+	}
+
+	pidGains gains = {};
+	gains.ProportionalGain = proportionalGain;
+	gains.IntegralGain = proportionalGain / integralTimeMinutes;
+	gains.DerivativeGain = proportionalGain * derivativeTimeMinutes;
+	return gains;
+}
+
+/**
+ * @brief   Packages the gains calculated by the last successful tuning run as settings packets.
+ *
+ * @return  The tuned gains.
+*/
+std::array<PIDFloatDataPacket, 3> AutoTuner::getTunedSettings()
+{
+	return {{
+			{ProportionalGain, tunedGains.ProportionalGain},
+			{IntegralGain, tunedGains.IntegralGain},
+			{DerivativeGain, tunedGains.DerivativeGain}
+	}};
+}
+
+/**
+ * @brief          Ends the tuning run without changing the PID Controller's gains.
+ *
+ * @param  Reason  The reason the run failed (for debug message).
+*/
+void AutoTuner::fail(const char* Reason)
+{
+	SerialHandler::SafeWriteLn(Reason, debug_Start);
+	endTuningRun(Failed);
+}
+
+/**
+ * @brief              Ends the tuning run and hands control back to the PID Controller.
+ *
+ * @param  FinalState  The state the Auto Tuner should be left in.
+*/
+void AutoTuner::endTuningRun(const AutoTunerStates FinalState)
+{
+	currentState = FinalState;
+	switchRelayOutput(false);
+}
+
+/**
+ * @brief  Used to instruct given functions to use their debug code.
+ *
+ * @note   Uncomment the booleans that represent the functions you want to debug.
+*/
+void AutoTuner::enableDebugTriggers()
+{
+//	debug_Start = true;
+//	debug_SetCurrentTemperature = true;
+//	debug_calculateGains = true;
+}
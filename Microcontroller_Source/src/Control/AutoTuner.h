@@ -0,0 +1,106 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_AUTO_TUNER_H
+#define ENGINEERING_PROJECT_AUTO_TUNER_H
+
+#include <array>
+#include <cstdint>
+
+#include "InitDataTypes/PIDControllerData.h"
+
+/**
+ * @brief  Works out PID gains on the device using Åström–Hägglund relay feedback.
+ *
+ * The heater is switched between two power levels whenever the temperature crosses a small band around the set point.
+ * This makes the temperature oscillate at the plant's ultimate period, with an amplitude that gives the ultimate gain.
+ * Once enough stable cycles have been measured, the gains are calculated with the selected tuning rule and passed to
+ * the PID Controller.
+*/
+class AutoTuner
+{
+public:
+	/**
+	 * @brief  The rules that can be used to turn the ultimate gain and period into PID gains.
+	*/
+	enum TuningRules
+	{
+		ZieglerNicholsPI,
+		ZieglerNicholsPID,
+		TyreusLuybenPI,
+		TyreusLuybenPID
+	};
+
+	/**
+	 * @brief  The states the Auto Tuner can be in.
+	*/
+	enum AutoTunerStates
+	{
+		Idle,
+		WaitingForFirstCrossing,
+		MeasuringOscillations,
+		Complete,
+		Failed
+	};
+
+	static void Init(TuningRules Rule);
+	static void Start(float TemperatureSetPointDegCent, float OutputMaxValue);
+	static void Stop();
+	static void Update();
+	static AutoTunerStates GetState();
+	static float GetHeaterPowerLevel();
+	static bool GetNewlyTunedSettings(std::array<PIDFloatDataPacket, 3>* TunedSettings);
+	static bool IsActive();
+	static void SetOutputLimitPercent(float LimitPercent);
+	static void SetCurrentTemperature(float CurrentTemperature);
+
+private:
+	struct pidGains
+	{
+		float ProportionalGain;
+		float IntegralGain;
+		float DerivativeGain;
+	};
+
+	static bool debug_Start;
+	static bool debug_SetCurrentTemperature;
+	static bool debug_calculateGains;
+
+	static bool isRelayOutputHigh;
+	static bool newlyTunedGainsAreAvailable;
+	static uint8_t oscillationsCompleted;
+	static uint32_t relayHighReadingCount;
+	static uint32_t millisValueAtStart;
+	static uint32_t millisValueAtLastHighToLowSwitch;
+	static float temperatureSetPointDegCent;
+	static float outputMaxValue;
+	static float outputLimitPercent;
+	static float relayHighOutputSum;
+	static float highestTemperatureThisCycle;
+	static float lowestTemperatureThisCycle;
+	static float oscillationPeriodSumMs;
+	static float oscillationAmplitudeSum;
+	static pidGains tunedGains;
+	static TuningRules tuningRule;
+	static AutoTunerStates currentState;
+
+	static void switchRelayOutput(bool ShouldBeHigh);
+	static float getRelayHighOutputPercent();
+	static void recordOscillation(uint32_t MillisValueNow);
+	static void finish();
+	static pidGains calculateGains(TuningRules Rule, float UltimateGain, float UltimatePeriodMinutes);
+	static std::array<PIDFloatDataPacket, 3> getTunedSettings();
+	static void fail(const char* Reason);
+	static void endTuningRun(AutoTunerStates FinalState);
+
+	static void enableDebugTriggers();
+};
+
+#endif //ENGINEERING_PROJECT_AUTO_TUNER_H
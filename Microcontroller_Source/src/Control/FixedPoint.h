@@ -0,0 +1,164 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_FIXED_POINT_H
+#define ENGINEERING_PROJECT_FIXED_POINT_H
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief  A signed number stored in a 32-bit integer, with a fixed number of bits after the binary point.
+ *
+ * The ESP32-C3 doesn't have an FPU, so every float operation gets emulated in software. This type only uses the integer
+ * multiplier, which makes arithmetic on it a lot cheaper than on a float.
+ *
+ * With 16 fractional bits (Q16.16), values between -32768 and 32767.99998 can be stored with a resolution of 0.0000153.
+ * Results that don't fit into that range are saturated instead of being allowed to wrap around.
+*/
+template <uint8_t FractionalBits>
+class FixedPoint
+{
+	static_assert((FractionalBits > 0) && (FractionalBits < 31), "FixedPoint needs between 1 and 30 fractional bits.");
+
+public:
+	constexpr FixedPoint() : raw(0)
+	{}
+
+	constexpr FixedPoint(const float Value) : raw(convertFromFloat(Value))
+	{}
+
+	static constexpr FixedPoint FromRaw(const int32_t RawValue)
+	{
+		FixedPoint result;
+		result.raw = RawValue;
+		return result;
+	}
+
+	constexpr int32_t GetRaw() const
+	{
+		return raw;
+	}
+
+	explicit constexpr operator float() const
+	{
+		return static_cast<float>(raw) / static_cast<float>(oneAsRaw);
+	}
+
+	constexpr FixedPoint operator-() const
+	{
+		return FromRaw(saturate(-static_cast<int64_t>(raw)));
+	}
+
+	constexpr FixedPoint operator+(const FixedPoint Other) const
+	{
+		return FromRaw(saturate(static_cast<int64_t>(raw) + Other.raw));
+	}
+
+	constexpr FixedPoint operator-(const FixedPoint Other) const
+	{
+		return FromRaw(saturate(static_cast<int64_t>(raw) - Other.raw));
+	}
+
+	constexpr FixedPoint operator*(const FixedPoint Other) const
+	{
+		// Round to nearest rather than truncating, so that repeated multiplications don't drift towards negative infinity.
+		return FromRaw(saturate((static_cast<int64_t>(raw) * Other.raw + (oneAsRaw / 2)) >> FractionalBits));
+	}
+
+	constexpr FixedPoint operator/(const FixedPoint Other) const
+	{
+		if (Other.raw == 0)
+		{
+			return FromRaw((raw < 0) ? std::numeric_limits<int32_t>::min() : std::numeric_limits<int32_t>::max());
+		}
+
+		return FromRaw(saturate(static_cast<int64_t>(raw) * oneAsRaw / Other.raw));
+	}
+
+	FixedPoint& operator+=(const FixedPoint Other)
+	{
+		*this = *this + Other;
+		return *this;
+	}
+
+	FixedPoint& operator-=(const FixedPoint Other)
+	{
+		*this = *this - Other;
+		return *this;
+	}
+
+	constexpr bool operator<(const FixedPoint Other) const
+	{
+		return raw < Other.raw;
+	}
+
+	constexpr bool operator>(const FixedPoint Other) const
+	{
+		return raw > Other.raw;
+	}
+
+	constexpr bool operator<=(const FixedPoint Other) const
+	{
+		return raw <= Other.raw;
+	}
+
+	constexpr bool operator>=(const FixedPoint Other) const
+	{
+		return raw >= Other.raw;
+	}
+
+	constexpr bool operator==(const FixedPoint Other) const
+	{
+		return raw == Other.raw;
+	}
+
+	constexpr bool operator!=(const FixedPoint Other) const
+	{
+		return raw != Other.raw;
+	}
+
+
+private:
+	static constexpr int64_t oneAsRaw = static_cast<int64_t>(1) << FractionalBits;
+
+	int32_t raw;
+
+	static constexpr int32_t saturate(const int64_t Value)
+	{
+		if (Value > std::numeric_limits<int32_t>::max())
+		{
+			return std::numeric_limits<int32_t>::max();
+		}
+		if (Value < std::numeric_limits<int32_t>::min())
+		{
+			return std::numeric_limits<int32_t>::min();
+		}
+
+		return static_cast<int32_t>(Value);
+	}
+
+	static constexpr int32_t convertFromFloat(const float Value)
+	{
+		const float scaledValue = Value * static_cast<float>(oneAsRaw);
+		if (scaledValue >= static_cast<float>(std::numeric_limits<int32_t>::max()))
+		{
+			return std::numeric_limits<int32_t>::max();
+		}
+		if (scaledValue <= static_cast<float>(std::numeric_limits<int32_t>::min()))
+		{
+			return std::numeric_limits<int32_t>::min();
+		}
+
+		return static_cast<int32_t>((scaledValue >= 0) ? (scaledValue + 0.5f) : (scaledValue - 0.5f));
+	}
+};
+
+#endif //ENGINEERING_PROJECT_FIXED_POINT_H
@@ -0,0 +1,199 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "GainScheduler.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+#define MINIMUM_BREAKPOINTS_FOR_SCHEDULE    2
+
+
+bool GainScheduler::debug_Init = false;
+bool GainScheduler::debug_Lookup = false;
+
+uint8_t GainScheduler::breakpointCount = 0;
+GainScheduleKeys GainScheduler::key = ScheduleOnSetPoint;
+std::array<PIDScalar, MAX_GAIN_SCHEDULE_BREAKPOINTS> GainScheduler::breakpointTemperatures = {};
+std::array<GainScheduler::ScheduledGains, MAX_GAIN_SCHEDULE_BREAKPOINTS> GainScheduler::breakpointGains = {};
+std::array<GainScheduler::ScheduledGains, MAX_GAIN_SCHEDULE_BREAKPOINTS> GainScheduler::gainSlopesPerDegCent = {};
+
+
+/**
+ * @brief             Loads a gain schedule.
+ *
+ * @param  InputData  A struct containing the schedule. Fewer than two breakpoints leaves scheduling switched off.
+ *
+ * @note              If the breakpoints aren't in strictly ascending order of temperature, the schedule is rejected and
+ *                    scheduling is switched off.
+*/
+void GainScheduler::Init(const GainScheduleInitData& InputData)
+{
+	enableDebugTriggers();
+
+	key = InputData.Key;
+	breakpointCount = 0;
+
+	const uint8_t newBreakpointCount = (InputData.BreakpointCount > MAX_GAIN_SCHEDULE_BREAKPOINTS) ?
+		MAX_GAIN_SCHEDULE_BREAKPOINTS :
+		InputData.BreakpointCount;
+	if (newBreakpointCount < MINIMUM_BREAKPOINTS_FOR_SCHEDULE)
+	{
+		SerialHandler::SafeWriteLn("Gain scheduling is off.", debug_Init);
+		return;
+	}
+
+	for (uint8_t i = 1; i < newBreakpointCount; ++i)
+	{
+		if (InputData.Breakpoints[i].TemperatureDegCent <= InputData.Breakpoints[i - 1].TemperatureDegCent)
+		{
+			SerialHandler::SafeWriteLn("Gain schedule breakpoints are not in ascending order. Gain scheduling is off.", true);
+			return;
+		}
+	}
+
+	for (uint8_t i = 0; i < newBreakpointCount; ++i)
+	{
+		const GainScheduleBreakpoint& breakpoint = InputData.Breakpoints[i];
+		breakpointTemperatures[i] = PIDScalar(breakpoint.TemperatureDegCent);
+		breakpointGains[i] = {PIDScalar(breakpoint.ProportionalGain), PIDScalar(breakpoint.IntegralGain), PIDScalar(breakpoint.DerivativeGain)};
+
+		// The last breakpoint has no segment after it, so its slopes are never used.
+		if (i == (newBreakpointCount - 1))
+		{
+			gainSlopesPerDegCent[i] = {};
+			continue;
+		}
+
+		const GainScheduleBreakpoint& nextBreakpoint = InputData.Breakpoints[i + 1];
+		const float segmentWidthDegCent = nextBreakpoint.TemperatureDegCent - breakpoint.TemperatureDegCent;
+		gainSlopesPerDegCent[i] = {
+				PIDScalar((nextBreakpoint.ProportionalGain - breakpoint.ProportionalGain) / segmentWidthDegCent),
+				PIDScalar((nextBreakpoint.IntegralGain - breakpoint.IntegralGain) / segmentWidthDegCent),
+				PIDScalar((nextBreakpoint.DerivativeGain - breakpoint.DerivativeGain) / segmentWidthDegCent)
+		};
+	}
+
+	breakpointCount = newBreakpointCount;
+
+	if (debug_Init)
+	{
+		std::string scheduleMsg = Utils::StringFormat("Gain schedule loaded with %u breakpoints from %0.1f°C to %0.1f°C, keyed on the %s",
+		                                              breakpointCount, static_cast<float>(breakpointTemperatures[0]),
+		                                              static_cast<float>(breakpointTemperatures[breakpointCount - 1]),
+		                                              (key == ScheduleOnSetPoint) ? "set point" : "measured temperature");
+		SerialHandler::SafeWriteLn(scheduleMsg, true);
+	}
+}
+
+/**
+ * @brief   Gets which temperature the schedule should be looked up with.
+ *
+ * @return  The schedule's key.
+*/
+GainScheduleKeys GainScheduler::GetKey()
+{
+	return key;
+}
+
+/**
+ * @brief   Checks if a gain schedule has been loaded.
+ *
+ * @return  True if the PID Controller should take its gains from the schedule. False otherwise.
+*/
+bool GainScheduler::IsActive()
+{
+	return (breakpointCount >= MINIMUM_BREAKPOINTS_FOR_SCHEDULE);
+}
+
+/**
+ * @brief                      Gets the gains to use at a given temperature.
+ *
+ * @param  TemperatureDegCent  The set point or measured temperature, depending on the schedule's key.
+ *
+ * @return                     The gains interpolated from the neighbouring breakpoints.
+ *
+ * @note                       Must only be called while the schedule is active.
+*/
+GainScheduler::ScheduledGains GainScheduler::Lookup(const PIDScalar TemperatureDegCent)
+{
+	if (TemperatureDegCent <= breakpointTemperatures[0])
+	{
+		return breakpointGains[0];
+	}
+
+	const uint8_t lastBreakpoint = breakpointCount - 1;
+	if (TemperatureDegCent >= breakpointTemperatures[lastBreakpoint])
+	{
+		return breakpointGains[lastBreakpoint];
+	}
+
+	const uint8_t segment = findSegment(TemperatureDegCent);
+	const PIDScalar distanceIntoSegment = TemperatureDegCent - breakpointTemperatures[segment];
+	const ScheduledGains& segmentStart = breakpointGains[segment];
+	const ScheduledGains& slopes = gainSlopesPerDegCent[segment];
+
+	const ScheduledGains gains = {
+			segmentStart.ProportionalGain + (slopes.ProportionalGain * distanceIntoSegment),
+			segmentStart.IntegralGain + (slopes.IntegralGain * distanceIntoSegment),
+			segmentStart.DerivativeGain + (slopes.DerivativeGain * distanceIntoSegment)
+	};
+
+	if (debug_Lookup)
+	{
+		std::string lookupMsg = Utils::StringFormat("Scheduled gains at %0.2f°C (segment %u): P %0.3f, I %0.3f, D %0.3f",
+		                                            static_cast<float>(TemperatureDegCent), segment,
+		                                            static_cast<float>(gains.ProportionalGain), static_cast<float>(gains.IntegralGain),
+		                                            static_cast<float>(gains.DerivativeGain));
+		SerialHandler::SafeWriteLn(lookupMsg, true);
+	}
+
+	return gains;
+}
+
+/**
+ * @brief                      Finds the segment of the table that a temperature falls in, with a binary search.
+ *
+ * @param  TemperatureDegCent  A temperature between the first and last breakpoints.
+ *
+ * @return                     The index of the breakpoint at the start of the segment.
+*/
+uint8_t GainScheduler::findSegment(const PIDScalar TemperatureDegCent)
+{
+	uint8_t lowerBreakpoint = 0;
+	uint8_t upperBreakpoint = breakpointCount - 1;
+
+	while ((upperBreakpoint - lowerBreakpoint) > 1)
+	{
+		const uint8_t middleBreakpoint = (lowerBreakpoint + upperBreakpoint) / 2;
+		if (TemperatureDegCent < breakpointTemperatures[middleBreakpoint])
+		{
+			upperBreakpoint = middleBreakpoint;
+		}
+		else
+		{
+			lowerBreakpoint = middleBreakpoint;
+		}
+	}
+
+	return lowerBreakpoint;
+}
+
+/**
+ * @brief  Used to instruct given functions to use their debug code.
+ *
+ * @note   Uncomment the booleans that represent the functions you want to debug.
+*/
+void GainScheduler::enableDebugTriggers()
+{
+//	debug_Init = true;
+//	debug_Lookup = true;
+}
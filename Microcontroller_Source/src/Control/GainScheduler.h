@@ -0,0 +1,62 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_GAIN_SCHEDULER_H
+#define ENGINEERING_PROJECT_GAIN_SCHEDULER_H
+
+#include <array>
+#include <cstdint>
+
+#include "Control/PIDScalar.h"
+#include "InitDataTypes/GainScheduleData.h"
+
+/**
+ * @brief  Holds a table of PID gains against temperature, and interpolates between its breakpoints.
+ *
+ * The slope of each gain between neighbouring breakpoints is worked out when the schedule is loaded, so a lookup is a
+ * binary search, one subtraction and three multiply-adds, with no divisions or allocations. Temperatures outside the
+ * table use the gains of the nearest breakpoint.
+ *
+ * While a schedule is active, the PID Controller takes its gains from it on every loop, overriding any gains set from
+ * the display or by the Auto Tuner.
+*/
+class GainScheduler
+{
+public:
+	/**
+	 * @brief  The gains looked up from the schedule.
+	*/
+	struct ScheduledGains
+	{
+		PIDScalar ProportionalGain;
+		PIDScalar IntegralGain;
+		PIDScalar DerivativeGain;
+	};
+
+	static void Init(const GainScheduleInitData& InputData);
+	static GainScheduleKeys GetKey();
+	static bool IsActive();
+	static ScheduledGains Lookup(PIDScalar TemperatureDegCent);
+
+private:
+	static bool debug_Init;
+	static bool debug_Lookup;
+
+	static uint8_t breakpointCount;
+	static GainScheduleKeys key;
+	static std::array<PIDScalar, MAX_GAIN_SCHEDULE_BREAKPOINTS> breakpointTemperatures;
+	static std::array<ScheduledGains, MAX_GAIN_SCHEDULE_BREAKPOINTS> breakpointGains;
+	static std::array<ScheduledGains, MAX_GAIN_SCHEDULE_BREAKPOINTS> gainSlopesPerDegCent;
+
+	static uint8_t findSegment(PIDScalar TemperatureDegCent);
+	static void enableDebugTriggers();
+};
+
+#endif //ENGINEERING_PROJECT_GAIN_SCHEDULER_H
@@ -0,0 +1,375 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "MultiZonePIDController.h"
+
+#include <Arduino.h>
+
+
+#define MAX_TEMPERATURE_SET_POINT   40.0f
+#define MIN_TEMPERATURE_SET_POINT   (-20.0f)
+#define ERROR_RANGE                 0.1f
+#define TIME_UNTIL_TEMP_ERROR_LOCKOUT_MS    (30 * 1000)
+#define MINIMUM_ACTIVE_GAIN         0.0001
+
+
+const PIDScalar zero = PIDScalar(0.0f);
+const PIDScalar errorRange = PIDScalar(ERROR_RANGE);
+const PIDScalar minimumActiveGain = PIDScalar(MINIMUM_ACTIVE_GAIN);
+
+
+/**
+ * @brief                  Initialises the Controller, with every zone disabled and locked out.
+ *
+ * @param  ZoneCount       The number of zones to run. Values above MAX_PID_ZONES are limited to it.
+ * @param  LoopTimeStepMs  The time between loops, in milliseconds. Shared by all zones.
+*/
+void MultiZonePIDController::Init(const uint8_t ZoneCount, const int32_t LoopTimeStepMs)
+{
+	zoneCount = (ZoneCount > MAX_PID_ZONES) ? MAX_PID_ZONES : ZoneCount;
+	loopTimeStepMs = LoopTimeStepMs;
+	loopTimeStepMinutes = static_cast<float>(loopTimeStepMs) / 1000 / 60;
+	millisValueAtEndOfLastLoop = getMillis();
+
+	for (uint8_t zone = 0; zone < MAX_PID_ZONES; ++zone)
+	{
+		isZoneEnabled[zone] = false;
+		isTemperatureErrorLockoutActive[zone] = true;     // Locked out until the zone's first temp reading arrives.
+		hasCurrentTemperatureBeenUpdatedSinceLastLoop[zone] = false;
+		currentDutyCyclePercent[zone] = 0.0;
+		engineState[zone] = {};
+		engineVariant[zone] = PidEngineDispatcher<PIDScalar>::GetVariant(false, false, false);
+	}
+	groupZonesByVariant();
+}
+
+/**
+ * @brief            Provides a zone with its settings.
+ *
+ * @param  Zone      The zone to configure.
+ * @param  ZoneData  A struct containing the zone's settings. Its LoopTimeStepMs is ignored, as all zones share the one given to Init.
+*/
+void MultiZonePIDController::ConfigureZone(const uint8_t Zone, const PIDControllerInitData ZoneData)
+{
+	if (Zone >= zoneCount)
+	{
+		return;
+	}
+
+	currentTemperatureSetPointDegCent[Zone] = PIDScalar(ZoneData.TemperatureSetPointDegCent);
+	engineSettings[Zone].ProportionalGain = PIDScalar(ZoneData.ProportionalGain);
+	integralGain[Zone] = ZoneData.IntegralGain;
+	engineSettings[Zone].IntegralWindupLimitMax = PIDScalar(ZoneData.IntegralWindupLimitMax);
+	engineSettings[Zone].IntegralWindupLimitMin = PIDScalar(ZoneData.IntegralWindupLimitMin);
+	derivativeGain[Zone] = ZoneData.DerivativeGain;
+	engineSettings[Zone].DerivativeTermMaxValue = PIDScalar(ZoneData.DerivativeTermMaxValue);
+	engineSettings[Zone].DerivativeTermMinValue = PIDScalar(ZoneData.DerivativeTermMinValue);
+	outputMaxValue[Zone] = PIDScalar(ZoneData.OutputMaxValue);
+	recalculateDerivedSettings(Zone);
+
+	engineState[Zone].PreviousError = currentTemperatureSetPointDegCent[Zone] - currentTemperatureReadingDegCent[Zone];
+}
+
+/**
+ * @brief    Runs a loop for every zone that has a new temperature reading, if enough time has passed since the last loop.
+ *
+ * @returns  True if a loop was run. False otherwise.
+*/
+bool MultiZonePIDController::Update()
+{
+	const uint32_t millisValueNow = getMillis();
+	if ((millisValueNow - millisValueAtEndOfLastLoop) < static_cast<uint32_t>(loopTimeStepMs))
+	{
+		return false;
+	}
+
+	markZonesReadyForThisLoop(millisValueNow);
+	calculateErrors();
+	calculateOutputs();
+	convertOutputsToDutyCycles();
+
+	millisValueAtEndOfLastLoop = millisValueNow;
+	return true;
+}
+
+/**
+ * @brief        Tells a zone that there was a fault in its temperature measurement.
+ *
+ * @param  Zone  The zone with the fault.
+*/
+void MultiZonePIDController::ActivateTemperatureLockout(const uint8_t Zone)
+{
+	if (Zone >= zoneCount)
+	{
+		return;
+	}
+
+	isTemperatureErrorLockoutActive[Zone] = true;
+}
+
+/**
+ * @brief                       Increase or decrease a zone's temperature set point.
+ *
+ * @param  Zone                 The zone to change.
+ * @param  ChangeAmountDegCent  How much the set point should be changed.
+ *
+ * @return                      The zone's new temperature set point.
+*/
+float MultiZonePIDController::ChangeTemperatureSetPoint(const uint8_t Zone, const float ChangeAmountDegCent)
+{
+	if (Zone >= zoneCount)
+	{
+		return 0.0;
+	}
+
+	float newSetPoint = static_cast<float>(currentTemperatureSetPointDegCent[Zone]) + ChangeAmountDegCent;
+	if (newSetPoint > MAX_TEMPERATURE_SET_POINT)
+	{
+		newSetPoint = MAX_TEMPERATURE_SET_POINT;
+	}
+	else if (newSetPoint < MIN_TEMPERATURE_SET_POINT)
+	{
+		newSetPoint = MIN_TEMPERATURE_SET_POINT;
+	}
+
+	currentTemperatureSetPointDegCent[Zone] = PIDScalar(newSetPoint);
+	return newSetPoint;
+}
+
+/**
+ * @brief        Gets the duty cycle currently calculated for a zone.
+ *
+ * @param  Zone  The zone to get the duty cycle of.
+ *
+ * @return       The zone's current duty cycle as a percentage.
+*/
+float MultiZonePIDController::GetCurrentDutyCyclePercent(const uint8_t Zone) const
+{
+	if (Zone >= zoneCount)
+	{
+		return 0.0;
+	}
+
+	return currentDutyCyclePercent[Zone];
+}
+
+/**
+ * @brief   Gets the number of zones being run.
+ *
+ * @return  The number of zones.
+*/
+uint8_t MultiZonePIDController::GetZoneCount() const
+{
+	return zoneCount;
+}
+
+/**
+ * @brief                      Provides a zone with a new temperature reading.
+ *
+ * @param  Zone                The zone the reading is for.
+ * @param  CurrentTemperature  The new temperature reading in °C.
+*/
+void MultiZonePIDController::SetCurrentTemperature(const uint8_t Zone, const float CurrentTemperature)
+{
+	if (Zone >= zoneCount)
+	{
+		return;
+	}
+
+	isTemperatureErrorLockoutActive[Zone] = false;
+	hasCurrentTemperatureBeenUpdatedSinceLastLoop[Zone] = true;
+	currentTemperatureReadingDegCent[Zone] = PIDScalar(CurrentTemperature);
+	millisValueAtLastTempReading[Zone] = getMillis();
+}
+
+/**
+ * @brief                  Tells a zone whether or not to pause its loop.
+ *
+ * @param  Zone            The zone to change.
+ * @param  ShouldActivate  True if the zone's loop should be active. False if it should be paused.
+*/
+void MultiZonePIDController::SetZoneIsEnabled(const uint8_t Zone, const bool ShouldActivate)
+{
+	if ((Zone >= zoneCount) || (ShouldActivate == isZoneEnabled[Zone]))
+	{
+		return;
+	}
+
+	engineState[Zone].PreviousError = currentTemperatureSetPointDegCent[Zone] - currentTemperatureReadingDegCent[Zone];
+	isZoneEnabled[Zone] = ShouldActivate;
+}
+
+/**
+ * @brief                  Changes where the Controller gets the current time from.
+ *
+ * @param  MillisFunction  A function that returns the number of milliseconds elapsed, like millis() does.
+ *                         Pass nullptr to go back to using the microcontroller's clock.
+*/
+void MultiZonePIDController::SetTimeSource(uint32_t (*MillisFunction)())
+{
+	getMillis = (MillisFunction != nullptr) ? MillisFunction : hardwareMillis;
+}
+
+/**
+ * @brief   Gets the time from the microcontroller's clock.
+ *
+ * @return  The number of milliseconds that have elapsed since the microcontroller booted up.
+*/
+uint32_t MultiZonePIDController::hardwareMillis()
+{
+	return millis();
+}
+
+/**
+ * @brief                  Works out which zones will run this loop. Zones that are paused or locked out have their output zeroed.
+ *
+ * @param  MillisValueNow  The current time in milliseconds.
+*/
+void MultiZonePIDController::markZonesReadyForThisLoop(const uint32_t MillisValueNow)
+{
+	for (uint8_t zone = 0; zone < zoneCount; ++zone)
+	{
+		if (isZoneEnabled[zone] && ((MillisValueNow - millisValueAtLastTempReading[zone]) >= TIME_UNTIL_TEMP_ERROR_LOCKOUT_MS))
+		{
+			isTemperatureErrorLockoutActive[zone] = true;
+		}
+
+		const bool isZoneStopped = !isZoneEnabled[zone] || isTemperatureErrorLockoutActive[zone];
+		if (isZoneStopped)
+		{
+			currentDutyCyclePercent[zone] = 0.0;
+			engineState[zone].IntegralAccumulator = zero;
+		}
+
+		// Zones without a new reading keep their previous output until one arrives.
+		isZoneRunningThisLoop[zone] = !isZoneStopped && hasCurrentTemperatureBeenUpdatedSinceLastLoop[zone];
+		hasCurrentTemperatureBeenUpdatedSinceLastLoop[zone] &= !isZoneRunningThisLoop[zone];
+	}
+}
+
+/**
+ * @brief  Calculates the error of every zone, with errors inside the dead band treated as zero.
+*/
+void MultiZonePIDController::calculateErrors()
+{
+	for (uint8_t zone = 0; zone < zoneCount; ++zone)
+	{
+		const PIDScalar zoneError = currentTemperatureSetPointDegCent[zone] - currentTemperatureReadingDegCent[zone];
+		error[zone] = ((zoneError < errorRange) && (zoneError > -errorRange)) ? zero : zoneError;
+	}
+}
+
+/**
+ * @brief  Runs the PID Engine of every running zone, and adds its terms up into the zone's output. Done as one pass per
+ *         PID Engine variant, so that no zone's terms are calculated through a function pointer.
+*/
+void MultiZonePIDController::calculateOutputs()
+{
+	calculateOutputsOfVariant<false, false, false>();
+	calculateOutputsOfVariant<false, false, true>();
+	calculateOutputsOfVariant<false, true, false>();
+	calculateOutputsOfVariant<false, true, true>();
+	calculateOutputsOfVariant<true, false, false>();
+	calculateOutputsOfVariant<true, false, true>();
+	calculateOutputsOfVariant<true, true, false>();
+	calculateOutputsOfVariant<true, true, true>();
+}
+
+/**
+ * @brief  Runs one PID Engine variant for every running zone that uses it, and adds its terms up into the zone's output.
+*/
+template <bool HasP, bool HasI, bool HasD>
+void MultiZonePIDController::calculateOutputsOfVariant()
+{
+	constexpr uint8_t variant = PidEngineDispatcher<PIDScalar>::GetVariant(HasP, HasI, HasD);
+	for (uint8_t i = firstGroupedZoneOfVariant[variant]; i < firstGroupedZoneOfVariant[variant + 1]; ++i)
+	{
+		const uint8_t zone = zonesGroupedByVariant[i];
+		if (!isZoneRunningThisLoop[zone])
+		{
+			continue;
+		}
+
+		const PidEngineTerms<PIDScalar> terms = PidEngine<HasP, HasI, HasD, PIDScalar>::Calculate(error[zone], engineSettings[zone], engineState[zone]);
+		output[zone] = terms.ProportionalTerm + engineState[zone].IntegralAccumulator + terms.DerivativeTerm;
+	}
+}
+
+/**
+ * @brief  Converts the output of every running zone into a duty cycle percentage.
+*/
+void MultiZonePIDController::convertOutputsToDutyCycles()
+{
+	for (uint8_t zone = 0; zone < zoneCount; ++zone)
+	{
+		if (!isZoneRunningThisLoop[zone])
+		{
+			continue;
+		}
+
+		if (output[zone] <= zero)
+		{
+			currentDutyCyclePercent[zone] = 0.0;
+		}
+		else if (output[zone] >= outputMaxValue[zone])
+		{
+			currentDutyCyclePercent[zone] = 100.0;
+		}
+		else
+		{
+			currentDutyCyclePercent[zone] = static_cast<float>(output[zone] * outputToDutyCyclePercentFactor[zone]);
+		}
+	}
+}
+
+/**
+ * @brief        Recalculates the values that are derived from a zone's settings, so that the loop itself doesn't need to.
+ *               This includes picking the PID Engine variant that only contains the terms whose gains are in use.
+ *
+ * @param  Zone  The zone whose settings changed.
+*/
+void MultiZonePIDController::recalculateDerivedSettings(const uint8_t Zone)
+{
+	engineSettings[Zone].IntegralGainTimesLoopTimeStep = PIDScalar(integralGain[Zone] * loopTimeStepMinutes);
+	engineSettings[Zone].DerivativeGainDividedByLoopTimeStep = PIDScalar(derivativeGain[Zone] / loopTimeStepMinutes);
+
+	const float outputMax = static_cast<float>(outputMaxValue[Zone]);
+	outputToDutyCyclePercentFactor[Zone] = (outputMax > 0) ? PIDScalar(100.0f / outputMax) : zero;
+
+	engineVariant[Zone] = PidEngineDispatcher<PIDScalar>::GetVariant(
+			engineSettings[Zone].ProportionalGain >= minimumActiveGain,
+			PIDScalar(integralGain[Zone]) >= minimumActiveGain,
+			PIDScalar(derivativeGain[Zone]) >= minimumActiveGain
+	);
+	groupZonesByVariant();
+}
+
+/**
+ * @brief  Lists the zones in order of the PID Engine variant they use, and notes where each variant's zones start, so
+ *         that each variant's pass only visits its own zones.
+*/
+void MultiZonePIDController::groupZonesByVariant()
+{
+	uint8_t groupedZones = 0;
+	for (uint8_t variant = 0; variant < PidEngineDispatcher<PIDScalar>::VariantCount; ++variant)
+	{
+		firstGroupedZoneOfVariant[variant] = groupedZones;
+		for (uint8_t zone = 0; zone < zoneCount; ++zone)
+		{
+			if (engineVariant[zone] == variant)
+			{
+				zonesGroupedByVariant[groupedZones] = zone;
+				groupedZones++;
+			}
+		}
+	}
+	firstGroupedZoneOfVariant[PidEngineDispatcher<PIDScalar>::VariantCount] = groupedZones;
+}
@@ -0,0 +1,95 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_MULTI_ZONE_PID_CONTROLLER_H
+#define ENGINEERING_PROJECT_MULTI_ZONE_PID_CONTROLLER_H
+
+#include <array>
+#include <cstdint>
+
+#include "Control/PidEngine.h"
+#include "Control/PIDScalar.h"
+#include "InitDataTypes/PIDControllerData.h"
+
+// The most zones a single Multi-Zone PID Controller can run. Can be overridden with -DMAX_PID_ZONES=<n>.
+#ifndef MAX_PID_ZONES
+#define MAX_PID_ZONES 8
+#endif
+
+/**
+ * @brief  Runs a PID loop for each of several heating zones, all sharing one loop time step.
+ *
+ * Unlike the PID Controller class, this class is instantiable, and the state of every zone is stored as one array per
+ * value rather than one struct per zone. Each loop is done as a series of passes over all zones (error, then the PID
+ * terms, then the output), which keeps each pass's loop tight and the per-zone cost flat as zones are added.
+ * Each zone has its own set point, gains, limits and temperature lockout. The terms are worked out by the same PID
+ * Engine as the PID Controller's, with each zone running the variant that only contains the terms its gains use. The
+ * PID terms pass is split up by variant, with the zones kept grouped by the variant they use, so each variant's Calculate
+ * is called directly and inlined rather than through a function pointer per zone.
+*/
+class MultiZonePIDController
+{
+public:
+	void Init(uint8_t ZoneCount, int32_t LoopTimeStepMs);
+	void ConfigureZone(uint8_t Zone, PIDControllerInitData ZoneData);
+	bool Update();
+	void ActivateTemperatureLockout(uint8_t Zone);
+	float ChangeTemperatureSetPoint(uint8_t Zone, float ChangeAmountDegCent);
+	float GetCurrentDutyCyclePercent(uint8_t Zone) const;
+	uint8_t GetZoneCount() const;
+	void SetCurrentTemperature(uint8_t Zone, float CurrentTemperature);
+	void SetZoneIsEnabled(uint8_t Zone, bool ShouldActivate);
+	void SetTimeSource(uint32_t (*MillisFunction)());
+
+private:
+	template <typename T>
+	using zoneArray = std::array<T, MAX_PID_ZONES>;
+
+	uint8_t zoneCount = 0;
+	int32_t loopTimeStepMs = 0;
+	float loopTimeStepMinutes = 0.0;
+	uint32_t millisValueAtEndOfLastLoop = 0;
+	uint32_t (*getMillis)() = hardwareMillis;
+
+	// Per-zone state.
+	zoneArray<bool> isZoneEnabled = {};
+	zoneArray<bool> isTemperatureErrorLockoutActive = {};
+	zoneArray<bool> hasCurrentTemperatureBeenUpdatedSinceLastLoop = {};
+	zoneArray<bool> isZoneRunningThisLoop = {};
+	zoneArray<uint32_t> millisValueAtLastTempReading = {};
+	zoneArray<float> currentDutyCyclePercent = {};
+	zoneArray<PIDScalar> currentTemperatureReadingDegCent = {};
+	zoneArray<PIDScalar> currentTemperatureSetPointDegCent = {};
+	zoneArray<PIDScalar> error = {};
+	zoneArray<PIDScalar> output = {};
+	zoneArray<PidEngineState<PIDScalar>> engineState = {};
+
+	// Per-zone settings, with the gains already combined with the loop time step.
+	zoneArray<float> integralGain = {};
+	zoneArray<float> derivativeGain = {};
+	zoneArray<PidEngineSettings<PIDScalar>> engineSettings = {};
+	zoneArray<uint8_t> engineVariant = {};
+	zoneArray<uint8_t> zonesGroupedByVariant = {};
+	std::array<uint8_t, PidEngineDispatcher<PIDScalar>::VariantCount + 1> firstGroupedZoneOfVariant = {};
+	zoneArray<PIDScalar> outputMaxValue = {};
+	zoneArray<PIDScalar> outputToDutyCyclePercentFactor = {};
+
+	static uint32_t hardwareMillis();
+	void markZonesReadyForThisLoop(uint32_t MillisValueNow);
+	void calculateErrors();
+	void calculateOutputs();
+	template <bool HasP, bool HasI, bool HasD>
+	void calculateOutputsOfVariant();
+	void convertOutputsToDutyCycles();
+	void recalculateDerivedSettings(uint8_t Zone);
+	void groupZonesByVariant();
+};
+
+#endif //ENGINEERING_PROJECT_MULTI_ZONE_PID_CONTROLLER_H
@@ -10,53 +10,107 @@
 
 
 #include "PIDController.h"
+#include "Control/GainScheduler.h"
+#include "InitDataTypes/PIDSettingsSchema.h"
+#include "IO/Temperature.h"
 #include "Misc/SerialHandler.h"
 #include "Misc/Utils.h"
 
 #include <Arduino.h>
-#include <unordered_map>
+#include <array>
 
 
 #define MAX_TEMPERATURE_SET_POINT   40.0
 #define MIN_TEMPERATURE_SET_POINT   (-20.0)
 #define ERROR_RANGE                 0.1
 #define TIME_UNTIL_TEMP_ERROR_LOCKOUT_MS    (30 * 1000)
+#define MINIMUM_ACTIVE_GAIN         0.0001
+#define CPU_CYCLES_PER_MICROSECOND  160
+#define MAX_SAMPLE_INTERVAL_LOOP_TIME_STEPS 4     // Longer gaps between readings are treated as this long, so one late reading can't kick the Integral term.
+#define LOOP_TICK_TOLERANCE_MS      (TEMPERATURE_READING_INTERVAL_MS / 2)  // The reading nearest each tick is within this of it.
+
+// The fan speed at which the feedforward heat loss model reaches its full value. Heat is still lost with the fan stopped.
+#define FEEDFORWARD_FULL_SPEED_FAN_RPM              3000
+#define FEEDFORWARD_STILL_AIR_HEAT_LOSS_FRACTION    0.3f
+
+
+const PIDScalar zero = PIDScalar(0.0f);
+const PIDScalar errorRange = PIDScalar(ERROR_RANGE);
+const PIDScalar minimumActiveGain = PIDScalar(MINIMUM_ACTIVE_GAIN);
+const PIDScalar oneHundredPercent = PIDScalar(100.0f);
+
+/**
+ * @brief                       Checks that every setting in the schema has somewhere to be stored, of the right type.
+ *
+ * @param  FloatSettingStorage  Where each float setting is stored, indexed by the PIDSettings enum.
+ * @param  IntSettingStorage    Where each int setting is stored, indexed by the PIDSettings enum.
+ *
+ * @return                      True if the storage matches the schema. False otherwise.
+*/
+constexpr bool doesSettingStorageMatchSchema(
+		const std::array<PIDScalar*, PIDSettingsCount>& FloatSettingStorage, const std::array<int32_t*, PIDSettingsCount>& IntSettingStorage
+)
+{
+	for (const PIDSettingSchema& schema : pidSettingsSchema)
+	{
+		const bool isFloatSetting = (schema.Type == FloatSetting);
+		if (((FloatSettingStorage[schema.Setting] != nullptr) != isFloatSetting) || ((IntSettingStorage[schema.Setting] != nullptr) == isFloatSetting))
+		{
+			return false;
+		}
+	}
+	return true;
+}
 
 
 bool PIDController::debug_Update = false;
 bool PIDController::debug_SetControlLoopActiveStatus = false;
-bool PIDController::debug_ChangeFloatSettings = false;
-bool PIDController::debug_ChangeIntSettings = false;
+bool PIDController::debug_ChangeFloatSetting = false;
+bool PIDController::debug_ChangeIntSetting = false;
 bool PIDController::debug_outputGraph = false;
 bool PIDController::debug_updateLoopEarlyReturnChecks = false;
 bool PIDController::debug_pidCalculations = false;
 bool PIDController::debug_calculateProportionalTerm = false;
 bool PIDController::debug_calculateIntegralAccumulation = false;
 bool PIDController::debug_calculateDerivativeTerm = false;
+bool PIDController::debug_calculateFeedforwardTerm = false;
+bool PIDController::debug_applyScheduledGains = false;
+bool PIDController::debug_updateCycleCount = false;
+bool PIDController::debug_sampleToOutputLatency = false;
 
 bool PIDController::hasCurrentTemperatureBeenUpdatedSinceLastLoop = false;
+bool PIDController::hasPreviousLoopTempReading = false;
 bool PIDController::isControlLoopEnabled = false;
 bool PIDController::isTemperatureErrorLockoutActive = true;     // Initialise as locked out until first temp reading arrives.
 bool PIDController::newLoopHasRun = false;
 uint32_t PIDController::millisValueAtEndOfLastLoop = 0;
 uint32_t PIDController::millisValueAtLastTempReading = 0;
+uint32_t PIDController::millisValueAtPreviousLoopTempReading = 0;
+uint32_t PIDController::millisValueAtNextLoopTick = 0;
 float PIDController::currentDutyCyclePercent = 0.0;
-float PIDController::currentTemperatureReadingDegCent = 0.0;
-float PIDController::currentTemperatureSetPointDegCent = 0.0;
-float PIDController::integralAccumulator = 0.0;
-float PIDController::previousError = 0.0;
+float PIDController::outputLimitPercent = 100.0;
+PIDScalar PIDController::currentTemperatureReadingDegCent = zero;
+PIDScalar PIDController::currentTemperatureSetPointDegCent = zero;
+PidEngineState<PIDScalar> PIDController::engineState = {};
 std::array<float, 3> PIDController::mostRecentDerivativeTerms = {};
 
 int32_t PIDController::loopTimeStepMs;
 float PIDController::loopTimeStepMinutes;
-float PIDController::proportionalGain;
-float PIDController::integralGain;
-float PIDController::integralWindupLimitMax;
-float PIDController::integralWindupLimitMin;
-float PIDController::derivativeGain;
-float PIDController::derivativeTermMaxValue;
-float PIDController::derivativeTermMinValue;
-float PIDController::outputMaxValue;
+float PIDController::loopTimeStepMinutesReciprocal;
+float PIDController::loopTimeStepMsReciprocal;
+PIDScalar PIDController::integralGain;
+PIDScalar PIDController::derivativeGain;
+PIDScalar PIDController::outputMaxValue;
+PIDScalar PIDController::limitedOutputMaxValue;
+PIDScalar PIDController::feedforwardGain;
+PIDScalar PIDController::ambientTemperatureDegCent;
+PIDScalar PIDController::fanHeatLossFactor = PIDScalar(FEEDFORWARD_STILL_AIR_HEAT_LOSS_FRACTION);
+
+PidEngineSettings<PIDScalar> PIDController::engineSettings = {};
+PIDScalar PIDController::outputToDutyCyclePercentFactor;
+PidEngineDispatcher<PIDScalar>::CalculateFunction PIDController::calculatePidTerms = nullptr;
+
+uint32_t (*PIDController::getMillis)() = hardwareMillis;
 
 
 /**
@@ -66,25 +120,31 @@ float PIDController::outputMaxValue;
 */
 void PIDController::Init(PIDControllerInitData InputData)
 {
+	static_assert(doesSettingStorageMatchSchema(floatSettingStorage, intSettingStorage), "Every PID setting needs storage of its type.");
 	enableDebugTriggers();
 
-	currentTemperatureSetPointDegCent = InputData.TemperatureSetPointDegCent;
-	loopTimeStepMs = InputData.LoopTimeStepMs;
+	for (const PIDSettingSchema& schema : pidSettingsSchema)
+	{
+		if (schema.Type == FloatSetting)
+		{
+			*floatSettingStorage[schema.Setting] = PIDScalar(InputData.*schema.FloatInitData);
+		}
+		else
+		{
+			*intSettingStorage[schema.Setting] = InputData.*schema.IntInitData;
+		}
+	}
 	convertLoopTimeStepMsToMinutes();
-	proportionalGain = InputData.ProportionalGain;
-	integralGain = InputData.IntegralGain;
-	integralWindupLimitMax = InputData.IntegralWindupLimitMax;
-	integralWindupLimitMin = InputData.IntegralWindupLimitMin;
-	derivativeGain = InputData.DerivativeGain;
-	derivativeTermMaxValue = InputData.DerivativeTermMaxValue;
-	derivativeTermMinValue = InputData.DerivativeTermMinValue;
-	outputMaxValue = InputData.OutputMaxValue;
-
-	previousError = currentTemperatureSetPointDegCent - currentTemperatureReadingDegCent;
+	recalculateDerivedSettings();
+
+	engineState.PreviousError = currentTemperatureSetPointDegCent - currentTemperatureReadingDegCent;
 }
 
 /**
- * @brief  Updates the internal state of the PID Controller.
+ * @brief  Updates the internal state of the PID Controller. The loop runs on a grid of ticks one loop time step apart,
+ *         on the reading nearest each tick, which is the first one within LOOP_TICK_TOLERANCE_MS of it. Such a loop
+ *         uses the loop time step as it is. If no reading came within the tolerance, the loop runs on the next reading
+ *         instead, scaled to the real time since the previous loop's reading, and the grid restarts from that reading.
 */
 void PIDController::Update()
 {
@@ -93,32 +153,57 @@ void PIDController::Update()
 		return;
 	}
 
-	pidCalculations calculations = doPIDCalculations();
+	const uint32_t cycleCountAtStartOfCalculations = ESP.getCycleCount();
+
+	const uint32_t sampleIntervalMs = consumeSampleInterval();
+	pidCalculations calculations = doPIDCalculations(sampleIntervalMs);
+
+	// While the heater is being derated, the integral mustn't build up power the heater can't be given.
+	if ((outputLimitPercent < 100.0f) && (engineState.IntegralAccumulator > limitedOutputMaxValue))
+	{
+		engineState.IntegralAccumulator = limitedOutputMaxValue;
+	}
 
-	float output = calculations.ProportionalTerm + integralAccumulator + calculations.DerivativeTerm;
+	const PIDScalar output = calculations.ProportionalTerm + engineState.IntegralAccumulator + calculations.DerivativeTerm + calculateFeedforwardTerm();
 
 	if (debug_Update)
 	{
-		std::string desiredTemperatureMsg = Utils::StringFormat("PID loop done with calculated output: %0.2f", output);
+		std::string desiredTemperatureMsg = Utils::StringFormat("PID loop done with calculated output: %0.2f", static_cast<float>(output));
 		SerialHandler::SafeWriteLn(desiredTemperatureMsg, true);
 	}
 
-	if (output <= 0)
+	if (output <= zero)
 	{
 		currentDutyCyclePercent = 0.0;
 	}
-	else if (output >= outputMaxValue)
+	else if (output >= limitedOutputMaxValue)
 	{
-		currentDutyCyclePercent = 100.0;
+		currentDutyCyclePercent = outputLimitPercent;
 	}
 	else
 	{
-		currentDutyCyclePercent = output / outputMaxValue * 100.0f;
+		currentDutyCyclePercent = static_cast<float>(output * outputToDutyCyclePercentFactor);
+	}
+
+	if (debug_updateCycleCount)
+	{
+		const uint32_t cyclesTaken = ESP.getCycleCount() - cycleCountAtStartOfCalculations;
+		std::string cycleCountMsg = Utils::StringFormat("PID calculations took %u cycles (%0.2fus)",
+		                                                cyclesTaken, static_cast<float>(cyclesTaken) / CPU_CYCLES_PER_MICROSECOND);
+		SerialHandler::SafeWriteLn(cycleCountMsg, true);
+	}
+
+	if (debug_sampleToOutputLatency)
+	{
+		// Measured from when the Temperature class finished the reading's burst, so it includes any time spent waiting.
+		std::string latencyMsg = Utils::StringFormat("Sample to output latency: %ums, sample interval: %ums",
+		                                             getMillis() - millisValueAtLastTempReading, sampleIntervalMs);
+		SerialHandler::SafeWriteLn(latencyMsg, true);
 	}
 
 	outputGraph(calculations, output);
 
-	millisValueAtEndOfLastLoop = millis();
+	millisValueAtEndOfLastLoop = getMillis();
 	hasCurrentTemperatureBeenUpdatedSinceLastLoop = false;
 	newLoopHasRun = true;
 }
@@ -140,21 +225,21 @@ void PIDController::ActivateTemperatureLockout()
 */
 float PIDController::ChangeTemperatureSetPoint(float ChangeAmountDegCent)
 {
-	const float newTemperatureSetPointDegCent = currentTemperatureSetPointDegCent + ChangeAmountDegCent;
+	const float newTemperatureSetPointDegCent = static_cast<float>(currentTemperatureSetPointDegCent) + ChangeAmountDegCent;
 	if (newTemperatureSetPointDegCent >= MAX_TEMPERATURE_SET_POINT)
 	{
-		currentTemperatureSetPointDegCent = MAX_TEMPERATURE_SET_POINT;
+		currentTemperatureSetPointDegCent = PIDScalar(MAX_TEMPERATURE_SET_POINT);
 	}
 	else if (newTemperatureSetPointDegCent <= MIN_TEMPERATURE_SET_POINT)
 	{
-		currentTemperatureSetPointDegCent = MIN_TEMPERATURE_SET_POINT;
+		currentTemperatureSetPointDegCent = PIDScalar(MIN_TEMPERATURE_SET_POINT);
 	}
 	else
 	{
-		currentTemperatureSetPointDegCent = newTemperatureSetPointDegCent;
+		currentTemperatureSetPointDegCent = PIDScalar(newTemperatureSetPointDegCent);
 	}
 
-	return currentTemperatureSetPointDegCent;
+	return static_cast<float>(currentTemperatureSetPointDegCent);
 }
 
 /**
@@ -167,6 +252,16 @@ float PIDController::GetCurrentDutyCyclePercent()
 	return currentDutyCyclePercent;
 }
 
+/**
+ * @brief   Gets the Output Max setting the PID Controller is currently using.
+ *
+ * @return  The Output Max setting.
+*/
+float PIDController::GetOutputMaxValue()
+{
+	return static_cast<float>(outputMaxValue);
+}
+
 /**
  * @brief   Gets the temperature set point the PID Controller is currently using.
  *
@@ -174,7 +269,7 @@ float PIDController::GetCurrentDutyCyclePercent()
 */
 float PIDController::GetTemperatureSetPoint()
 {
-	return currentTemperatureSetPointDegCent;
+	return static_cast<float>(currentTemperatureSetPointDegCent);
 }
 
 /**
@@ -204,16 +299,28 @@ bool PIDController::IsLoopActive()
 }
 
 /**
- * @brief                      Provides the Controller with a new temperature reading.
+ * @brief                      Provides the Controller with a new temperature reading, which triggers the next loop.
  *
  * @param  CurrentTemperature  The new temperature reading in °C.
+ * @param  SampleMillisValue   The millis() value when the reading was taken.
 */
-void PIDController::SetCurrentTemperature(float CurrentTemperature)
+void PIDController::SetCurrentTemperature(float CurrentTemperature, const uint32_t SampleMillisValue)
 {
 	isTemperatureErrorLockoutActive = false;
 	hasCurrentTemperatureBeenUpdatedSinceLastLoop = true;
-	currentTemperatureReadingDegCent = CurrentTemperature;
-	millisValueAtLastTempReading = millis();
+	currentTemperatureReadingDegCent = PIDScalar(CurrentTemperature);
+	millisValueAtLastTempReading = SampleMillisValue;
+}
+
+/**
+ * @brief       Provides the Controller with the fan's latest speed, which is used by the feedforward heat loss model.
+ *
+ * @param  Rpm  The fan's speed in RPM. Should be 0 if the fan isn't spinning.
+*/
+void PIDController::SetCurrentFanRpm(const uint32_t Rpm)
+{
+	const float fanSpeedFraction = (Rpm >= FEEDFORWARD_FULL_SPEED_FAN_RPM) ? 1.0f : (static_cast<float>(Rpm) / FEEDFORWARD_FULL_SPEED_FAN_RPM);
+	fanHeatLossFactor = PIDScalar(FEEDFORWARD_STILL_AIR_HEAT_LOSS_FRACTION + ((1 - FEEDFORWARD_STILL_AIR_HEAT_LOSS_FRACTION) * fanSpeedFraction));
 }
 
 /**
@@ -234,133 +341,93 @@ void PIDController::SetControlLoopIsEnabled(bool ShouldActivate)
 		SerialHandler::SafeWriteLn(newActiveStateMsg, true);
 	}
 
-	previousError = currentTemperatureSetPointDegCent - currentTemperatureReadingDegCent;
+	engineState.PreviousError = currentTemperatureSetPointDegCent - currentTemperatureReadingDegCent;
 	isControlLoopEnabled = ShouldActivate;
 }
 
 /**
- * @brief                        Used to provide the Controller with changes to any of its floating point settings.
+ * @brief                Caps the Controller's output below Output Max, for when the heater can't be given its full power.
  *
- * @param  ChangedFloatSettings  A Vector containing the changed float settings.
+ * @param  LimitPercent  The highest duty cycle the heater can currently be given, as a percentage.
 */
-void PIDController::ChangeFloatSettings(std::vector<PIDFloatDataPacket>* ChangedFloatSettings)
+void PIDController::SetOutputLimitPercent(const float LimitPercent)
 {
-	for (PIDFloatDataPacket packet : *ChangedFloatSettings)
-	{
-		switch (packet.Setting)
-		{
-			case TemperatureSetPoint:
-				currentTemperatureSetPointDegCent = packet.Value;
-				break;
-
-			case ProportionalGain:
-				proportionalGain = packet.Value;
-				break;
-
-			case IntegralGain:
-				integralGain = packet.Value;
-				break;
-
-			case IntegralWindupLimitMax:
-				integralWindupLimitMax = packet.Value;
-				break;
-
-			case IntegralWindupLimitMin:
-				integralWindupLimitMin = packet.Value;
-				break;
-
-			case DerivativeGain:
-				derivativeGain = packet.Value;
-				break;
+	outputLimitPercent = (LimitPercent < 100.0f) ? LimitPercent : 100.0f;
+	limitedOutputMaxValue = PIDScalar(static_cast<float>(outputMaxValue) * outputLimitPercent / 100.0f);
+}
 
-			case DerivativeTermMaxValue:
-				derivativeTermMaxValue = packet.Value;
-				break;
+/**
+ * @brief              Used to provide the Controller with a change to one of its floating point settings.
+ *
+ * @param  NewSetting  The changed float setting.
+*/
+void PIDController::ChangeFloatSetting(const PIDFloatDataPacket& NewSetting)
+{
+	PIDScalar* const settingStorage = floatSettingStorage[NewSetting.Setting];
+	if (!settingStorage)
+	{
+		return;
+	}
 
-			case DerivativeTermMinValue:
-				derivativeTermMinValue = packet.Value;
-				break;
+	*settingStorage = PIDScalar(NewSetting.Value);
+	recalculateDerivedSettings();
 
-			case OutputMaxValue:
-				outputMaxValue = packet.Value;
-				break;
+	if (debug_ChangeFloatSetting)
+	{
+		std::string newActiveStateMsg = Utils::StringFormat("Setting %s was changed to: %0.1f", GetPIDSettingSchema(NewSetting.Setting).Name, NewSetting.Value);
+		SerialHandler::SafeWriteLn(newActiveStateMsg, true);
+	}
+}
 
+/**
+ * @brief              Used to provide the Controller with a change to one of its integer settings.
+ *
+ * @param  NewSetting  The changed int setting.
+*/
+void PIDController::ChangeIntSetting(const PIDIntDataPacket& NewSetting)
+{
+	int32_t* const settingStorage = intSettingStorage[NewSetting.Setting];
+	if (!settingStorage)
+	{
+		return;
+	}
 
-			case LoopTimeStep:
-				break;
-		}
+	*settingStorage = NewSetting.Value;
+	convertLoopTimeStepMsToMinutes();
+	recalculateDerivedSettings();
 
-		if (debug_ChangeFloatSettings)
-		{
-			std::unordered_map<PIDSettings, std::string> enumMap = {
-					{TemperatureSetPoint, "TemperatureSetPoint"},
-					{LoopTimeStep, "LoopTimeStep"},
-					{ProportionalGain, "ProportionalGain"},
-					{IntegralGain, "IntegralGain"},
-					{IntegralWindupLimitMax, "IntegralWindupLimitMax"},
-					{IntegralWindupLimitMin, "IntegralWindupLimitMin"},
-					{DerivativeGain, "DerivativeGain"},
-					{DerivativeTermMaxValue, "DerivativeTermMaxValue"},
-					{DerivativeTermMinValue, "DerivativeTermMinValue"},
-					{OutputMaxValue, "OutputMaxValue"}
-			};
-			std::string newActiveStateMsg = Utils::StringFormat("Setting %s was changed to: %0.1f", enumMap.find(packet.Setting)->second.c_str(), packet.Value);
-			SerialHandler::SafeWriteLn(newActiveStateMsg, true);
-		}
+	if (debug_ChangeIntSetting)
+	{
+		std::string newActiveStateMsg = Utils::StringFormat("Setting %s was changed to: %i", GetPIDSettingSchema(NewSetting.Setting).Name, NewSetting.Value);
+		SerialHandler::SafeWriteLn(newActiveStateMsg, true);
 	}
 }
 
 /**
- * @brief                      Used to provide the Controller with changes to any of its integer settings.
+ * @brief                  Changes where the Controller gets the current time from.
+ *
+ * @param  MillisFunction  A function that returns the number of milliseconds elapsed, like millis() does.
+ *                         Pass nullptr to go back to using the microcontroller's clock.
  *
- * @param  ChangedIntSettings  A Vector containing the changed int settings.
+ * @note                   Used by the closed loop benchmark to run the Controller faster than real time.
 */
-void PIDController::ChangeIntSettings(std::vector<PIDIntDataPacket>* ChangedIntSettings)
+void PIDController::SetTimeSource(uint32_t (*MillisFunction)())
 {
-	for (PIDIntDataPacket packet : *ChangedIntSettings)
-	{
-		switch (packet.Setting)
-		{
-			case LoopTimeStep:
-				loopTimeStepMs = packet.Value;
-				convertLoopTimeStepMsToMinutes();
-				break;
-
-
-			case TemperatureSetPoint:
-			case ProportionalGain:
-			case IntegralGain:
-			case IntegralWindupLimitMax:
-			case IntegralWindupLimitMin:
-			case DerivativeGain:
-			case DerivativeTermMaxValue:
-			case DerivativeTermMinValue:
-			case OutputMaxValue:
-				break;
-		}
+	getMillis = (MillisFunction != nullptr) ? MillisFunction : hardwareMillis;
+}
 
-		if (debug_ChangeIntSettings)
-		{
-			std::unordered_map<PIDSettings, std::string> enumMap = {
-					{TemperatureSetPoint, "TemperatureSetPoint"},
-					{LoopTimeStep, "LoopTimeStep"},
-					{ProportionalGain, "ProportionalGain"},
-					{IntegralGain, "IntegralGain"},
-					{IntegralWindupLimitMax, "IntegralWindupLimitMax"},
-					{IntegralWindupLimitMin, "IntegralWindupLimitMin"},
-					{DerivativeGain, "DerivativeGain"},
-					{DerivativeTermMaxValue, "DerivativeTermMaxValue"},
-					{DerivativeTermMinValue, "DerivativeTermMinValue"},
-					{OutputMaxValue, "OutputMaxValue"}
-			};
-			std::string newActiveStateMsg = Utils::StringFormat("Setting %s was changed to: %i", enumMap.find(packet.Setting)->second.c_str(), packet.Value);
-			SerialHandler::SafeWriteLn(newActiveStateMsg, true);
-		}
-	}
+/**
+ * @brief   Gets the time from the microcontroller's clock.
+ *
+ * @return  The number of milliseconds that have elapsed since the microcontroller booted up.
+*/
+uint32_t PIDController::hardwareMillis()
+{
+	return millis();
 }
 
 /**
- * @brief    Check if there is a reason the Controller should not do an update (e.g. paused, not enough time elapsed, etc.).
+ * @brief    Check if there is a reason the Controller should not do an update (e.g. paused, no new temperature reading, etc.).
  *
  * @returns  True if the class is not ready for an updated calculation for any reason. False otherwise.
 */
@@ -369,34 +436,37 @@ bool PIDController::updateLoopEarlyReturnChecks()
 	if (isTemperatureErrorLockoutActive)
 	{
 		SerialHandler::SafeWriteLn("PID temperature lockout is active.", debug_updateLoopEarlyReturnChecks);
-		millisValueAtEndOfLastLoop = millis();
+		millisValueAtEndOfLastLoop = getMillis();
 		currentDutyCyclePercent = 0.0;
-		integralAccumulator = 0.0;
+		engineState.IntegralAccumulator = zero;
+		hasPreviousLoopTempReading = false;
 		return true;
 	}
 
 	if (!isControlLoopEnabled)
 	{
 		SerialHandler::SafeWriteLn("PID Control loop is inactive.", debug_updateLoopEarlyReturnChecks);
-		millisValueAtEndOfLastLoop = millis();
+		millisValueAtEndOfLastLoop = getMillis();
 		currentDutyCyclePercent = 0.0;
-		integralAccumulator = 0.0;
+		engineState.IntegralAccumulator = zero;
+		hasPreviousLoopTempReading = false;
 		return true;
 	}
 
-	if ((millis() - millisValueAtLastTempReading) >= TIME_UNTIL_TEMP_ERROR_LOCKOUT_MS)
+	if ((getMillis() - millisValueAtLastTempReading) >= TIME_UNTIL_TEMP_ERROR_LOCKOUT_MS)
 	{
 		SerialHandler::SafeWriteLn("PID temperature lockout check has just activated.", debug_updateLoopEarlyReturnChecks);
 		isTemperatureErrorLockoutActive = true;
 		return true;
 	}
 
-	if ((millis() - millisValueAtEndOfLastLoop) < loopTimeStepMs)
+	if (!hasCurrentTemperatureBeenUpdatedSinceLastLoop)
 	{
 		return true;
 	}
 
-	if (!hasCurrentTemperatureBeenUpdatedSinceLastLoop)
+	// Readings arrive more often than the loop runs, so the loop runs on the reading nearest each time step's tick.
+	if (hasPreviousLoopTempReading && (static_cast<int32_t>(millisValueAtLastTempReading - millisValueAtNextLoopTick) < -LOOP_TICK_TOLERANCE_MS))
 	{
 		return true;
 	}
@@ -405,134 +475,246 @@ bool PIDController::updateLoopEarlyReturnChecks()
 }
 
 /**
- * @brief    Performs the PID calculations.
+ * @brief    Works out how much time has passed between the reading used in the previous loop and the current one.
  *
- * @returns  A struct containing the calculated Proportional and Derivative terms.
+ * @returns  The time between the readings in ms. A reading nearest its tick, or the first one, counts as exactly one
+ *           time step, so the precalculated settings can be used as they are.
 */
-PIDController::pidCalculations PIDController::doPIDCalculations()
+uint32_t PIDController::consumeSampleInterval()
 {
-	pidCalculations results = {};
-
-	float error = currentTemperatureSetPointDegCent - currentTemperatureReadingDegCent;
-	if ((error < ERROR_RANGE) && (error > -ERROR_RANGE))
+	uint32_t sampleIntervalMs = loopTimeStepMs;
+	const int32_t millisFromLoopTick = static_cast<int32_t>(millisValueAtLastTempReading - millisValueAtNextLoopTick);
+	if (hasPreviousLoopTempReading && (millisFromLoopTick <= LOOP_TICK_TOLERANCE_MS))
 	{
-		error = 0;
+		// Stepping the tick on, rather than restarting it from the reading, stops the loop drifting off the grid.
+		millisValueAtNextLoopTick += loopTimeStepMs;
+		millisValueAtPreviousLoopTempReading = millisValueAtLastTempReading;
+		return sampleIntervalMs;
 	}
 
-	if (debug_pidCalculations)
+	// Readings were missed, so the loop is scaled to the real gap and the grid restarts from this reading.
+	if (hasPreviousLoopTempReading)
 	{
-		std::string calculatedErrorMsg = Utils::StringFormat("Calculated Error: %0.2f", error);
-		SerialHandler::SafeWriteLn(calculatedErrorMsg, true);
+		sampleIntervalMs = millisValueAtLastTempReading - millisValueAtPreviousLoopTempReading;
 	}
+	millisValueAtNextLoopTick = millisValueAtLastTempReading + loopTimeStepMs;
 
-	results.ProportionalTerm = calculateProportionalTerm(error);
-	calculateIntegralAccumulation(error);
-	results.DerivativeTerm = calculateDerivativeTerm(error);
+	const uint32_t maxSampleIntervalMs = loopTimeStepMs * MAX_SAMPLE_INTERVAL_LOOP_TIME_STEPS;
+	if (sampleIntervalMs > maxSampleIntervalMs)
+	{
+		sampleIntervalMs = maxSampleIntervalMs;
+	}
+	else if (sampleIntervalMs == 0)
+	{
+		sampleIntervalMs = 1;
+	}
 
-	return results;
+	millisValueAtPreviousLoopTempReading = millisValueAtLastTempReading;
+	hasPreviousLoopTempReading = true;
+	return sampleIntervalMs;
 }
 
 /**
- * @brief         Calculate the Proportional term.
+ * @brief                     Performs the PID calculations.
  *
- * @param  Error  The calculated error value.
+ * @param  SampleIntervalMs   The time since the previous loop's temperature reading, in ms.
  *
- * @return        The Proportional term that was calculated.
+ * @returns                   A struct containing the calculated Proportional and Derivative terms.
 */
-float PIDController::calculateProportionalTerm(float Error)
+PIDController::pidCalculations PIDController::doPIDCalculations(const uint32_t SampleIntervalMs)
 {
-	if (proportionalGain < 0.0001)
+	PIDScalar error = currentTemperatureSetPointDegCent - currentTemperatureReadingDegCent;
+	if ((error < errorRange) && (error > -errorRange))
+	{
+		error = zero;
+	}
+
+	if (debug_pidCalculations)
+	{
+		std::string calculatedErrorMsg = Utils::StringFormat("Calculated Error: %0.2f", static_cast<float>(error));
+		SerialHandler::SafeWriteLn(calculatedErrorMsg, true);
+	}
+
+	if (GainScheduler::IsActive())
 	{
-		return 0.0;
+		applyScheduledGains(error);
 	}
 
-	float proportionalTerm = proportionalGain * Error;
+	const pidCalculations results = calculatePidTerms(error, scaleSettingsToSampleInterval(SampleIntervalMs), engineState);
 
 	if (debug_calculateProportionalTerm)
 	{
 		std::string proportionalCalculationsMsg = Utils::StringFormat("PTerm of %0.2f calculated from PGain of %0.2f",
-		                                                              proportionalTerm, proportionalGain);
+		                                                              static_cast<float>(results.ProportionalTerm),
+		                                                              static_cast<float>(engineSettings.ProportionalGain));
 		SerialHandler::SafeWriteLn(proportionalCalculationsMsg, true);
 	}
 
-	return proportionalTerm;
+	if (debug_calculateIntegralAccumulation)
+	{
+		std::string integralCalculationsMsg = Utils::StringFormat("IAccum is %0.2f calculated from IGain of %0.2f",
+		                                                          static_cast<float>(engineState.IntegralAccumulator),
+		                                                          static_cast<float>(integralGain));
+		SerialHandler::SafeWriteLn(integralCalculationsMsg, true);
+	}
+
+	if (debug_calculateDerivativeTerm)
+	{
+		std::string derivativeCalculationsMsg = Utils::StringFormat("DTerm of %0.4f calculated from DGain of %0.2f",
+		                                                            static_cast<float>(results.DerivativeTerm), static_cast<float>(derivativeGain));
+		SerialHandler::SafeWriteLn(derivativeCalculationsMsg, true);
+	}
+
+	return results;
 }
 
 /**
- * @brief         Calculate the Integral accumulation.
+ * @brief                     Adjusts the time based settings for a loop whose readings weren't exactly one time step apart.
+ *
+ * @param  SampleIntervalMs   The time since the previous loop's temperature reading, in ms.
+ *
+ * @returns                   The settings to use for this loop.
  *
- * @param  Error  The calculated error value.
+ * @note                      The settings are precalculated for the configured time step, so they only need scaling by
+ *                            the ratio between the actual and configured intervals. This costs one division, and is
+ *                            only needed on the loop after readings were missed, as every other loop runs on the grid.
 */
-void PIDController::calculateIntegralAccumulation(const float Error)
+PidEngineSettings<PIDScalar> PIDController::scaleSettingsToSampleInterval(const uint32_t SampleIntervalMs)
 {
-	if (integralGain < 0.0001)
-	{
-		return;
-	}
-
-	const float integralAccumulatorChange = Error * integralGain * loopTimeStepMinutes;
-	integralAccumulator += integralAccumulatorChange;
-	if (integralAccumulator > integralWindupLimitMax)
+	if (SampleIntervalMs == static_cast<uint32_t>(loopTimeStepMs))
 	{
-		integralAccumulator = integralWindupLimitMax;
-	}
-	else if (integralAccumulator < integralWindupLimitMin)
-	{
-		integralAccumulator = integralWindupLimitMin;
+		return engineSettings;
 	}
 
-	if (debug_calculateIntegralAccumulation)
-	{
-		std::string proportionalCalculationsMsg = Utils::StringFormat("IAccum is %0.2f (%0.2f change) calculated from IGain of %0.2f",
-		                                                              integralAccumulator, integralAccumulatorChange, integralGain);
-		SerialHandler::SafeWriteLn(proportionalCalculationsMsg, true);
-	}
+	const PIDScalar intervalRatio = PIDScalar(static_cast<float>(SampleIntervalMs) * loopTimeStepMsReciprocal);
+	PidEngineSettings<PIDScalar> scaledSettings = engineSettings;
+	scaledSettings.IntegralGainTimesLoopTimeStep = engineSettings.IntegralGainTimesLoopTimeStep * intervalRatio;
+	scaledSettings.DerivativeGainDividedByLoopTimeStep = engineSettings.DerivativeGainDividedByLoopTimeStep / intervalRatio;
+	return scaledSettings;
 }
 
 /**
- * @brief         Calculate the Derivative term.
+ * @brief         Takes the gains for the current temperature from the Gain Scheduler.
  *
- * @param  Error  The calculated error value.
+ * @param  Error  This loop's error, used to keep the output continuous when the Proportional gain changes.
  *
- * @return        The Derivative term that was calculated.
+ * @note          The change in the Proportional term is moved into the Integral accumulator, so that the output doesn't
+ *                jump when the gains do. This is skipped if the Integral term isn't in use, as the accumulator would never
+ *                be wound back down. Any of the change that doesn't fit within the windup limits still comes through as
+ *                a step. A change in the Derivative gain isn't smoothed, as the Derivative term only follows the change
+ *                in error, so the step it causes lasts one loop and is capped by the Derivative term's limits.
 */
-float PIDController::calculateDerivativeTerm(float Error)
+void PIDController::applyScheduledGains(const PIDScalar Error)
 {
-	if (derivativeGain < 0.0001)
+	const PIDScalar scheduleTemperature = (GainScheduler::GetKey() == ScheduleOnSetPoint) ?
+		currentTemperatureSetPointDegCent :
+		currentTemperatureReadingDegCent;
+	const GainScheduler::ScheduledGains gains = GainScheduler::Lookup(scheduleTemperature);
+
+	if ((gains.ProportionalGain == engineSettings.ProportionalGain) && (gains.IntegralGain == integralGain) && (gains.DerivativeGain == derivativeGain))
 	{
-		return 0.0;
+		return;
 	}
 
-	const float errorDifference = Error - previousError;
-	previousError = Error;
-	if (debug_calculateDerivativeTerm)
+	if (gains.IntegralGain >= minimumActiveGain)
 	{
-		std::string errorDiffMsg = Utils::StringFormat("Error difference: %0.4f", errorDifference);
-		SerialHandler::SafeWriteLn(errorDiffMsg, debug_calculateDerivativeTerm);
+		engineState.IntegralAccumulator += (engineSettings.ProportionalGain - gains.ProportionalGain) * Error;
+		if (engineState.IntegralAccumulator > engineSettings.IntegralWindupLimitMax)
+		{
+			engineState.IntegralAccumulator = engineSettings.IntegralWindupLimitMax;
+		}
+		else if (engineState.IntegralAccumulator < engineSettings.IntegralWindupLimitMin)
+		{
+			engineState.IntegralAccumulator = engineSettings.IntegralWindupLimitMin;
+		}
 	}
 
-	float derivativeTerm = derivativeGain * errorDifference / loopTimeStepMinutes;
-	if (derivativeTerm > derivativeTermMaxValue)
+	if (debug_applyScheduledGains)
 	{
-		derivativeTerm = derivativeTermMaxValue;
+		std::string scheduledGainsMsg = Utils::StringFormat("Scheduled PGain changed from %0.3f to %0.3f, IAccum is now %0.2f",
+		                                                    static_cast<float>(engineSettings.ProportionalGain),
+		                                                    static_cast<float>(gains.ProportionalGain),
+		                                                    static_cast<float>(engineState.IntegralAccumulator));
+		SerialHandler::SafeWriteLn(scheduledGainsMsg, true);
 	}
-	else if (derivativeTerm < derivativeTermMinValue)
+
+	const bool haveActiveTermsChanged = ((engineSettings.ProportionalGain >= minimumActiveGain) != (gains.ProportionalGain >= minimumActiveGain)) ||
+	                                    ((integralGain >= minimumActiveGain) != (gains.IntegralGain >= minimumActiveGain)) ||
+	                                    ((derivativeGain >= minimumActiveGain) != (gains.DerivativeGain >= minimumActiveGain));
+
+	// With the schedule keyed on the measured temperature this runs on most loops, so only the gains' products with the
+	// time step are updated, from the precalculated step factors.
+	engineSettings.ProportionalGain = gains.ProportionalGain;
+	integralGain = gains.IntegralGain;
+	derivativeGain = gains.DerivativeGain;
+	engineSettings.IntegralGainTimesLoopTimeStep = PIDScalar(static_cast<float>(integralGain) * loopTimeStepMinutes);
+	engineSettings.DerivativeGainDividedByLoopTimeStep = PIDScalar(static_cast<float>(derivativeGain) * loopTimeStepMinutesReciprocal);
+
+	if (haveActiveTermsChanged)
 	{
-		derivativeTerm = derivativeTermMinValue;
+		selectPidEngine();
 	}
+}
 
-	if (debug_calculateDerivativeTerm)
+/**
+ * @brief    Estimates the output needed to replace the heat being lost, so the loop doesn't have to wait for an error to build up.
+ *           The loss is modelled as proportional to the set point's difference from ambient, scaled up by the fan's speed.
+ *
+ * @returns  The feedforward term, in the same units as the Controller's output.
+*/
+PIDScalar PIDController::calculateFeedforwardTerm()
+{
+	const PIDScalar feedforwardTerm = feedforwardGain * (currentTemperatureSetPointDegCent - ambientTemperatureDegCent) * fanHeatLossFactor;
+
+	if (debug_calculateFeedforwardTerm)
 	{
-		std::string derivativeCalculationsMsg = Utils::StringFormat("DTerm of %0.4f calculated from DGain of %0.2f", derivativeTerm, derivativeGain);
-		SerialHandler::SafeWriteLn(derivativeCalculationsMsg, true);
+		std::string feedforwardCalculationsMsg = Utils::StringFormat("FFTerm of %0.2f calculated from FFGain of %0.2f and fan factor of %0.2f",
+		                                                             static_cast<float>(feedforwardTerm), static_cast<float>(feedforwardGain),
+		                                                             static_cast<float>(fanHeatLossFactor));
+		SerialHandler::SafeWriteLn(feedforwardCalculationsMsg, true);
 	}
 
-	return derivativeTerm;
+	return feedforwardTerm;
 }
 
 void PIDController::convertLoopTimeStepMsToMinutes()
 {
 	loopTimeStepMinutes = static_cast<float>(loopTimeStepMs) / 1000 / 60;
+	loopTimeStepMinutesReciprocal = 1.0f / loopTimeStepMinutes;
+	loopTimeStepMsReciprocal = 1.0f / static_cast<float>(loopTimeStepMs);
+}
+
+/**
+ * @brief  Recalculates the values that are derived from the settings, so that the loop itself doesn't need to.
+ *         This includes picking the PID Engine variant that only contains the terms whose gains are in use.
+ *
+ * @note   The products are worked out in float and only then converted, so that the fixed point build doesn't lose
+ *         precision by trying to represent the loop time step in minutes on its own.
+*/
+void PIDController::recalculateDerivedSettings()
+{
+	engineSettings.IntegralGainTimesLoopTimeStep = PIDScalar(static_cast<float>(integralGain) * loopTimeStepMinutes);
+	engineSettings.DerivativeGainDividedByLoopTimeStep = PIDScalar(static_cast<float>(derivativeGain) * loopTimeStepMinutesReciprocal);
+
+	const float outputMax = static_cast<float>(outputMaxValue);
+	outputToDutyCyclePercentFactor = (outputMax > 0) ?
+		PIDScalar(100.0f / outputMax) :
+		zero;
+	limitedOutputMaxValue = PIDScalar(outputMax * outputLimitPercent / 100.0f);
+
+	selectPidEngine();
+}
+
+/**
+ * @brief  Picks the PID Engine variant that only contains the terms whose gains are in use.
+*/
+void PIDController::selectPidEngine()
+{
+	calculatePidTerms = PidEngineDispatcher<PIDScalar>::Select(
+			engineSettings.ProportionalGain >= minimumActiveGain,
+			integralGain >= minimumActiveGain,
+			derivativeGain >= minimumActiveGain
+	);
 }
 
 /**
@@ -541,29 +723,34 @@ void PIDController::convertLoopTimeStepMsToMinutes()
  * @param  Calculations  The calculated Proportional and Derivative terms.
  * @param  Output        The calculated Output value.
 */
-void PIDController::outputGraph(pidCalculations Calculations, float Output)
+void PIDController::outputGraph(pidCalculations Calculations, PIDScalar Output)
 {
 	if (!debug_outputGraph)
 	{
 		return;
 	}
 
-	std::string graphingOutputMsg = Utils::StringFormat("Temperature:%0.2f,", currentTemperatureReadingDegCent);
-	graphingOutputMsg += Utils::StringFormat("TemperatureSetPoint:%0.2f,", currentTemperatureSetPointDegCent);
-	if (proportionalGain > 0.001)
+	const float proportionalTerm = static_cast<float>(Calculations.ProportionalTerm);
+	const float integralAccumulation = static_cast<float>(engineState.IntegralAccumulator);
+	const float derivativeTerm = static_cast<float>(Calculations.DerivativeTerm);
+	const float output = static_cast<float>(Output);
+
+	std::string graphingOutputMsg = Utils::StringFormat("Temperature:%0.2f,", static_cast<float>(currentTemperatureReadingDegCent));
+	graphingOutputMsg += Utils::StringFormat("TemperatureSetPoint:%0.2f,", static_cast<float>(currentTemperatureSetPointDegCent));
+	if (static_cast<float>(engineSettings.ProportionalGain) > 0.001)
 	{
-		graphingOutputMsg += Utils::StringFormat("PTerm:%0.2f,", (Calculations.ProportionalTerm > -10) ? Calculations.ProportionalTerm : -10);
+		graphingOutputMsg += Utils::StringFormat("PTerm:%0.2f,", (proportionalTerm > -10) ? proportionalTerm : -10);
 	}
-	if (integralGain > 0.001)
+	if (static_cast<float>(integralGain) > 0.001)
 	{
-		graphingOutputMsg += Utils::StringFormat("IAccumulator:%0.2f,", (integralAccumulator > -10) ? integralAccumulator : -10);
+		graphingOutputMsg += Utils::StringFormat("IAccumulator:%0.2f,", (integralAccumulation > -10) ? integralAccumulation : -10);
 	}
-	if (derivativeGain > 0.001)
+	if (static_cast<float>(derivativeGain) > 0.001)
 	{
-		graphingOutputMsg += Utils::StringFormat("DTerm:%0.2f,", (Calculations.DerivativeTerm > -10) ? Calculations.DerivativeTerm : -10);
+		graphingOutputMsg += Utils::StringFormat("DTerm:%0.2f,", (derivativeTerm > -10) ? derivativeTerm : -10);
 	}
-	graphingOutputMsg += Utils::StringFormat("Output:%0.2f,", (Output > -10) ? Output : -10);
-	graphingOutputMsg += Utils::StringFormat("LoopTimeStability:%0.2f", (static_cast<float>(millis() - millisValueAtEndOfLastLoop) / loopTimeStepMs * 10));
+	graphingOutputMsg += Utils::StringFormat("Output:%0.2f,", (output > -10) ? output : -10);
+	graphingOutputMsg += Utils::StringFormat("LoopTimeStability:%0.2f", (static_cast<float>(getMillis() - millisValueAtEndOfLastLoop) / loopTimeStepMs * 10));
 	SerialHandler::SafeWriteLn(graphingOutputMsg, true);
 }
 
@@ -576,13 +763,17 @@ void PIDController::enableDebugTriggers()
 {
 //	debug_Update = true;
 //	debug_SetControlLoopActiveStatus = true;
-//	debug_ChangeFloatSettings = true;
-//	debug_ChangeIntSettings = true;
+//	debug_ChangeFloatSetting = true;
+//	debug_ChangeIntSetting = true;
 
 //	debug_updateLoopEarlyReturnChecks = true;
 //	debug_pidCalculations = true;
 //	debug_calculateProportionalTerm = true;
 //	debug_calculateIntegralAccumulation = true;
 //	debug_calculateDerivativeTerm = true;
+//	debug_calculateFeedforwardTerm = true;
+//	debug_applyScheduledGains = true;
+//	debug_updateCycleCount = true;
+//	debug_sampleToOutputLatency = true;
 //	debug_outputGraph = true;
 }
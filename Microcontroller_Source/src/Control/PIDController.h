@@ -14,8 +14,9 @@
 
 #include <array>
 #include <cstdint>
-#include <vector>
 
+#include "Control/PidEngine.h"
+#include "Control/PIDScalar.h"
 #include "InitDataTypes/PIDControllerData.h"
 
 /**
@@ -29,63 +30,104 @@ public:
 	static void ActivateTemperatureLockout();
 	static float ChangeTemperatureSetPoint(float ChangeAmountDegCent);
 	static float GetCurrentDutyCyclePercent();
+	static float GetOutputMaxValue();
 	static float GetTemperatureSetPoint();
 	static bool HasNewLoopRunSinceLastCheck();
 	static bool IsLoopActive();
-	static void SetCurrentTemperature(float CurrentTemperature);
+	static void SetCurrentTemperature(float CurrentTemperature, uint32_t SampleMillisValue);
+	static void SetCurrentFanRpm(uint32_t Rpm);
 	static void SetControlLoopIsEnabled(bool ShouldActivate);
-	static void ChangeFloatSettings(std::vector<PIDFloatDataPacket>* ChangedFloatSettings);
-	static void ChangeIntSettings(std::vector<PIDIntDataPacket>* ChangedIntSettings);
+	static void SetOutputLimitPercent(float LimitPercent);
+	static void ChangeFloatSetting(const PIDFloatDataPacket& NewSetting);
+	static void ChangeIntSetting(const PIDIntDataPacket& NewSetting);
+	static void SetTimeSource(uint32_t (*MillisFunction)());
 
 private:
-	struct pidCalculations
-	{
-		float ProportionalTerm;
-		float DerivativeTerm;
-	};
+	typedef PidEngineTerms<PIDScalar> pidCalculations;
 
 	static bool debug_Update;
 	static bool debug_SetControlLoopActiveStatus;
-	static bool debug_ChangeFloatSettings;
-	static bool debug_ChangeIntSettings;
+	static bool debug_ChangeFloatSetting;
+	static bool debug_ChangeIntSetting;
 	static bool debug_outputGraph;
 	static bool debug_updateLoopEarlyReturnChecks;
 	static bool debug_pidCalculations;
 	static bool debug_calculateProportionalTerm;
 	static bool debug_calculateIntegralAccumulation;
 	static bool debug_calculateDerivativeTerm;
+	static bool debug_calculateFeedforwardTerm;
+	static bool debug_applyScheduledGains;
+	static bool debug_updateCycleCount;
+	static bool debug_sampleToOutputLatency;
 
 	static bool hasCurrentTemperatureBeenUpdatedSinceLastLoop;
+	static bool hasPreviousLoopTempReading;
 	static bool isControlLoopEnabled;
 	static bool isTemperatureErrorLockoutActive;
 	static bool newLoopHasRun;
 	static uint32_t millisValueAtEndOfLastLoop;
 	static uint32_t millisValueAtLastTempReading;
+	static uint32_t millisValueAtPreviousLoopTempReading;
+	static uint32_t millisValueAtNextLoopTick;
 	static float currentDutyCyclePercent;
-	static float currentTemperatureReadingDegCent;
-	static float currentTemperatureSetPointDegCent;
-	static float integralAccumulator;
-	static float previousError;
+	static float outputLimitPercent;
+	static PIDScalar currentTemperatureReadingDegCent;
+	static PIDScalar currentTemperatureSetPointDegCent;
+	static PidEngineState<PIDScalar> engineState;
 	static std::array<float, 3> mostRecentDerivativeTerms;
 
 	static int32_t loopTimeStepMs;
 	static float loopTimeStepMinutes;
-	static float proportionalGain;
-	static float integralGain;
-	static float integralWindupLimitMax;
-	static float integralWindupLimitMin;
-	static float derivativeGain;
-	static float derivativeTermMaxValue;
-	static float derivativeTermMinValue;
-	static float outputMaxValue;
+	static float loopTimeStepMinutesReciprocal;
+	static float loopTimeStepMsReciprocal;
+	static PIDScalar integralGain;
+	static PIDScalar derivativeGain;
+	static PIDScalar outputMaxValue;
+	static PIDScalar limitedOutputMaxValue;
+	static PIDScalar feedforwardGain;
+	static PIDScalar ambientTemperatureDegCent;
+	static PIDScalar fanHeatLossFactor;
 
+	// Holds the Proportional gain and the limits directly, plus products and quotients of the other settings that only
+	// change when a setting does. Precalculating these removes all divisions from the loop, and means the fixed point
+	// build doesn't need to represent tiny time steps.
+	static PidEngineSettings<PIDScalar> engineSettings;
+	static PIDScalar outputToDutyCyclePercentFactor;
+	static PidEngineDispatcher<PIDScalar>::CalculateFunction calculatePidTerms;
+
+	// Where each setting is stored, indexed by the PIDSettings enum. Settings of the other type are nullptr.
+	static constexpr std::array<PIDScalar*, PIDSettingsCount> floatSettingStorage = {{
+			&currentTemperatureSetPointDegCent,
+			nullptr,
+			&engineSettings.ProportionalGain,
+			&integralGain,
+			&engineSettings.IntegralWindupLimitMax,
+			&engineSettings.IntegralWindupLimitMin,
+			&derivativeGain,
+			&engineSettings.DerivativeTermMaxValue,
+			&engineSettings.DerivativeTermMinValue,
+			&outputMaxValue,
+			&feedforwardGain,
+			&ambientTemperatureDegCent
+	}};
+	static constexpr std::array<int32_t*, PIDSettingsCount> intSettingStorage = {{
+			nullptr,
+			&loopTimeStepMs
+	}};
+
+	static uint32_t (*getMillis)();
+
+	static uint32_t hardwareMillis();
 	static bool updateLoopEarlyReturnChecks();
-	static pidCalculations doPIDCalculations();
-	static float calculateProportionalTerm(float Error);
-	static void calculateIntegralAccumulation(float Error);
-	static float calculateDerivativeTerm(float Error);
+	static uint32_t consumeSampleInterval();
+	static pidCalculations doPIDCalculations(uint32_t SampleIntervalMs);
+	static PidEngineSettings<PIDScalar> scaleSettingsToSampleInterval(uint32_t SampleIntervalMs);
+	static void applyScheduledGains(PIDScalar Error);
+	static PIDScalar calculateFeedforwardTerm();
 	static void convertLoopTimeStepMsToMinutes();
-	static void outputGraph(pidCalculations Calculations, float Output);
+	static void recalculateDerivedSettings();
+	static void selectPidEngine();
+	static void outputGraph(pidCalculations Calculations, PIDScalar Output);
 	static void enableDebugTriggers();
 };
 
@@ -0,0 +1,33 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_PID_SCALAR_H
+#define ENGINEERING_PROJECT_PID_SCALAR_H
+
+#include "Control/FixedPoint.h"
+
+// The number type used for the PID Controller's calculations is selected at build time.
+// Add -DPID_USE_FIXED_POINT to the build flags to use fixed point maths instead of software emulated floats.
+// The number of fractional bits can be changed with -DPID_FIXED_POINT_FRACTIONAL_BITS=<n> (defaults to Q16.16).
+#ifdef PID_USE_FIXED_POINT
+
+#ifndef PID_FIXED_POINT_FRACTIONAL_BITS
+#define PID_FIXED_POINT_FRACTIONAL_BITS 16
+#endif
+
+typedef FixedPoint<PID_FIXED_POINT_FRACTIONAL_BITS> PIDScalar;
+
+#else
+
+typedef float PIDScalar;
+
+#endif
+
+#endif //ENGINEERING_PROJECT_PID_SCALAR_H
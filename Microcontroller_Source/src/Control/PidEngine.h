@@ -0,0 +1,163 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_PID_ENGINE_H
+#define ENGINEERING_PROJECT_PID_ENGINE_H
+
+#include <cstdint>
+
+/**
+ * @brief  The settings used by the PID Engine, with the gains already combined with the loop's time step.
+*/
+template <typename Scalar>
+struct PidEngineSettings
+{
+	Scalar ProportionalGain;
+	Scalar IntegralGainTimesLoopTimeStep;
+	Scalar IntegralWindupLimitMax;
+	Scalar IntegralWindupLimitMin;
+	Scalar DerivativeGainDividedByLoopTimeStep;
+	Scalar DerivativeTermMaxValue;
+	Scalar DerivativeTermMinValue;
+};
+
+/**
+ * @brief  The values the PID Engine carries over from one loop to the next.
+*/
+template <typename Scalar>
+struct PidEngineState
+{
+	Scalar IntegralAccumulator;
+	Scalar PreviousError;
+};
+
+/**
+ * @brief  The Proportional and Derivative terms calculated by the PID Engine. The Integral term is held in the Engine's state.
+*/
+template <typename Scalar>
+struct PidEngineTerms
+{
+	Scalar ProportionalTerm;
+	Scalar DerivativeTerm;
+};
+
+/**
+ * @brief  Performs the PID calculations, with the unused terms removed at compile time.
+ *
+ * Each combination of terms is its own instantiation, so a P-only or PI loop contains none of the arithmetic or gain
+ * checks of the terms it doesn't use. Terms that are compiled out are left at zero, and leave the state untouched.
+*/
+template <bool HasP, bool HasI, bool HasD, typename Scalar>
+class PidEngine
+{
+public:
+	/**
+	 * @brief             Calculates the PID terms for a new error value.
+	 *
+	 * @param  Error      The difference between the set point and measured value.
+	 * @param  Settings   The gains and limits to use.
+	 * @param  State      The values carried over from the previous loop. Updated by this function.
+	 *
+	 * @return            The calculated Proportional and Derivative terms.
+	*/
+	static PidEngineTerms<Scalar> Calculate(const Scalar Error, const PidEngineSettings<Scalar>& Settings, PidEngineState<Scalar>& State)
+	{
+		PidEngineTerms<Scalar> terms = {};
+
+		if constexpr (HasP)
+		{
+			terms.ProportionalTerm = Settings.ProportionalGain * Error;
+		}
+
+		if constexpr (HasI)
+		{
+			State.IntegralAccumulator += Error * Settings.IntegralGainTimesLoopTimeStep;
+			if (State.IntegralAccumulator > Settings.IntegralWindupLimitMax)
+			{
+				State.IntegralAccumulator = Settings.IntegralWindupLimitMax;
+			}
+			else if (State.IntegralAccumulator < Settings.IntegralWindupLimitMin)
+			{
+				State.IntegralAccumulator = Settings.IntegralWindupLimitMin;
+			}
+		}
+
+		if constexpr (HasD)
+		{
+			const Scalar errorDifference = Error - State.PreviousError;
+			State.PreviousError = Error;
+
+			terms.DerivativeTerm = errorDifference * Settings.DerivativeGainDividedByLoopTimeStep;
+			if (terms.DerivativeTerm > Settings.DerivativeTermMaxValue)
+			{
+				terms.DerivativeTerm = Settings.DerivativeTermMaxValue;
+			}
+			else if (terms.DerivativeTerm < Settings.DerivativeTermMinValue)
+			{
+				terms.DerivativeTerm = Settings.DerivativeTermMinValue;
+			}
+		}
+
+		return terms;
+	}
+};
+
+/**
+ * @brief  Picks the PID Engine instantiation that matches which terms are currently in use.
+*/
+template <typename Scalar>
+class PidEngineDispatcher
+{
+public:
+	static constexpr uint8_t VariantCount = 8;
+
+	typedef PidEngineTerms<Scalar> (*CalculateFunction)(Scalar Error, const PidEngineSettings<Scalar>& Settings, PidEngineState<Scalar>& State);
+
+	/**
+	 * @brief          Gets the number that identifies the instantiation matching the given terms.
+	 *
+	 * @param  UseP    True if the Proportional term is in use.
+	 * @param  UseI    True if the Integral term is in use.
+	 * @param  UseD    True if the Derivative term is in use.
+	 *
+	 * @return         A number below VariantCount, with one bit per term.
+	*/
+	static constexpr uint8_t GetVariant(const bool UseP, const bool UseI, const bool UseD)
+	{
+		return (UseP ? 0b100 : 0) | (UseI ? 0b010 : 0) | (UseD ? 0b001 : 0);
+	}
+
+	/**
+	 * @brief          Gets the Calculate function of the instantiation that matches the given terms.
+	 *
+	 * @param  UseP    True if the Proportional term is in use.
+	 * @param  UseI    True if the Integral term is in use.
+	 * @param  UseD    True if the Derivative term is in use.
+	 *
+	 * @return         The matching Calculate function.
+	*/
+	static CalculateFunction Select(const bool UseP, const bool UseI, const bool UseD)
+	{
+		switch (GetVariant(UseP, UseI, UseD))
+		{
+			case 0b000: return PidEngine<false, false, false, Scalar>::Calculate;
+			case 0b001: return PidEngine<false, false, true, Scalar>::Calculate;
+			case 0b010: return PidEngine<false, true, false, Scalar>::Calculate;
+			case 0b011: return PidEngine<false, true, true, Scalar>::Calculate;
+			case 0b100: return PidEngine<true, false, false, Scalar>::Calculate;
+			case 0b101: return PidEngine<true, false, true, Scalar>::Calculate;
+			case 0b110: return PidEngine<true, true, false, Scalar>::Calculate;
+			case 0b111:
+			default:    return PidEngine<true, true, true, Scalar>::Calculate;
+		}
+	}
+};
+
+#endif //ENGINEERING_PROJECT_PID_ENGINE_H
@@ -0,0 +1,188 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "PowerBudget.h"
+
+#include <Arduino.h>
+
+#include "IO/FanControl.h"
+#include "IO/HeaterControl.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+// The most the heater and fan may draw between them. Can be overridden with -DPOWER_BUDGET_MAX_WATTS=<n>.
+#ifndef POWER_BUDGET_MAX_WATTS
+#define POWER_BUDGET_MAX_WATTS      (HEATER_ELEMENT_WATTAGE + FAN_RATED_WATTAGE)
+#endif
+
+// How quickly the heater's limit is allowed to rise back. Can be overridden with -DPOWER_BUDGET_LIMIT_RISE_PERCENT_PER_S=<n>.
+#ifndef POWER_BUDGET_LIMIT_RISE_PERCENT_PER_S
+#define POWER_BUDGET_LIMIT_RISE_PERCENT_PER_S   10.0f
+#endif
+
+#define LIMITING_REPORT_HOLD_MS     (5 * 1000)      // Limiting must stop for this long before it's reported as over.
+
+
+static_assert(POWER_BUDGET_MAX_WATTS >= FAN_RATED_WATTAGE, "The power budget must at least cover the fan at full speed.");
+
+
+bool PowerBudget::debug_Update = false;
+
+bool PowerBudget::isHeaterLimited = false;
+uint32_t PowerBudget::millisValueAtLastUpdate = 0;
+uint32_t PowerBudget::millisValueAtLastLimiting = 0;
+float PowerBudget::heaterPowerLimitPercent = 0.0;
+float PowerBudget::heaterPowerLevelPercent = 0.0;
+
+
+/**
+ * @brief  Initialises the Power Budget class.
+*/
+void PowerBudget::Init()
+{
+	enableDebugTriggers();
+
+	const float heaterPowerLimitWithFanOff = 100.0f * POWER_BUDGET_MAX_WATTS / HEATER_ELEMENT_WATTAGE;
+	heaterPowerLimitPercent = (heaterPowerLimitWithFanOff < 100.0f) ? heaterPowerLimitWithFanOff : 100.0f;
+	millisValueAtLastUpdate = millis();
+
+	std::string budgetMsg = Utils::StringFormat("Power budget: %d W, heater limited to %0.1f%% with the fan off.",
+	                                            POWER_BUDGET_MAX_WATTS, heaterPowerLimitPercent);
+	SerialHandler::SafeWriteLn(budgetMsg, heaterPowerLimitPercent < 100.0f);
+}
+
+/**
+ * @brief                                    Shares the power budget out between the fan and heater. Must be called every
+ *                                           loop, after the fan's duty cycle has been set.
+ *
+ * @param  RequestedHeaterPowerLevelPercent  The heater power level the PID Controller or Auto Tuner wants.
+ * @param  FanDutyCyclePercent               The duty cycle the fan is running at.
+*/
+void PowerBudget::Update(const float RequestedHeaterPowerLevelPercent, const float FanDutyCyclePercent)
+{
+	const uint32_t millisValueNow = millis();
+	const float secondsSinceLastUpdate = static_cast<float>(millisValueNow - millisValueAtLastUpdate) / 1000.0f;
+	millisValueAtLastUpdate = millisValueNow;
+
+	const float fanWatts = getFanWatts(FanDutyCyclePercent);
+	float newHeaterPowerLimitPercent = 100.0f * (POWER_BUDGET_MAX_WATTS - fanWatts) / HEATER_ELEMENT_WATTAGE;
+	if (newHeaterPowerLimitPercent > 100.0f)
+	{
+		newHeaterPowerLimitPercent = 100.0f;
+	}
+	else if (newHeaterPowerLimitPercent < 0.0f)
+	{
+		newHeaterPowerLimitPercent = 0.0f;
+	}
+
+	// Dropping the limit straight away keeps the draw within the budget. Raising it slowly stops a fan that's slowing
+	// down from handing the heater a step in its limit.
+	const float maxHeaterPowerLimitRise = POWER_BUDGET_LIMIT_RISE_PERCENT_PER_S * secondsSinceLastUpdate;
+	if (newHeaterPowerLimitPercent > (heaterPowerLimitPercent + maxHeaterPowerLimitRise))
+	{
+		newHeaterPowerLimitPercent = heaterPowerLimitPercent + maxHeaterPowerLimitRise;
+	}
+	heaterPowerLimitPercent = newHeaterPowerLimitPercent;
+
+	const bool isLimitingNow = RequestedHeaterPowerLevelPercent > heaterPowerLimitPercent;
+	heaterPowerLevelPercent = isLimitingNow ? heaterPowerLimitPercent : RequestedHeaterPowerLevelPercent;
+	reportLimiting(isLimitingNow, RequestedHeaterPowerLevelPercent);
+
+	if (debug_Update)
+	{
+		std::string updateMsg = Utils::StringFormat("Power budget: fan %0.1f W, heater limit %0.1f%%, heater requested %0.1f%%",
+		                                            fanWatts, heaterPowerLimitPercent, RequestedHeaterPowerLevelPercent);
+		SerialHandler::SafeWriteLn(updateMsg, true);
+	}
+}
+
+/**
+ * @brief    Gets the heater power level that fits in the budget.
+ *
+ * @returns  The power level to give the Heater Controller, as a percentage.
+*/
+float PowerBudget::GetHeaterPowerLevel()
+{
+	return heaterPowerLevelPercent;
+}
+
+/**
+ * @brief    Gets the highest heater power level the budget currently allows.
+ *
+ * @returns  The limit as a percentage.
+*/
+float PowerBudget::GetHeaterPowerLimit()
+{
+	return heaterPowerLimitPercent;
+}
+
+/**
+ * @brief    Checks whether the heater is being derated to stay within the budget.
+ *
+ * @returns  True if the heater was given less than it asked for within the last LIMITING_REPORT_HOLD_MS. False otherwise.
+*/
+bool PowerBudget::IsHeaterLimited()
+{
+	return isHeaterLimited;
+}
+
+/**
+ * @brief                       Estimates the fan's power draw, which rises with the cube of its speed.
+ *
+ * @param  FanDutyCyclePercent  The duty cycle the fan is running at.
+ *
+ * @returns                     The fan's power draw in watts.
+*/
+float PowerBudget::getFanWatts(const float FanDutyCyclePercent)
+{
+	const float fanSpeedFraction = FanDutyCyclePercent / 100.0f;
+	return FAN_RATED_WATTAGE * fanSpeedFraction * fanSpeedFraction * fanSpeedFraction;
+}
+
+/**
+ * @brief                                    Reports to the Serial port when the heater starts and stops being derated. A
+ *                                           request hovering around the limit is reported as a single stretch of limiting.
+ *
+ * @param  IsLimitingNow                     True if the heater was given less than it asked for on this loop.
+ * @param  RequestedHeaterPowerLevelPercent  The heater power level that was asked for.
+*/
+void PowerBudget::reportLimiting(const bool IsLimitingNow, const float RequestedHeaterPowerLevelPercent)
+{
+	if (IsLimitingNow)
+	{
+		millisValueAtLastLimiting = millis();
+		if (!isHeaterLimited)
+		{
+			isHeaterLimited = true;
+			std::string limitingMsg = Utils::StringFormat("Power budget: heater derated from %0.1f%% to %0.1f%% to stay within %d W.",
+			                                              RequestedHeaterPowerLevelPercent, heaterPowerLimitPercent, POWER_BUDGET_MAX_WATTS);
+			SerialHandler::SafeWriteLn(limitingMsg, true);
+		}
+		return;
+	}
+
+	if (isHeaterLimited && ((millis() - millisValueAtLastLimiting) >= LIMITING_REPORT_HOLD_MS))
+	{
+		isHeaterLimited = false;
+		SerialHandler::SafeWriteLn("Power budget: heater no longer derated.", true);
+	}
+}
+
+/**
+ * @brief  Used to instruct given functions to use their debug code.
+ *
+ * @note   Uncomment the booleans that represent the functions you want to debug.
+*/
+void PowerBudget::enableDebugTriggers()
+{
+//	debug_Update = true;
+}
@@ -0,0 +1,54 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_POWER_BUDGET_H
+#define ENGINEERING_PROJECT_POWER_BUDGET_H
+
+#include <cstdint>
+
+/**
+ * @brief  Keeps the heater and fan's combined power draw within POWER_BUDGET_MAX_WATTS, so a site can be given a share
+ *         of a breaker it has in common with other sites.
+ *
+ * The fan always gets the power it asks for, as the heater mustn't run without it. Its draw is estimated from its duty
+ * cycle, on the basis that a fan's power rises with the cube of its speed. Whatever is left over sets how much of the
+ * heater's power level can be used. The heater's request is derated to this limit rather than being switched off, so the
+ * PID Controller keeps as much control as the budget allows. The limit is also passed to the PID Controller and Auto
+ * Tuner, so neither winds up or measures against power the heater was never given. The limit drops straight away when
+ * the fan needs more of the budget, and rises back gradually once the fan slows. Only the limit is rate limited; the
+ * heater's own requests beneath it are passed through as they are.
+ *
+ * Without POWER_BUDGET_MAX_WATTS set, the budget covers both at full power and the heater is never limited.
+*/
+class PowerBudget
+{
+public:
+	static void Init();
+	static void Update(float RequestedHeaterPowerLevelPercent, float FanDutyCyclePercent);
+	static float GetHeaterPowerLevel();
+	static float GetHeaterPowerLimit();
+	static bool IsHeaterLimited();
+
+private:
+	static bool debug_Update;
+
+	static bool isHeaterLimited;
+	static uint32_t millisValueAtLastUpdate;
+	static uint32_t millisValueAtLastLimiting;
+	static float heaterPowerLimitPercent;
+	static float heaterPowerLevelPercent;
+
+	static float getFanWatts(float FanDutyCyclePercent);
+	static void reportLimiting(bool IsLimitingNow, float RequestedHeaterPowerLevelPercent);
+
+	static void enableDebugTriggers();
+};
+
+#endif //ENGINEERING_PROJECT_POWER_BUDGET_H
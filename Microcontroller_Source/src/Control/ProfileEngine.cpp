@@ -0,0 +1,356 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "ProfileEngine.h"
+
+#include <Arduino.h>
+#include <cmath>
+
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+#define MS_PER_MINUTE   (60 * 1000)
+
+// The PID Controller's set point limits, in the tenths of a degree that ramp steps hold their targets in.
+#define MAX_TEMPERATURE_SET_POINT_DECI_DEG  400
+#define MIN_TEMPERATURE_SET_POINT_DECI_DEG  (-200)
+
+
+bool ProfileEngine::debug_Start = false;
+bool ProfileEngine::debug_enterStep = false;
+
+bool ProfileEngine::isRunning = false;
+const ProfileStep* ProfileEngine::steps = nullptr;
+uint8_t ProfileEngine::stepCount = 0;
+uint8_t ProfileEngine::currentStep = 0;
+uint32_t ProfileEngine::millisValueAtLastUpdate = 0;
+uint32_t ProfileEngine::millisElapsedInStep = 0;
+float ProfileEngine::setPointDegCent = 0.0;
+float ProfileEngine::stepStartSetPointDegCent = 0.0;
+std::array<int16_t, MAX_PROFILE_STEPS> ProfileEngine::repeatsDone = {};
+
+
+/**
+ * @brief  Initialises the Profile Engine class.
+*/
+void ProfileEngine::Init()
+{
+	enableDebugTriggers();
+}
+
+/**
+ * @brief                           Starts running a set point profile from its first step.
+ *
+ * @param  Steps                    The profile's steps. Must stay valid until the profile finishes or is stopped.
+ * @param  StepCount                The number of steps in the profile.
+ * @param  StartingSetPointDegCent  The set point when the profile starts, which the first ramp starts from.
+ *
+ * @return                          True if the profile was started. False if it was rejected as invalid.
+*/
+bool ProfileEngine::Start(const ProfileStep* Steps, const uint8_t StepCount, const float StartingSetPointDegCent)
+{
+	if (!isProfileValid(Steps, StepCount))
+	{
+		SerialHandler::SafeWriteLn("Set point profile is invalid and was not started.", true);
+		return false;
+	}
+
+	steps = Steps;
+	stepCount = StepCount;
+	setPointDegCent = StartingSetPointDegCent;
+	repeatsDone.fill(0);
+	millisValueAtLastUpdate = millis();
+	isRunning = true;
+
+	if (debug_Start)
+	{
+		std::string startMsg = Utils::StringFormat("Set point profile with %u steps started from %0.1f°C", stepCount, setPointDegCent);
+		SerialHandler::SafeWriteLn(startMsg, true);
+	}
+
+	enterStep(0);
+	return true;
+}
+
+/**
+ * @brief  Stops the running profile, leaving the set point where it is.
+*/
+void ProfileEngine::Stop()
+{
+	if (!isRunning)
+	{
+		return;
+	}
+
+	SerialHandler::SafeWriteLn("Set point profile was stopped.", debug_Start);
+	isRunning = false;
+}
+
+/**
+ * @brief               Advances the running profile, and works out the new set point.
+ *
+ * @param  ShouldHold   True if the profile's clock should be held, e.g. because the unit isn't heating. False otherwise.
+*/
+void ProfileEngine::Update(const bool ShouldHold)
+{
+	if (!isRunning)
+	{
+		return;
+	}
+
+	const uint32_t millisValueNow = millis();
+	if (!ShouldHold)
+	{
+		millisElapsedInStep += millisValueNow - millisValueAtLastUpdate;
+	}
+	millisValueAtLastUpdate = millisValueNow;
+
+	// Steps that take no time, like jumps and repeats, are worked through in one go. This is capped so that a profile
+	// which repeats instantaneous steps a huge number of times can't stall the main loop.
+	for (uint8_t i = 0; i < MAX_PROFILE_STEPS; ++i)
+	{
+		if (!updateCurrentStep())
+		{
+			return;
+		}
+	}
+}
+
+/**
+ * @brief   Gets the step the profile is currently on.
+ *
+ * @return  The index of the current step.
+*/
+uint8_t ProfileEngine::GetCurrentStep()
+{
+	return currentStep;
+}
+
+/**
+ * @brief   Gets the set point the profile currently wants.
+ *
+ * @return  The set point in °C.
+*/
+float ProfileEngine::GetSetPoint()
+{
+	return setPointDegCent;
+}
+
+/**
+ * @brief   Gets the number of steps in the running profile.
+ *
+ * @return  The number of steps.
+*/
+uint8_t ProfileEngine::GetStepCount()
+{
+	return stepCount;
+}
+
+/**
+ * @brief   Gets how long the current step has left to run.
+ *
+ * @return  The number of seconds left, or 0 if the step takes no time.
+*/
+uint32_t ProfileEngine::GetStepSecondsRemaining()
+{
+	if (!isRunning)
+	{
+		return 0;
+	}
+
+	const ProfileStep& step = steps[currentStep];
+	switch (step.Command)
+	{
+		case ProfileRamp:
+		{
+			if (step.Parameter == 0)
+			{
+				return 0;
+			}
+
+			const float distanceRemainingDegCent = std::fabs((static_cast<float>(step.Value) / 10) - setPointDegCent);
+			return static_cast<uint32_t>(std::ceil(distanceRemainingDegCent / (static_cast<float>(step.Parameter) / 10) * 60));
+		}
+
+		case ProfileSoak:
+		{
+			const uint32_t soakDurationMs = static_cast<uint32_t>(step.Value) * MS_PER_MINUTE;
+			return (millisElapsedInStep >= soakDurationMs) ? 0 : ((soakDurationMs - millisElapsedInStep + 999) / 1000);
+		}
+
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief   Checks if a profile is running.
+ *
+ * @return  True if a profile is running. False otherwise.
+*/
+bool ProfileEngine::IsRunning()
+{
+	return isRunning;
+}
+
+/**
+ * @brief             Checks that a profile can be run.
+ *
+ * @param  Steps      The profile's steps.
+ * @param  StepCount  The number of steps in the profile.
+ *
+ * @return            True if every step is a known command, ramps stay within the set point limits, durations aren't
+ *                    negative, and repeats only jump backwards.
+*/
+bool ProfileEngine::isProfileValid(const ProfileStep* Steps, const uint8_t StepCount)
+{
+	if ((Steps == nullptr) || (StepCount == 0) || (StepCount > MAX_PROFILE_STEPS))
+	{
+		return false;
+	}
+
+	for (uint8_t i = 0; i < StepCount; ++i)
+	{
+		const ProfileStep& step = Steps[i];
+		switch (step.Command)
+		{
+			case ProfileRamp:
+				// The PID Controller clamps its set point to these limits, so a ramp past them would leave the
+				// profile's set point out of step with the one actually in use.
+				if ((step.Value > MAX_TEMPERATURE_SET_POINT_DECI_DEG) || (step.Value < MIN_TEMPERATURE_SET_POINT_DECI_DEG))
+				{
+					return false;
+				}
+				break;
+
+			case ProfileEnd:
+				break;
+
+			case ProfileSoak:
+				if (step.Value < 0)
+				{
+					return false;
+				}
+				break;
+
+			case ProfileRepeat:
+				if ((step.Value < 0) || (step.Parameter >= i))
+				{
+					return false;
+				}
+				break;
+
+			default:
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief    Works out the set point for the current step, and moves on to the next step if this one has finished.
+ *
+ * @returns  True if a new step was entered, and so needs updating as well. False otherwise.
+*/
+bool ProfileEngine::updateCurrentStep()
+{
+	const ProfileStep& step = steps[currentStep];
+	switch (step.Command)
+	{
+		case ProfileRamp:
+		{
+			const float targetDegCent = static_cast<float>(step.Value) / 10;
+			const float rampDistanceDegCent = targetDegCent - stepStartSetPointDegCent;
+			const float distanceCoveredDegCent = (static_cast<float>(step.Parameter) / 10) * (static_cast<float>(millisElapsedInStep) / MS_PER_MINUTE);
+			if ((step.Parameter == 0) || (distanceCoveredDegCent >= std::fabs(rampDistanceDegCent)))
+			{
+				setPointDegCent = targetDegCent;
+				enterStep(currentStep + 1);
+				return isRunning;
+			}
+
+			setPointDegCent = stepStartSetPointDegCent + std::copysign(distanceCoveredDegCent, rampDistanceDegCent);
+			return false;
+		}
+
+		case ProfileSoak:
+		{
+			if (millisElapsedInStep < (static_cast<uint32_t>(step.Value) * MS_PER_MINUTE))
+			{
+				return false;
+			}
+
+			enterStep(currentStep + 1);
+			return isRunning;
+		}
+
+		case ProfileRepeat:
+		{
+			if (repeatsDone[currentStep] < step.Value)
+			{
+				repeatsDone[currentStep]++;
+				enterStep(step.Parameter);
+				return true;
+			}
+
+			// Cleared so that an outer repeat runs this one in full again.
+			repeatsDone[currentStep] = 0;
+			enterStep(currentStep + 1);
+			return isRunning;
+		}
+
+		case ProfileEnd:
+		default:
+		{
+			SerialHandler::SafeWriteLn("Set point profile finished.", debug_enterStep);
+			isRunning = false;
+			return false;
+		}
+	}
+}
+
+/**
+ * @brief        Moves the profile on to a new step. Running past the last step finishes the profile.
+ *
+ * @param  Step  The index of the step to move to.
+*/
+void ProfileEngine::enterStep(const uint8_t Step)
+{
+	if (Step >= stepCount)
+	{
+		SerialHandler::SafeWriteLn("Set point profile finished.", debug_enterStep);
+		isRunning = false;
+		return;
+	}
+
+	currentStep = Step;
+	millisElapsedInStep = 0;
+	stepStartSetPointDegCent = setPointDegCent;
+
+	if (debug_enterStep)
+	{
+		std::string stepMsg = Utils::StringFormat("Set point profile entered step %u with the set point at %0.1f°C", currentStep, setPointDegCent);
+		SerialHandler::SafeWriteLn(stepMsg, true);
+	}
+}
+
+/**
+ * @brief  Used to instruct given functions to use their debug code.
+ *
+ * @note   Uncomment the booleans that represent the functions you want to debug.
+*/
+void ProfileEngine::enableDebugTriggers()
+{
+//	debug_Start = true;
+//	debug_enterStep = true;
+}
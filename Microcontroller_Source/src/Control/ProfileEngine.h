@@ -0,0 +1,108 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_PROFILE_ENGINE_H
+#define ENGINEERING_PROJECT_PROFILE_ENGINE_H
+
+#include <array>
+#include <cstdint>
+
+#include "InitDataTypes/ProfileData.h"
+
+/**
+ * @brief  Runs ramp/soak set point profiles, so that warm-up sequences don't have to be stepped through by hand.
+ *
+ * A profile is a list of 4 byte steps that ramp the set point to a temperature at a given rate, hold it for a number of
+ * minutes, or repeat earlier steps. Profiles are only read, never copied, so they can live in flash. The time spent in
+ * a step only counts while the caller isn't holding the profile, so a probe fault or switched off unit doesn't cut a
+ * soak short.
+*/
+class ProfileEngine
+{
+public:
+	static void Init();
+	static bool Start(const ProfileStep* Steps, uint8_t StepCount, float StartingSetPointDegCent);
+	static void Stop();
+	static void Update(bool ShouldHold);
+	static uint8_t GetCurrentStep();
+	static float GetSetPoint();
+	static uint8_t GetStepCount();
+	static uint32_t GetStepSecondsRemaining();
+	static bool IsRunning();
+
+	/**
+	 * @brief                        Creates a step that ramps the set point to a new temperature.
+	 *
+	 * @param  TargetDegCent         The temperature to ramp to, to the nearest 0.1°C.
+	 * @param  RateDegCentPerMinute  How fast to ramp, to the nearest 0.1°C/min, up to 25.5°C/min. 0 jumps straight there.
+	 *
+	 * @return                       The encoded step.
+	*/
+	static constexpr ProfileStep Ramp(const float TargetDegCent, const float RateDegCentPerMinute)
+	{
+		return {ProfileRamp, static_cast<uint8_t>(RateDegCentPerMinute * 10 + 0.5f), static_cast<int16_t>(TargetDegCent * 10 + ((TargetDegCent < 0) ? -0.5f : 0.5f))};
+	}
+
+	/**
+	 * @brief           Creates a step that holds the set point where it is.
+	 *
+	 * @param  Minutes  How long to hold the set point for.
+	 *
+	 * @return          The encoded step.
+	*/
+	static constexpr ProfileStep Soak(const int16_t Minutes)
+	{
+		return {ProfileSoak, 0, Minutes};
+	}
+
+	/**
+	 * @brief             Creates a step that jumps back to an earlier step.
+	 *
+	 * @param  ToStep     The index of the step to jump back to.
+	 * @param  ExtraRuns  How many more times the steps in between should run.
+	 *
+	 * @return            The encoded step.
+	*/
+	static constexpr ProfileStep Repeat(const uint8_t ToStep, const int16_t ExtraRuns)
+	{
+		return {ProfileRepeat, ToStep, ExtraRuns};
+	}
+
+	/**
+	 * @brief   Creates a step that finishes the profile.
+	 *
+	 * @return  The encoded step.
+	*/
+	static constexpr ProfileStep End()
+	{
+		return {ProfileEnd, 0, 0};
+	}
+
+private:
+	static bool debug_Start;
+	static bool debug_enterStep;
+
+	static bool isRunning;
+	static const ProfileStep* steps;
+	static uint8_t stepCount;
+	static uint8_t currentStep;
+	static uint32_t millisValueAtLastUpdate;
+	static uint32_t millisElapsedInStep;
+	static float setPointDegCent;
+	static float stepStartSetPointDegCent;
+	static std::array<int16_t, MAX_PROFILE_STEPS> repeatsDone;
+
+	static bool isProfileValid(const ProfileStep* Steps, uint8_t StepCount);
+	static bool updateCurrentStep();
+	static void enterStep(uint8_t Step);
+	static void enableDebugTriggers();
+};
+
+#endif //ENGINEERING_PROJECT_PROFILE_ENGINE_H
@@ -0,0 +1,286 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "TemperatureEstimator.h"
+
+#include "IO/Temperature.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+// Model of the heater, taken from the closed loop benchmark's thermal plant. Rates are in °C per second.
+#define FULL_POWER_HEATING_RATE_DEG_PER_S   0.05
+#define HEAT_LOSS_RATE_PER_S                0.0016      // Per °C above ambient.
+#define HEATING_RATE_TIME_CONSTANT_S        40.0        // How long the element takes to pass a change in power on to the air.
+#define SENSOR_TIME_CONSTANT_S              5.0
+
+// Noise, as variances. The measurement noise is per reading, and the process noise builds up per second, so the gain
+// suits whatever interval the readings are taken at. Raising the process noise makes the estimate follow the readings
+// more closely.
+#define MEASUREMENT_NOISE_VARIANCE                  0.0025      // A standard deviation of 0.05°C.
+#define AIR_TEMPERATURE_PROCESS_NOISE_PER_S         1.0e-5
+#define AIR_TEMPERATURE_RATE_PROCESS_NOISE_PER_S    1.0e-6
+#define SENSOR_TEMPERATURE_PROCESS_NOISE_PER_S      1.0e-5
+
+#define TIME_STEP_S                         (TEMPERATURE_READING_INTERVAL_MS / 1000.0)
+#define RICCATI_ITERATIONS                  1000        // The gain has settled to double precision well before this.
+#define MAX_PREDICTION_STEPS                50          // Longer gaps between readings restart the estimate from the next reading.
+
+
+bool TemperatureEstimator::debug_AddReading = false;
+
+bool TemperatureEstimator::hasFirstReading = false;
+bool TemperatureEstimator::isFanSpinning = false;
+uint32_t TemperatureEstimator::millisValueAtLastReading = 0;
+float TemperatureEstimator::heaterPowerFraction = 0.0;
+float TemperatureEstimator::ambientTemperatureDegCent = 0.0;
+std::array<float, 3> TemperatureEstimator::state = {};
+
+
+/**
+ * @brief                             Initialises the Temperature Estimator. The estimate starts from the first reading.
+ *
+ * @param  AmbientTemperatureDegCent  The temperature the air loses heat to.
+*/
+void TemperatureEstimator::Init(const float AmbientTemperatureDegCent)
+{
+	enableDebugTriggers();
+
+	ambientTemperatureDegCent = AmbientTemperatureDegCent;
+	hasFirstReading = false;
+}
+
+/**
+ * @brief                              Moves the estimate forward to the reading's timestamp, then corrects it with the reading.
+ *
+ * @param  MeasuredTemperatureDegCent  The temperature measured by the thermistor.
+ * @param  TimestampMs                 The millis() value when the reading was completed.
+*/
+void TemperatureEstimator::AddReading(const float MeasuredTemperatureDegCent, const uint32_t TimestampMs)
+{
+	const uint32_t stepsSinceLastReading = (TimestampMs - millisValueAtLastReading + (TEMPERATURE_READING_INTERVAL_MS / 2)) / TEMPERATURE_READING_INTERVAL_MS;
+	millisValueAtLastReading = TimestampMs;
+
+	if (!hasFirstReading || (stepsSinceLastReading > MAX_PREDICTION_STEPS))
+	{
+		state = {MeasuredTemperatureDegCent, 0.0f, MeasuredTemperatureDegCent};
+		hasFirstReading = true;
+		return;
+	}
+
+	for (uint32_t i = 0; i < stepsSinceLastReading; ++i)
+	{
+		predict();
+	}
+	correct(MeasuredTemperatureDegCent);
+
+	if (debug_AddReading)
+	{
+		std::string estimateMsg = Utils::StringFormat("Measured %0.2f°C, estimated %0.2f°C changing at %0.3f°C/min",
+		                                              MeasuredTemperatureDegCent, state[AirTemperature], state[AirTemperatureRate] * 60);
+		SerialHandler::SafeWriteLn(estimateMsg, true);
+	}
+}
+
+/**
+ * @brief                     Provides the Estimator with the heater's power level, which drives the model's heating rate.
+ *
+ * @param  PowerLevelPercent  The heater's power level, from 0 to 100.
+*/
+void TemperatureEstimator::SetHeaterPowerLevel(const float PowerLevelPercent)
+{
+	heaterPowerFraction = PowerLevelPercent / 100;
+}
+
+/**
+ * @brief       Provides the Estimator with the fan's speed. The heater only receives power while the fan is spinning.
+ *
+ * @param  Rpm  The fan's speed in RPM. Should be 0 if the fan isn't spinning.
+*/
+void TemperatureEstimator::SetFanRpm(const uint32_t Rpm)
+{
+	isFanSpinning = (Rpm > 0);
+}
+
+/**
+ * @brief                             Changes the temperature the model loses heat to.
+ *
+ * @param  AmbientTemperatureDegCent  The new ambient temperature.
+*/
+void TemperatureEstimator::SetAmbientTemperature(const float AmbientTemperatureDegCent)
+{
+	ambientTemperatureDegCent = AmbientTemperatureDegCent;
+}
+
+/**
+ * @brief   Gets the estimated air temperature.
+ *
+ * @return  The estimated air temperature in °C.
+*/
+float TemperatureEstimator::GetTemperature()
+{
+	return state[AirTemperature];
+}
+
+/**
+ * @brief   Gets the estimated rate the air temperature is changing at.
+ *
+ * @return  The estimated rate in °C per second.
+*/
+float TemperatureEstimator::GetRatePerSecond()
+{
+	return state[AirTemperatureRate];
+}
+
+/**
+ * @brief  Moves the state forward by one reading interval, using the model and the latest heater and fan inputs.
+*/
+void TemperatureEstimator::predict()
+{
+	constexpr float rateBlend = TIME_STEP_S / HEATING_RATE_TIME_CONSTANT_S;
+	constexpr float sensorBlend = TIME_STEP_S / SENSOR_TIME_CONSTANT_S;
+
+	const float heatingRate = isFanSpinning ? (heaterPowerFraction * static_cast<float>(FULL_POWER_HEATING_RATE_DEG_PER_S)) : 0.0f;
+	const float heatLossRate = static_cast<float>(HEAT_LOSS_RATE_PER_S) * (state[AirTemperature] - ambientTemperatureDegCent);
+	const float targetRate = heatingRate - heatLossRate;
+
+	const float previousAirTemperature = state[AirTemperature];
+	state[AirTemperature] += state[AirTemperatureRate] * static_cast<float>(TIME_STEP_S);
+	state[AirTemperatureRate] += (targetRate - state[AirTemperatureRate]) * rateBlend;
+	state[SensorTemperature] += (previousAirTemperature - state[SensorTemperature]) * sensorBlend;
+}
+
+/**
+ * @brief                              Pulls the state towards the reading, by the steady state Kalman gain.
+ *
+ * @param  MeasuredTemperatureDegCent  The temperature measured by the thermistor.
+*/
+void TemperatureEstimator::correct(const float MeasuredTemperatureDegCent)
+{
+	const float innovation = MeasuredTemperatureDegCent - state[SensorTemperature];
+	for (uint8_t i = 0; i < state.size(); ++i)
+	{
+		state[i] += kalmanGain[i] * innovation;
+	}
+}
+
+/**
+ * @brief   Builds the model's state transition matrix for one reading interval.
+ *
+ * @return  The state transition matrix. The heater and ambient inputs don't depend on the state, so they aren't part of it.
+*/
+constexpr TemperatureEstimator::matrix3 TemperatureEstimator::getStateTransitionMatrix()
+{
+	constexpr double rateBlend = TIME_STEP_S / HEATING_RATE_TIME_CONSTANT_S;
+	constexpr double sensorBlend = TIME_STEP_S / SENSOR_TIME_CONSTANT_S;
+
+	matrix3 stateTransition = {};
+	stateTransition[AirTemperature] = {1.0, TIME_STEP_S, 0.0};
+	stateTransition[AirTemperatureRate] = {-rateBlend * HEAT_LOSS_RATE_PER_S, 1.0 - rateBlend, 0.0};
+	stateTransition[SensorTemperature] = {sensorBlend, 0.0, 1.0 - sensorBlend};
+	return stateTransition;
+}
+
+/**
+ * @brief     Multiplies two 3x3 matrices.
+ *
+ * @param  A  The left matrix.
+ * @param  B  The right matrix.
+ *
+ * @return    A * B.
+*/
+constexpr TemperatureEstimator::matrix3 TemperatureEstimator::multiply(const matrix3& A, const matrix3& B)
+{
+	matrix3 product = {};
+	for (uint8_t row = 0; row < 3; ++row)
+	{
+		for (uint8_t column = 0; column < 3; ++column)
+		{
+			for (uint8_t i = 0; i < 3; ++i)
+			{
+				product[row][column] += A[row][i] * B[i][column];
+			}
+		}
+	}
+	return product;
+}
+
+/**
+ * @brief     Transposes a 3x3 matrix.
+ *
+ * @param  A  The matrix to transpose.
+ *
+ * @return    The transpose of A.
+*/
+constexpr TemperatureEstimator::matrix3 TemperatureEstimator::transpose(const matrix3& A)
+{
+	matrix3 transposed = {};
+	for (uint8_t row = 0; row < 3; ++row)
+	{
+		for (uint8_t column = 0; column < 3; ++column)
+		{
+			transposed[row][column] = A[column][row];
+		}
+	}
+	return transposed;
+}
+
+/**
+ * @brief   Runs the Kalman filter's covariance update, one TEMPERATURE_READING_INTERVAL_MS step at a time, until it
+ *          settles, and returns the gain it settles at.
+ *
+ * @return  The Kalman gain applied to the measurement error, for each state.
+*/
+constexpr std::array<float, 3> TemperatureEstimator::calculateSteadyStateGain()
+{
+	const matrix3 stateTransition = getStateTransitionMatrix();
+	const matrix3 stateTransitionTransposed = transpose(stateTransition);
+
+	matrix3 covariance = {};
+	std::array<double, 3> gain = {};
+	for (uint32_t iteration = 0; iteration < RICCATI_ITERATIONS; ++iteration)
+	{
+		covariance = multiply(multiply(stateTransition, covariance), stateTransitionTransposed);
+		covariance[AirTemperature][AirTemperature] += AIR_TEMPERATURE_PROCESS_NOISE_PER_S * TIME_STEP_S;
+		covariance[AirTemperatureRate][AirTemperatureRate] += AIR_TEMPERATURE_RATE_PROCESS_NOISE_PER_S * TIME_STEP_S;
+		covariance[SensorTemperature][SensorTemperature] += SENSOR_TEMPERATURE_PROCESS_NOISE_PER_S * TIME_STEP_S;
+
+		// Only the sensor temperature is measured, so the gain is its column of the covariance, scaled.
+		const double innovationVariance = covariance[SensorTemperature][SensorTemperature] + MEASUREMENT_NOISE_VARIANCE;
+		for (uint8_t i = 0; i < 3; ++i)
+		{
+			gain[i] = covariance[i][SensorTemperature] / innovationVariance;
+		}
+
+		matrix3 correctedCovariance = covariance;
+		for (uint8_t row = 0; row < 3; ++row)
+		{
+			for (uint8_t column = 0; column < 3; ++column)
+			{
+				correctedCovariance[row][column] -= gain[row] * covariance[SensorTemperature][column];
+			}
+		}
+		covariance = correctedCovariance;
+	}
+
+	return {static_cast<float>(gain[AirTemperature]), static_cast<float>(gain[AirTemperatureRate]), static_cast<float>(gain[SensorTemperature])};
+}
+
+// Defined after the functions that calculate it, so that it can be worked out at compile time.
+constexpr std::array<float, 3> TemperatureEstimator::kalmanGain = TemperatureEstimator::calculateSteadyStateGain();
+
+/**
+ * @brief  Sets which debug messages will be written to the Serial port.
+*/
+void TemperatureEstimator::enableDebugTriggers()
+{
+//	debug_AddReading = true;
+}
@@ -0,0 +1,70 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_TEMPERATURE_ESTIMATOR_H
+#define ENGINEERING_PROJECT_TEMPERATURE_ESTIMATOR_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief  Kalman filter that estimates the air temperature and its rate of change from the thermistor readings, the
+ *         heater's power level and whether the fan is moving the heat into the air.
+ *
+ * The model has three states: the air temperature, the rate it is changing at, and the thermistor's temperature. The
+ * rate relaxes towards the heating rate the power level would give, minus the heat lost to ambient. The thermistor lags
+ * behind the air, and it's the only state that is measured, so the estimate of the air temperature runs ahead of the
+ * raw readings instead of behind them.
+ *
+ * Readings arrive at a fixed interval, so the filter's gain converges to a constant. It is calculated at compile time
+ * for TEMPERATURE_READING_INTERVAL_MS, which leaves a handful of multiply-adds to do per reading.
+*/
+class TemperatureEstimator
+{
+public:
+	static void Init(float AmbientTemperatureDegCent);
+	static void AddReading(float MeasuredTemperatureDegCent, uint32_t TimestampMs);
+	static void SetHeaterPowerLevel(float PowerLevelPercent);
+	static void SetFanRpm(uint32_t Rpm);
+	static void SetAmbientTemperature(float AmbientTemperatureDegCent);
+	static float GetTemperature();
+	static float GetRatePerSecond();
+
+private:
+	typedef std::array<std::array<double, 3>, 3> matrix3;
+
+	enum states
+	{
+		AirTemperature,
+		AirTemperatureRate,
+		SensorTemperature
+	};
+
+	static bool debug_AddReading;
+
+	static bool hasFirstReading;
+	static bool isFanSpinning;
+	static uint32_t millisValueAtLastReading;
+	static float heaterPowerFraction;
+	static float ambientTemperatureDegCent;
+	static std::array<float, 3> state;
+	static const std::array<float, 3> kalmanGain;
+
+	static void predict();
+	static void correct(float MeasuredTemperatureDegCent);
+	static void enableDebugTriggers();
+
+	static constexpr matrix3 getStateTransitionMatrix();
+	static constexpr matrix3 multiply(const matrix3& A, const matrix3& B);
+	static constexpr matrix3 transpose(const matrix3& A);
+	static constexpr std::array<float, 3> calculateSteadyStateGain();
+};
+
+#endif //ENGINEERING_PROJECT_TEMPERATURE_ESTIMATOR_H
@@ -20,6 +20,7 @@
 #include "Display/Screens/StatusAkaMain.h"
 #include "Display/Screens/ConfigPIDControlPart1.h"
 #include "Display/Screens/ConfigPIDControlPart2.h"
+#include "Display/Screens/ConfigPIDControlPart3.h"
 #include "Misc/SerialHandler.h"
 #include "Misc/Utils.h"
 #include "Backlight.h"
@@ -83,6 +84,7 @@ void Display::Init(float TargetTemperature, PIDControllerInitData ConfigData)
 	StatusAkaMain::Init(lv_screen_active(), &buttonLabelTextStyle, TargetTemperature);
 	ConfigPIDControlPart1::Init(lv_screen_active(), &buttonLabelTextStyle, ConfigData);
 	ConfigPIDControlPart2::Init(lv_screen_active(), &buttonLabelTextStyle, ConfigData);
+	ConfigPIDControlPart3::Init(lv_screen_active(), &buttonLabelTextStyle, ConfigData);
 	StatusAkaMain::Show();
 	currentScreen = Screens::StatusAkaMain;
 }
@@ -100,11 +102,9 @@ void Display::Update()
 }
 
 /**
- * @brief                        Polls all config screens for any changes to float settings.
- *
- * @param  ChangedFloatSettings  Vector containing all the changed float settings.
+ * @brief  Posts any settings changed in the config screens to the settings mailbox, once the user has left the options menu.
 */
-void Display::GetAllChangedFloatSettings(std::vector<PIDFloatDataPacket>* ChangedFloatSettings)
+void Display::PostChangedSettings()
 {
 	if (currentScreen != StatusAkaMain)
 	{
@@ -112,24 +112,53 @@ void Display::GetAllChangedFloatSettings(std::vector<PIDFloatDataPacket>* Change
 		return;
 	}
 
-	ConfigPIDControlPart1::GetAllChangedFloatSettings(ChangedFloatSettings);
-	ConfigPIDControlPart2::GetAllChangedFloatSettings(ChangedFloatSettings);
+	ConfigPIDControlPart1::PostChangedSettings();
+	ConfigPIDControlPart2::PostChangedSettings();
+	ConfigPIDControlPart3::PostChangedSettings();
+}
+
+/**
+ * @brief                   Updates the config screens with a setting that was changed outside of them.
+ *
+ * @param  NewFloatSetting  The new float setting.
+*/
+void Display::SetFloatSetting(const PIDFloatDataPacket& NewFloatSetting)
+{
+	ConfigPIDControlPart1::SetFloatSetting(NewFloatSetting);
+	ConfigPIDControlPart2::SetFloatSetting(NewFloatSetting);
+	ConfigPIDControlPart3::SetFloatSetting(NewFloatSetting);
 }
 
 /**
- * @brief                      Polls all config screens for any changes to integer settings.
+ * @brief    Checks if the user has asked for the PID gains to be auto-tuned.
  *
- * @param  ChangedIntSettings  Vector containing all the changed integer settings.
+ * @returns  True if an auto-tune was requested. False otherwise.
 */
-void Display::GetAllChangedIntSettings(std::vector<PIDIntDataPacket>* ChangedIntSettings)
+bool Display::HasAutoTuneBeenRequested()
 {
 	if (currentScreen != StatusAkaMain)
 	{
-		// Don't send updated settings while in the options menu.
-		return;
+		// Don't start tuning until the user has left the options menu.
+		return false;
 	}
 
-	ConfigPIDControlPart1::GetAllChangedIntSettings(ChangedIntSettings);
+	return ConfigPIDControlPart2::HasAutoTuneBeenRequested();
+}
+
+/**
+ * @brief    Checks if the user has asked for the set point profile to be run.
+ *
+ * @returns  True if a profile run was requested. False otherwise.
+*/
+bool Display::HasProfileRunBeenRequested()
+{
+	if (currentScreen != StatusAkaMain)
+	{
+		// Don't start the profile until the user has left the options menu.
+		return false;
+	}
+
+	return ConfigPIDControlPart3::HasProfileRunBeenRequested();
 }
 
 /**
@@ -179,6 +208,12 @@ void Display::checkForScreenSwitchRequired()
 			checkIfSwitchRequiredOnCurrentScreen(ConfigPIDControlPart2::IsScreenSwitchRequired, ConfigPIDControlPart2::Hide);
 			return;
 		}
+
+		case ConfigPidControlPart3:
+		{
+			checkIfSwitchRequiredOnCurrentScreen(ConfigPIDControlPart3::IsScreenSwitchRequired, ConfigPIDControlPart3::Hide);
+			return;
+		}
 	}
 }
 
@@ -211,6 +246,10 @@ void Display::checkIfSwitchRequiredOnCurrentScreen(Screens (*currentScreenIsSwit
 		case ConfigPidControlPart2:
 			ConfigPIDControlPart2::Show();
 			break;
+
+		case ConfigPidControlPart3:
+			ConfigPIDControlPart3::Show();
+			break;
 	}
 
 	currentScreenHideFunction();
@@ -27,8 +27,10 @@ class Display
 public:
 	static void Init(float TargetTemperature, PIDControllerInitData ConfigData);
 	static void Update();
-	static void GetAllChangedFloatSettings(std::vector<PIDFloatDataPacket>* ChangedFloatSettings);
-	static void GetAllChangedIntSettings(std::vector<PIDIntDataPacket>* ChangedIntSettings);
+	static void PostChangedSettings();
+	static void SetFloatSetting(const PIDFloatDataPacket& NewFloatSetting);
+	static bool HasAutoTuneBeenRequested();
+	static bool HasProfileRunBeenRequested();
 
 private:
 	static bool debug_Update;
@@ -23,21 +23,32 @@ bool ConfigScreenHelpers::debug_incrementSpinboxButtonPressedEventHandler = fals
 
 
 /**
- * @brief                  Create a row in the Config screen with a SpinBox and description.
+ * @brief               Links a SpinBox's struct to a setting, and loads the setting's starting value into it.
  *
- * @param  ParentWidget    The widget this row will be parented to.
- * @param  RowDescription  The description for the row.
- * @param  RowPos          The row in the parent's grid that this row will occupy.
- * @param  RangeMin        The SpinBox's minimum value.
- * @param  RangeMax        The SpinBox's maximum value.
- * @param  SpinboxData     A pointer to the struct that will hold the SpinBox's data.
+ * @param  SpinboxData  A pointer to the struct that will hold the SpinBox's data.
+ * @param  Setting      The setting the SpinBox will change. Must be of the same type as the SpinBox.
+ * @param  ConfigData   A struct containing the PID Controller's settings.
 */
-void ConfigScreenHelpers::CreateSettingRow(
-		lv_obj_t* ParentWidget, const char* RowDescription, const int32_t RowPos, const int32_t RangeMin, const int32_t RangeMax, SpinboxData* SpinboxData
-)
+void ConfigScreenHelpers::InitSpinboxData(SpinboxData* SpinboxData, const PIDSettings Setting, const PIDControllerInitData& ConfigData)
 {
+	SpinboxData->Setting = Setting;
+	SpinboxData->SetCurrentValueWithConfigData(ConfigData);
+}
+
+/**
+ * @brief                Create a row in the Config screen with a SpinBox and description. The description and
+ *                       SpinBox range are taken from the settings schema.
+ *
+ * @param  ParentWidget  The widget this row will be parented to.
+ * @param  RowPos        The row in the parent's grid that this row will occupy.
+ * @param  SpinboxData   A pointer to the struct that will hold the SpinBox's data. Must already be initialised.
+*/
+void ConfigScreenHelpers::CreateSettingRow(lv_obj_t* ParentWidget, const int32_t RowPos, SpinboxData* SpinboxData)
+{
+	const PIDSettingSchema& schema = GetPIDSettingSchema(SpinboxData->Setting);
+
 	std::ignore = LvglHelpers::CreateTextLabel(
-			ParentWidget, RowDescription, true, LV_GRID_ALIGN_START, 0, 1, RowPos, 1
+			ParentWidget, schema.RowDescription, true, LV_GRID_ALIGN_START, 0, 1, RowPos, 1
 	);
 
 	std::ignore = LvglHelpers::CreateTextLabelButton(
@@ -48,7 +59,7 @@ void ConfigScreenHelpers::CreateSettingRow(
 	);
 
 	SpinboxData->Spinbox = lv_spinbox_create(ParentWidget);
-	lv_spinbox_set_range(SpinboxData->Spinbox, RangeMin, RangeMax);
+	lv_spinbox_set_range(SpinboxData->Spinbox, schema.SpinboxRangeMin, schema.SpinboxRangeMax);
 	lv_spinbox_set_value(SpinboxData->Spinbox, SpinboxData->GetCurrentValueAsInt());
 	lv_spinbox_set_digit_format(SpinboxData->Spinbox, spinboxDigitCount, SpinboxData->GetDecimalPos());
 	lv_obj_set_size(SpinboxData->Spinbox, 75, 26);
@@ -66,6 +77,25 @@ void ConfigScreenHelpers::CreateSettingRow(
 	);
 }
 
+/**
+ * @brief               Posts the SpinBox's value to the settings mailbox, if it has been changed since it was last posted.
+ *
+ * @param  SpinboxData  The struct which contains the SpinBox's data.
+*/
+void ConfigScreenHelpers::PostSettingIfChanged(SpinboxData* SpinboxData)
+{
+	if (!SpinboxData->HasValueBeenChangedSinceLastCheck)
+	{
+		return;
+	}
+
+	// If the mailbox is full, the setting stays marked as changed and is posted again next time.
+	if (SpinboxData->PushToSettingsMailbox())
+	{
+		SpinboxData->HasValueBeenChangedSinceLastCheck = false;
+	}
+}
+
 /**
  * @brief         Event handler function that is triggered when a SpinBox's decrement value button is pressed.
  *
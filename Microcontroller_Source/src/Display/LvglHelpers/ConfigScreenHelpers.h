@@ -16,6 +16,10 @@
 
 #include "lvgl.h"
 
+#include "InitDataTypes/PIDControllerData.h"
+#include "InitDataTypes/PIDSettingsSchema.h"
+#include "Misc/SettingsMailbox.h"
+
 /**
  * @brief  Contains various helper functions for setting up the Config screens.
 */
@@ -32,6 +36,7 @@ public:
 	struct SpinboxData
 	{
 		bool HasValueBeenChangedSinceLastCheck = false;
+		PIDSettings Setting = TemperatureSetPoint;
 		lv_obj_t* Spinbox = nullptr;
 
 		virtual int32_t GetCurrentValueAsInt()
@@ -46,6 +51,14 @@ public:
 
 		virtual void SetCurrentValueWithInt(int32_t NewValue)
 		{}
+
+		virtual void SetCurrentValueWithConfigData(const PIDControllerInitData& ConfigData)
+		{}
+
+		virtual bool PushToSettingsMailbox()
+		{
+			return true;
+		}
 	};
 
 	/**
@@ -64,6 +77,16 @@ public:
 		{
 			CurrentValue = NewValue;
 		}
+
+		void SetCurrentValueWithConfigData(const PIDControllerInitData& ConfigData) final
+		{
+			CurrentValue = ConfigData.*GetPIDSettingSchema(Setting).IntInitData;
+		}
+
+		bool PushToSettingsMailbox() final
+		{
+			return SettingsMailboxes::IntSettings.Push({Setting, CurrentValue});
+		}
 	};
 
 	/**
@@ -88,13 +111,24 @@ public:
 		{
 			CurrentValue = static_cast<float>(NewValue / std::pow(10, (spinboxDigitCount - DecimalPosition)));
 		}
+
+		void SetCurrentValueWithConfigData(const PIDControllerInitData& ConfigData) final
+		{
+			const PIDSettingSchema& schema = GetPIDSettingSchema(Setting);
+			CurrentValue = ConfigData.*schema.FloatInitData;
+			DecimalPosition = schema.SpinboxDecimalPosition;
+		}
+
+		bool PushToSettingsMailbox() final
+		{
+			return SettingsMailboxes::FloatSettings.Push({Setting, CurrentValue});
+		}
 	};
 
 
-	static void CreateSettingRow(
-			lv_obj_t* ParentWidget, const char* RowDescription, int32_t RowPos,
-			int32_t RangeMin, int32_t RangeMax, SpinboxData* FloatSpinbox
-	);
+	static void InitSpinboxData(SpinboxData* SpinboxData, PIDSettings Setting, const PIDControllerInitData& ConfigData);
+	static void CreateSettingRow(lv_obj_t* ParentWidget, int32_t RowPos, SpinboxData* SpinboxData);
+	static void PostSettingIfChanged(SpinboxData* SpinboxData);
 
 
 private:
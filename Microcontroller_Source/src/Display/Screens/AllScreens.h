@@ -20,6 +20,7 @@ enum Screens
 	StatusAkaMain,
 	ConfigPidControlPart1,
 	ConfigPidControlPart2,
+	ConfigPidControlPart3,
 };
 
 #endif //ENGINEERING_PROJECT_ALLSCREENS_H
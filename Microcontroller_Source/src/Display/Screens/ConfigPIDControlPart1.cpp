@@ -60,15 +60,11 @@ void ConfigPIDControlPart1::Init(lv_obj_t* TargetScreen, lv_style_t* ButtonLabel
 	);
 	Hide();
 
-	loopTimeStep.CurrentValue = ConfigData.LoopTimeStepMs;
-	proportionalGain.CurrentValue = ConfigData.ProportionalGain;
-	proportionalGain.DecimalPosition = 2;
-	integralGain.CurrentValue = ConfigData.IntegralGain;
-	integralGain.DecimalPosition = 2;
-	integralWindupLimitMax.CurrentValue = ConfigData.IntegralWindupLimitMax;
-	integralWindupLimitMax.DecimalPosition = 3;
-	integralWindupLimitMin.CurrentValue = ConfigData.IntegralWindupLimitMin;
-	integralWindupLimitMin.DecimalPosition = 3;
+	ConfigScreenHelpers::InitSpinboxData(&loopTimeStep, LoopTimeStep, ConfigData);
+	ConfigScreenHelpers::InitSpinboxData(&proportionalGain, ProportionalGain, ConfigData);
+	ConfigScreenHelpers::InitSpinboxData(&integralGain, IntegralGain, ConfigData);
+	ConfigScreenHelpers::InitSpinboxData(&integralWindupLimitMax, IntegralWindupLimitMax, ConfigData);
+	ConfigScreenHelpers::InitSpinboxData(&integralWindupLimitMin, IntegralWindupLimitMin, ConfigData);
 
 	const int32_t widgetsContainerWidth = screenWidth - rootScreenContainerColumns[0] - rootScreenContainerColumns.rbegin()[1];
 
@@ -112,46 +108,49 @@ void ConfigPIDControlPart1::Show()
 }
 
 /**
- * @brief                        Fetches any float settings that have been changed since the last time this function was invoked.
- *
- * @param  ChangedFloatSettings  A Vector that the changed float settings will be added to.
+ * @brief  Posts any settings that have been changed since the last time this function was invoked to the settings mailbox.
 */
-void ConfigPIDControlPart1::GetAllChangedFloatSettings(std::vector<PIDFloatDataPacket>* ChangedFloatSettings)
+void ConfigPIDControlPart1::PostChangedSettings()
 {
-	if (proportionalGain.HasValueBeenChangedSinceLastCheck)
-	{
-		proportionalGain.HasValueBeenChangedSinceLastCheck = false;
-		ChangedFloatSettings->push_back({ProportionalGain, proportionalGain.CurrentValue});
-	}
-	if (integralGain.HasValueBeenChangedSinceLastCheck)
-	{
-		integralGain.HasValueBeenChangedSinceLastCheck = false;
-		ChangedFloatSettings->push_back({IntegralGain, integralGain.CurrentValue});
-	}
-	if (integralWindupLimitMax.HasValueBeenChangedSinceLastCheck)
-	{
-		integralWindupLimitMax.HasValueBeenChangedSinceLastCheck = false;
-		ChangedFloatSettings->push_back({IntegralWindupLimitMax, integralWindupLimitMax.CurrentValue});
-	}
-	if (integralWindupLimitMin.HasValueBeenChangedSinceLastCheck)
-	{
-		integralWindupLimitMin.HasValueBeenChangedSinceLastCheck = false;
-		ChangedFloatSettings->push_back({IntegralWindupLimitMin, integralWindupLimitMin.CurrentValue});
-	}
+	ConfigScreenHelpers::PostSettingIfChanged(&loopTimeStep);
+	ConfigScreenHelpers::PostSettingIfChanged(&proportionalGain);
+	ConfigScreenHelpers::PostSettingIfChanged(&integralGain);
+	ConfigScreenHelpers::PostSettingIfChanged(&integralWindupLimitMax);
+	ConfigScreenHelpers::PostSettingIfChanged(&integralWindupLimitMin);
 }
 
 /**
- * @brief                        Fetches any integer settings that have been changed since the last time this function was invoked.
+ * @brief                   Puts a setting that was changed elsewhere (e.g. by the Auto Tuner) into this screen's SpinBox.
  *
- * @param  ChangedFloatSettings  A Vector that the changed integer settings will be added to.
+ * @param  NewFloatSetting  The new float setting. Settings not shown on this screen are ignored.
 */
-void ConfigPIDControlPart1::GetAllChangedIntSettings(std::vector<PIDIntDataPacket>* ChangedIntSettings)
+void ConfigPIDControlPart1::SetFloatSetting(const PIDFloatDataPacket& NewFloatSetting)
 {
-	if (loopTimeStep.HasValueBeenChangedSinceLastCheck)
+	ConfigScreenHelpers::FloatSpinboxData* spinboxData;
+	switch (NewFloatSetting.Setting)
 	{
-		loopTimeStep.HasValueBeenChangedSinceLastCheck = false;
-		ChangedIntSettings->push_back({LoopTimeStep, loopTimeStep.CurrentValue});
+		case ProportionalGain:
+			spinboxData = &proportionalGain;
+			break;
+
+		case IntegralGain:
+			spinboxData = &integralGain;
+			break;
+
+		case IntegralWindupLimitMax:
+			spinboxData = &integralWindupLimitMax;
+			break;
+
+		case IntegralWindupLimitMin:
+			spinboxData = &integralWindupLimitMin;
+			break;
+
+		default:
+			return;
 	}
+
+	spinboxData->CurrentValue = NewFloatSetting.Value;
+	lv_spinbox_set_value(spinboxData->Spinbox, spinboxData->GetCurrentValueAsInt());
 }
 
 /**
@@ -167,26 +166,11 @@ void ConfigPIDControlPart1::settingsConfigBuilder(const int32_t WidgetsContainer
 			true, 1, 3, 1, 1
 	);
 
-	ConfigScreenHelpers::CreateSettingRow(
-			settingsWidgetsContainer, "Loop Time\nStep (ms):", 0,
-			1, 10000, &loopTimeStep
-	);
-	ConfigScreenHelpers::CreateSettingRow(
-			settingsWidgetsContainer, "Proportion.\nGain:", 1,
-			0, 10000, &proportionalGain
-	);
-	ConfigScreenHelpers::CreateSettingRow(
-			settingsWidgetsContainer, "Integral\nGain:", 2,
-			0, 10000, &integralGain
-	);
-	ConfigScreenHelpers::CreateSettingRow(
-			settingsWidgetsContainer, "Int. Wind.\nLimit Max:", 3,
-			-10000, 10000, &integralWindupLimitMax
-	);
-	ConfigScreenHelpers::CreateSettingRow(
-			settingsWidgetsContainer, "Int. Wind.\nLimit Min:", 4,
-			-10000, 10000, &integralWindupLimitMin
-	);
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 0, &loopTimeStep);
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 1, &proportionalGain);
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 2, &integralGain);
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 3, &integralWindupLimitMax);
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 4, &integralWindupLimitMin);
 }
 
 /**
@@ -241,7 +225,7 @@ void ConfigPIDControlPart1::navigationButtonsBuilder(lv_style_t* ButtonLabelText
 void ConfigPIDControlPart1::toPreviousConfigScreenButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event)
 {
 	screenSwitchRequired = true;
-	desiredScreen = Screens::ConfigPidControlPart2;
+	desiredScreen = Screens::ConfigPidControlPart3;
 	resetAllCursorPositions();
 }
 
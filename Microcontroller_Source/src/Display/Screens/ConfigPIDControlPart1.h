@@ -14,7 +14,6 @@
 #include <lvgl.h>
 #include <array>
 #include <cmath>
-#include <vector>
 
 #include "Display/LvglHelpers/ConfigScreenHelpers.h"
 #include "Display/Screens/AllScreens.h"
@@ -30,8 +29,8 @@ public:
 	static Screens IsScreenSwitchRequired();
 	static void Hide();
 	static void Show();
-	static void GetAllChangedFloatSettings(std::vector<PIDFloatDataPacket>* ChangedFloatSettings);
-	static void GetAllChangedIntSettings(std::vector<PIDIntDataPacket>* ChangedIntSettings);
+	static void PostChangedSettings();
+	static void SetFloatSetting(const PIDFloatDataPacket& NewFloatSetting);
 
 private:
 	static bool screenSwitchRequired;
@@ -21,6 +21,7 @@
 #include "Misc/Utils.h"
 
 
+bool ConfigPIDControlPart2::autoTuneRequested = false;
 bool ConfigPIDControlPart2::screenSwitchRequired = false;
 Screens ConfigPIDControlPart2::desiredScreen = Screens::Invalid;
 
@@ -58,14 +59,10 @@ void ConfigPIDControlPart2::Init(lv_obj_t* TargetScreen, lv_style_t* ButtonLabel
 	);
 	Hide();
 
-	derivativeGain.CurrentValue = ConfigData.DerivativeGain;
-	derivativeGain.DecimalPosition = 2;
-	derivativeTermLimitMax.CurrentValue = ConfigData.DerivativeTermMaxValue;
-	derivativeTermLimitMax.DecimalPosition = 3;
-	derivativeTermLimitMin.CurrentValue = ConfigData.DerivativeTermMinValue;
-	derivativeTermLimitMin.DecimalPosition = 3;
-	outputMax.CurrentValue = ConfigData.OutputMaxValue;
-	outputMax.DecimalPosition = 3;
+	ConfigScreenHelpers::InitSpinboxData(&derivativeGain, DerivativeGain, ConfigData);
+	ConfigScreenHelpers::InitSpinboxData(&derivativeTermLimitMax, DerivativeTermMaxValue, ConfigData);
+	ConfigScreenHelpers::InitSpinboxData(&derivativeTermLimitMin, DerivativeTermMinValue, ConfigData);
+	ConfigScreenHelpers::InitSpinboxData(&outputMax, OutputMaxValue, ConfigData);
 
 	const int32_t widgetsContainerWidth = screenWidth - rootScreenContainerColumns[0] - rootScreenContainerColumns.rbegin()[1];
 
@@ -109,32 +106,64 @@ void ConfigPIDControlPart2::Show()
 }
 
 /**
- * @brief                        Fetches any float settings that have been changed since the last time this function was invoked.
+ * @brief  Posts any settings that have been changed since the last time this function was invoked to the settings mailbox.
+*/
+void ConfigPIDControlPart2::PostChangedSettings()
+{
+	ConfigScreenHelpers::PostSettingIfChanged(&derivativeGain);
+	ConfigScreenHelpers::PostSettingIfChanged(&derivativeTermLimitMax);
+	ConfigScreenHelpers::PostSettingIfChanged(&derivativeTermLimitMin);
+	ConfigScreenHelpers::PostSettingIfChanged(&outputMax);
+}
+
+/**
+ * @brief                   Puts a setting that was changed elsewhere (e.g. by the Auto Tuner) into this screen's SpinBox.
  *
- * @param  ChangedFloatSettings  A Vector that the changed float settings will be added to.
+ * @param  NewFloatSetting  The new float setting. Settings not shown on this screen are ignored.
 */
-void ConfigPIDControlPart2::GetAllChangedFloatSettings(std::vector<PIDFloatDataPacket>* ChangedFloatSettings)
+void ConfigPIDControlPart2::SetFloatSetting(const PIDFloatDataPacket& NewFloatSetting)
 {
-	if (derivativeGain.HasValueBeenChangedSinceLastCheck)
-	{
-		derivativeGain.HasValueBeenChangedSinceLastCheck = false;
-		ChangedFloatSettings->push_back({DerivativeGain, derivativeGain.CurrentValue});
-	}
-	if (derivativeTermLimitMax.HasValueBeenChangedSinceLastCheck)
-	{
-		derivativeTermLimitMax.HasValueBeenChangedSinceLastCheck = false;
-		ChangedFloatSettings->push_back({DerivativeTermMaxValue, derivativeTermLimitMax.CurrentValue});
-	}
-	if (derivativeTermLimitMin.HasValueBeenChangedSinceLastCheck)
+	ConfigScreenHelpers::FloatSpinboxData* spinboxData;
+	switch (NewFloatSetting.Setting)
 	{
-		derivativeTermLimitMin.HasValueBeenChangedSinceLastCheck = false;
-		ChangedFloatSettings->push_back({DerivativeTermMinValue, derivativeTermLimitMin.CurrentValue});
+		case DerivativeGain:
+			spinboxData = &derivativeGain;
+			break;
+
+		case DerivativeTermMaxValue:
+			spinboxData = &derivativeTermLimitMax;
+			break;
+
+		case DerivativeTermMinValue:
+			spinboxData = &derivativeTermLimitMin;
+			break;
+
+		case OutputMaxValue:
+			spinboxData = &outputMax;
+			break;
+
+		default:
+			return;
 	}
-	if (outputMax.HasValueBeenChangedSinceLastCheck)
+
+	spinboxData->CurrentValue = NewFloatSetting.Value;
+	lv_spinbox_set_value(spinboxData->Spinbox, spinboxData->GetCurrentValueAsInt());
+}
+
+/**
+ * @brief    Checks if the user has pressed the Auto-tune button since the last call to this function.
+ *
+ * @returns  True if the button was pressed. False otherwise.
+*/
+bool ConfigPIDControlPart2::HasAutoTuneBeenRequested()
+{
+	if (autoTuneRequested)
 	{
-		outputMax.HasValueBeenChangedSinceLastCheck = false;
-		ChangedFloatSettings->push_back({OutputMaxValue, outputMax.CurrentValue});
+		autoTuneRequested = false;
+		return true;
 	}
+
+	return false;
 }
 
 /**
@@ -150,21 +179,16 @@ void ConfigPIDControlPart2::settingsConfigBuilder(const int32_t WidgetsContainer
 			true, 1, 3, 1, 1
 	);
 
-	ConfigScreenHelpers::CreateSettingRow(
-			settingsWidgetsContainer, "Derivative\nGain:", 0,
-			0, 10000, &derivativeGain
-	);
-	ConfigScreenHelpers::CreateSettingRow(
-			settingsWidgetsContainer, "Deri. Term.\nLimit Max:", 1,
-			-10000, 10000, &derivativeTermLimitMax
-	);
-	ConfigScreenHelpers::CreateSettingRow(
-			settingsWidgetsContainer, "Deri. Term\nLimit Min:", 2,
-			-10000, 10000, &derivativeTermLimitMin
-	);
-	ConfigScreenHelpers::CreateSettingRow(
-			settingsWidgetsContainer, "Output\nMax:", 3,
-			0, 10000, &outputMax
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 0, &derivativeGain);
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 1, &derivativeTermLimitMax);
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 2, &derivativeTermLimitMin);
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 3, &outputMax);
+
+	std::ignore = LvglHelpers::CreateTextLabelButton(
+			settingsWidgetsContainer, nullptr,
+			autoTuneButtonPressedEventHandler, LV_EVENT_CLICKED, nullptr,
+			150, 30, 0, 4, 4, 1, LV_GRID_ALIGN_CENTER,
+			"Auto-tune", false, false
 	);
 }
 
@@ -244,7 +268,21 @@ void ConfigPIDControlPart2::returnToMainScreenButtonPressedEventHandler(__attrib
 void ConfigPIDControlPart2::toNextConfigScreenButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event)
 {
 	screenSwitchRequired = true;
-	desiredScreen = Screens::ConfigPidControlPart1;
+	desiredScreen = Screens::ConfigPidControlPart3;
+	resetAllCursorPositions();
+}
+
+/**
+ * @brief         Event handler function that is invoked when the "Auto-tune" button is pressed.
+ *
+ * @param  Event  The data passed by the event caller. Unused in this case.
+*/
+void ConfigPIDControlPart2::autoTuneButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event)
+{
+	// Tuning is only started once the user is back on the main screen, where its progress is shown.
+	autoTuneRequested = true;
+	screenSwitchRequired = true;
+	desiredScreen = Screens::StatusAkaMain;
 	resetAllCursorPositions();
 }
 
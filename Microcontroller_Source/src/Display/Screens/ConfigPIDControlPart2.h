@@ -14,7 +14,6 @@
 #include <lvgl.h>
 #include <array>
 #include <cmath>
-#include <vector>
 
 #include "Display/LvglHelpers/ConfigScreenHelpers.h"
 #include "Display/Screens/AllScreens.h"
@@ -30,9 +29,12 @@ public:
 	static Screens IsScreenSwitchRequired();
 	static void Hide();
 	static void Show();
-	static void GetAllChangedFloatSettings(std::vector<PIDFloatDataPacket>* ChangedFloatSettings);
+	static void PostChangedSettings();
+	static void SetFloatSetting(const PIDFloatDataPacket& NewFloatSetting);
+	static bool HasAutoTuneBeenRequested();
 
 private:
+	static bool autoTuneRequested;
 	static bool screenSwitchRequired;
 	static Screens desiredScreen;
 
@@ -53,6 +55,7 @@ private:
 	static void toPreviousConfigScreenButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event);
 	static void returnToMainScreenButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event);
 	static void toNextConfigScreenButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event);
+	static void autoTuneButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event);
 	static void resetAllCursorPositions();
 
 	static void enableDebugTriggers();
@@ -0,0 +1,291 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "modernize-use-auto"
+
+
+#include "ConfigPIDControlPart3.h"
+
+#include <tuple>
+
+#include "Display/LvglHelpers/LvglHelpers.h"
+#include "Misc/Utils.h"
+
+
+bool ConfigPIDControlPart3::profileRunRequested = false;
+bool ConfigPIDControlPart3::screenSwitchRequired = false;
+Screens ConfigPIDControlPart3::desiredScreen = Screens::Invalid;
+
+std::array<int32_t, 6> ConfigPIDControlPart3::rootScreenContainerColumns = {8, LV_GRID_FR(1), LV_GRID_FR(1), LV_GRID_FR(1), 8, LV_GRID_TEMPLATE_LAST};
+std::array<int32_t, 5> ConfigPIDControlPart3::rootScreenContainerRows = {8, LV_GRID_FR(1), LV_GRID_CONTENT, 8, LV_GRID_TEMPLATE_LAST};
+std::array<int32_t, 5> ConfigPIDControlPart3::settingsWidgetsContainerColumns = {LV_GRID_FR(1), LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_TEMPLATE_LAST};
+std::array<int32_t, 6> ConfigPIDControlPart3::settingsWidgetsContainerRows = {LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_TEMPLATE_LAST};
+
+ConfigScreenHelpers::FloatSpinboxData ConfigPIDControlPart3::feedforwardGain = {};
+ConfigScreenHelpers::FloatSpinboxData ConfigPIDControlPart3::ambientTemperature = {};
+
+lv_obj_t* ConfigPIDControlPart3::rootScreenContainer;
+
+
+/**
+ * @brief                        Initialises the Config screen class.
+ *
+ * @param  TargetScreen          The display that this screen will be parented to.
+ * @param  ButtonLabelTextStyle  The style that will be applied to the labels of large buttons.
+ * @param  ConfigData            A struct containing the PID Controller's settings.
+*/
+void ConfigPIDControlPart3::Init(lv_obj_t* TargetScreen, lv_style_t* ButtonLabelTextStyle, PIDControllerInitData ConfigData)
+{
+	enableDebugTriggers();
+
+	const int32_t screenHeight = lv_obj_get_height(TargetScreen);
+	const int32_t screenWidth = lv_obj_get_width(TargetScreen);
+
+	rootScreenContainer = LvglHelpers::CreateWidgetContainer(
+			TargetScreen, LV_OPA_0, 4, true, screenWidth, screenHeight,
+			rootScreenContainerColumns.data(), rootScreenContainerRows.data(),
+			false, 0, 0, 0, 0
+	);
+	Hide();
+
+	ConfigScreenHelpers::InitSpinboxData(&feedforwardGain, FeedforwardGain, ConfigData);
+	ConfigScreenHelpers::InitSpinboxData(&ambientTemperature, AmbientTemperature, ConfigData);
+
+	const int32_t widgetsContainerWidth = screenWidth - rootScreenContainerColumns[0] - rootScreenContainerColumns.rbegin()[1];
+
+	settingsConfigBuilder(widgetsContainerWidth);
+	navigationButtonsBuilder(ButtonLabelTextStyle);
+}
+
+/**
+ * @brief    Used to figure out if the user has requested a switch to a different screen.
+ *
+ * @returns  The screen that needs to be switched to, or Invalid if no switch is required.
+*/
+Screens ConfigPIDControlPart3::IsScreenSwitchRequired()
+{
+	if (!screenSwitchRequired)
+	{
+		return Screens::Invalid;
+	}
+
+	return desiredScreen;
+}
+
+/**
+ * @brief  Hides the screen from view.
+*/
+void ConfigPIDControlPart3::Hide()
+{
+	lv_obj_add_flag(rootScreenContainer, LV_OBJ_FLAG_HIDDEN);
+	screenSwitchRequired = false;
+	desiredScreen = Screens::Invalid;
+}
+
+/**
+ * @brief  Unhides the screen.
+*/
+void ConfigPIDControlPart3::Show()
+{
+	lv_obj_remove_flag(rootScreenContainer, LV_OBJ_FLAG_HIDDEN);
+	screenSwitchRequired = false;
+	desiredScreen = Screens::ConfigPidControlPart3;
+}
+
+/**
+ * @brief  Posts any settings that have been changed since the last time this function was invoked to the settings mailbox.
+*/
+void ConfigPIDControlPart3::PostChangedSettings()
+{
+	ConfigScreenHelpers::PostSettingIfChanged(&feedforwardGain);
+	ConfigScreenHelpers::PostSettingIfChanged(&ambientTemperature);
+}
+
+/**
+ * @brief                   Puts a setting that was changed elsewhere into this screen's SpinBox.
+ *
+ * @param  NewFloatSetting  The new float setting. Settings not shown on this screen are ignored.
+*/
+void ConfigPIDControlPart3::SetFloatSetting(const PIDFloatDataPacket& NewFloatSetting)
+{
+	ConfigScreenHelpers::FloatSpinboxData* spinboxData;
+	switch (NewFloatSetting.Setting)
+	{
+		case FeedforwardGain:
+			spinboxData = &feedforwardGain;
+			break;
+
+		case AmbientTemperature:
+			spinboxData = &ambientTemperature;
+			break;
+
+		default:
+			return;
+	}
+
+	spinboxData->CurrentValue = NewFloatSetting.Value;
+	lv_spinbox_set_value(spinboxData->Spinbox, spinboxData->GetCurrentValueAsInt());
+}
+
+/**
+ * @brief    Checks if the user has pressed the Run profile button since the last call to this function.
+ *
+ * @returns  True if the button was pressed. False otherwise.
+*/
+bool ConfigPIDControlPart3::HasProfileRunBeenRequested()
+{
+	if (profileRunRequested)
+	{
+		profileRunRequested = false;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief                         Creates the widgets in the config screen.
+ *
+ * @param  WidgetsContainerWidth  The width that the widget container needs to be.
+*/
+void ConfigPIDControlPart3::settingsConfigBuilder(const int32_t WidgetsContainerWidth)
+{
+	lv_obj_t* settingsWidgetsContainer = LvglHelpers::CreateWidgetContainer(
+			rootScreenContainer, LV_OPA_100, 6, false, WidgetsContainerWidth, LV_SIZE_CONTENT,
+			settingsWidgetsContainerColumns.data(), settingsWidgetsContainerRows.data(),
+			true, 1, 3, 1, 1
+	);
+
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 0, &feedforwardGain);
+	ConfigScreenHelpers::CreateSettingRow(settingsWidgetsContainer, 1, &ambientTemperature);
+
+	std::ignore = LvglHelpers::CreateTextLabelButton(
+			settingsWidgetsContainer, nullptr,
+			runProfileButtonPressedEventHandler, LV_EVENT_CLICKED, nullptr,
+			150, 30, 0, 4, 2, 1, LV_GRID_ALIGN_CENTER,
+			"Run profile", false, false
+	);
+}
+
+/**
+ * @brief                        Creates the buttons that are used for navigation.
+ *
+ * @param  ButtonLabelTextStyle  The style that will be applied to the labels of large buttons.
+*/
+void ConfigPIDControlPart3::navigationButtonsBuilder(lv_style_t* ButtonLabelTextStyle)
+{
+	lv_obj_t* toPreviousConfigScreenButton = lv_button_create(rootScreenContainer);
+	lv_obj_add_event_cb(toPreviousConfigScreenButton, toPreviousConfigScreenButtonPressedEventHandler, LV_EVENT_CLICKED, nullptr);
+	lv_obj_set_size(toPreviousConfigScreenButton, 60, 60);
+	lv_obj_set_grid_cell(toPreviousConfigScreenButton,
+	                     LV_GRID_ALIGN_CENTER, 1, 1, LV_GRID_ALIGN_CENTER, 2, 1
+	);
+
+	lv_obj_t* toPreviousConfigScreenButtonText = lv_label_create(toPreviousConfigScreenButton);
+	lv_label_set_text(toPreviousConfigScreenButtonText, LV_SYMBOL_PREV);
+	lv_obj_add_style(toPreviousConfigScreenButtonText, ButtonLabelTextStyle, LV_PART_MAIN);
+	lv_obj_align(toPreviousConfigScreenButtonText, LV_ALIGN_CENTER, 0, 0);
+
+	lv_obj_t* returnToMainScreenButton = lv_button_create(rootScreenContainer);
+	lv_obj_add_event_cb(returnToMainScreenButton, returnToMainScreenButtonPressedEventHandler, LV_EVENT_CLICKED, nullptr);
+	lv_obj_set_size(returnToMainScreenButton, 60, 60);
+	lv_obj_set_grid_cell(returnToMainScreenButton,
+	                     LV_GRID_ALIGN_CENTER, 2, 1, LV_GRID_ALIGN_CENTER, 2, 1
+	);
+
+	lv_obj_t* returnToMainScreenButtonText = lv_label_create(returnToMainScreenButton);
+	lv_label_set_text(returnToMainScreenButtonText, LV_SYMBOL_HOME);
+	lv_obj_add_style(returnToMainScreenButtonText, ButtonLabelTextStyle, LV_PART_MAIN);
+	lv_obj_align(returnToMainScreenButtonText, LV_ALIGN_CENTER, 0, 0);
+
+	lv_obj_t* toNextConfigScreenButton = lv_button_create(rootScreenContainer);
+	lv_obj_add_event_cb(toNextConfigScreenButton, toNextConfigScreenButtonPressedEventHandler, LV_EVENT_CLICKED, nullptr);
+	lv_obj_set_size(toNextConfigScreenButton, 60, 60);
+	lv_obj_set_grid_cell(toNextConfigScreenButton,
+	                     LV_GRID_ALIGN_CENTER, 3, 1, LV_GRID_ALIGN_CENTER, 2, 1
+	);
+
+	lv_obj_t* toNextConfigScreenButtonText = lv_label_create(toNextConfigScreenButton);
+	lv_label_set_text(toNextConfigScreenButtonText, LV_SYMBOL_NEXT);
+	lv_obj_add_style(toNextConfigScreenButtonText, ButtonLabelTextStyle, LV_PART_MAIN);
+	lv_obj_align(toNextConfigScreenButtonText, LV_ALIGN_CENTER, 0, 0);
+}
+
+/**
+ * @brief         Event handler function that is invoked when the "previous screen" button is pressed.
+ *
+ * @param  Event  The data passed by the event caller. Unused in this case.
+*/
+void ConfigPIDControlPart3::toPreviousConfigScreenButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event)
+{
+	screenSwitchRequired = true;
+	desiredScreen = Screens::ConfigPidControlPart2;
+	resetAllCursorPositions();
+}
+
+/**
+ * @brief         Event handler function that is invoked when the "return to main screen" button is pressed.
+ *
+ * @param  Event  The data passed by the event caller. Unused in this case.
+*/
+void ConfigPIDControlPart3::returnToMainScreenButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event)
+{
+	screenSwitchRequired = true;
+	desiredScreen = Screens::StatusAkaMain;
+	resetAllCursorPositions();
+}
+
+/**
+ * @brief         Event handler function that is invoked when the "next screen" button is pressed.
+ *
+ * @param  Event  The data passed by the event caller. Unused in this case.
+*/
+void ConfigPIDControlPart3::toNextConfigScreenButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event)
+{
+	screenSwitchRequired = true;
+	desiredScreen = Screens::ConfigPidControlPart1;
+	resetAllCursorPositions();
+}
+
+/**
+ * @brief         Event handler function that is invoked when the "Run profile" button is pressed.
+ *
+ * @param  Event  The data passed by the event caller. Unused in this case.
+*/
+void ConfigPIDControlPart3::runProfileButtonPressedEventHandler(__attribute__((unused)) lv_event_t* Event)
+{
+	// The profile is only started once the user is back on the main screen, where its progress is shown.
+	profileRunRequested = true;
+	screenSwitchRequired = true;
+	desiredScreen = Screens::StatusAkaMain;
+	resetAllCursorPositions();
+}
+
+/**
+ * @brief  Resets the cursor positions of all SpinBoxes.
+*/
+void ConfigPIDControlPart3::resetAllCursorPositions()
+{
+	lv_spinbox_set_cursor_pos(feedforwardGain.Spinbox, 0);
+	lv_spinbox_set_cursor_pos(ambientTemperature.Spinbox, 0);
+}
+
+/**
+ * @brief  Used to instruct given functions to use their debug code.
+ *
+ * @note   Uncomment the booleans that represent the functions you want to debug.
+*/
+void ConfigPIDControlPart3::enableDebugTriggers()
+{
+}
+
+#pragma clang diagnostic pop
\ No newline at end of file
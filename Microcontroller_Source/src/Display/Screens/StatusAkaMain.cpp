@@ -12,6 +12,7 @@
 #include "StatusAkaMain.h"
 
 #include <cstdio>
+#include <cstring>
 #include <tuple>
 #include <Arduino.h>
 
@@ -21,7 +22,10 @@
 
 
 #define DATA_STRING_BUFFER_MAX_SIZE 8
+#define PROFILE_STEP_STRING_BUFFER_MAX_SIZE 24
+#define USAGE_COUNTER_STRING_BUFFER_MAX_SIZE 32
 #define TIME_BETWEEN_ERROR_MESSAGE_UPDATES_MS   (3 * 1000)
+#define USAGE_COUNTER_COUNT 4
 
 
 bool StatusAkaMain::debug_GetTargetTemperatureChangeDesiredByUser = false;
@@ -43,9 +47,12 @@ float StatusAkaMain::targetTemperatureChangeDesiredByUser = 0.0;
 uint8_t StatusAkaMain::allErrorConditionsPresent = NoErrors;
 StatusAkaMain::ErrorMessages StatusAkaMain::currentDisplayedErrorMessage = NoErrors;
 
+uint8_t StatusAkaMain::currentDisplayedUsageCounter = 0;
+UsageMeter::UsageData StatusAkaMain::currentUsage = {};
+
 std::array<int32_t, 5> StatusAkaMain::rootScreenContainerColumns = {8, LV_GRID_FR(1), LV_GRID_FR(1), 8, LV_GRID_TEMPLATE_LAST};
 std::array<int32_t, 6> StatusAkaMain::rootScreenContainerRows = {4, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_FR(1), LV_GRID_CONTENT, LV_GRID_TEMPLATE_LAST};
-std::array<int32_t, 5> StatusAkaMain::outputWidgetsContainerRows = {LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_TEMPLATE_LAST};
+std::array<int32_t, 6> StatusAkaMain::outputWidgetsContainerRows = {LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_TEMPLATE_LAST};
 std::array<int32_t, 5> StatusAkaMain::temperatureWidgetsContainerRows = {LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_CONTENT, LV_GRID_TEMPLATE_LAST};
 std::array<int32_t, 3> StatusAkaMain::widgetsContainerColumns = {158, 50, LV_GRID_TEMPLATE_LAST};
 
@@ -54,6 +61,9 @@ char StatusAkaMain::targetTemperatureText[DATA_STRING_BUFFER_MAX_SIZE];
 char StatusAkaMain::currentFanRpmText[DATA_STRING_BUFFER_MAX_SIZE];
 char StatusAkaMain::currentFanDutyCycleText[DATA_STRING_BUFFER_MAX_SIZE];
 char StatusAkaMain::currentHeaterDutyCycleText[DATA_STRING_BUFFER_MAX_SIZE];
+char StatusAkaMain::profileStepText[PROFILE_STEP_STRING_BUFFER_MAX_SIZE] = "Profile:";
+char StatusAkaMain::profileTimeRemainingText[DATA_STRING_BUFFER_MAX_SIZE] = "Off";
+char StatusAkaMain::usageCounterText[USAGE_COUNTER_STRING_BUFFER_MAX_SIZE];
 
 lv_obj_t* StatusAkaMain::rootScreenContainer;
 lv_obj_t* StatusAkaMain::currentTemperatureValueTextLabel;
@@ -62,6 +72,8 @@ lv_obj_t* StatusAkaMain::currentPiControllerStatusValueTextLabel;
 lv_obj_t* StatusAkaMain::currentFanRpmValueTextLabel;
 lv_obj_t* StatusAkaMain::currentFanOutputValueTextLabel;
 lv_obj_t* StatusAkaMain::currentHeaterOutputValueTextLabel;
+lv_obj_t* StatusAkaMain::profileStepTextLabel;
+lv_obj_t* StatusAkaMain::profileTimeRemainingValueTextLabel;
 lv_obj_t* StatusAkaMain::onOffButton;
 
 lv_obj_t* StatusAkaMain::errorMessagesLabel;
@@ -123,7 +135,8 @@ void StatusAkaMain::Init(lv_obj_t* TargetScreen, lv_style_t* ButtonLabelTextStyl
 }
 
 /**
- * @brief  Handles updating the message bar at the bottom of the display.
+ * @brief  Handles updating the message bar at the bottom of the display. While there are no errors, it cycles through
+ *         the usage counters instead.
 */
 void StatusAkaMain::UpdateErrorMessage()
 {
@@ -133,6 +146,12 @@ void StatusAkaMain::UpdateErrorMessage()
 	}
 	millisValueAtLastErrorMessageUpdate = millis();
 
+	if (allErrorConditionsPresent == NoErrors)
+	{
+		showNextUsageCounter();
+		return;
+	}
+
 	if (currentDisplayedErrorMessage == allErrorConditionsPresent)
 	{
 		return;
@@ -144,12 +163,12 @@ void StatusAkaMain::UpdateErrorMessage()
 		return;
 	}
 
-	// Otherwise, cycle to the next error message that needs to be shown.
+	// Otherwise, cycle to the next error message that needs to be shown. Starting from no message, the first one is next.
 	uint8_t nextErrorMessage = currentDisplayedErrorMessage;
 	while (true)
 	{
 		nextErrorMessage <<= 1;
-		if (nextErrorMessage > 0b100)
+		if ((nextErrorMessage == NoErrors) || (nextErrorMessage > 0b100000))
 		{
 			nextErrorMessage = 0b001;
 		}
@@ -325,6 +344,63 @@ void StatusAkaMain::SetCurrentDutyCycles(const float FanDutyCycle, const float H
 	lv_label_set_text_static(currentHeaterOutputValueTextLabel, nullptr);
 }
 
+/**
+ * @brief                       Updates the UI to display the set point profile's progress.
+ *
+ * @param IsRunning             True if a profile is running. False otherwise.
+ * @param Step                  The index of the step the profile is on.
+ * @param StepCount             The number of steps in the profile.
+ * @param StepSecondsRemaining  How long the current step has left to run.
+*/
+void StatusAkaMain::SetProfileStatus(const bool IsRunning, const uint8_t Step, const uint8_t StepCount, const uint32_t StepSecondsRemaining)
+{
+	char newProfileStepText[PROFILE_STEP_STRING_BUFFER_MAX_SIZE];
+	char newProfileTimeRemainingText[DATA_STRING_BUFFER_MAX_SIZE];
+
+	if (!IsRunning)
+	{
+		std::ignore = snprintf(newProfileStepText, PROFILE_STEP_STRING_BUFFER_MAX_SIZE, "Profile:");
+		std::ignore = snprintf(newProfileTimeRemainingText, DATA_STRING_BUFFER_MAX_SIZE, "Off");
+	}
+	else
+	{
+		std::ignore = snprintf(newProfileStepText, PROFILE_STEP_STRING_BUFFER_MAX_SIZE, "Profile step %u/%u:", Step + 1, StepCount);
+
+		// Minutes and seconds fit in the value column for up to 99 minutes. Longer steps only show the minutes.
+		const uint32_t minutesRemaining = StepSecondsRemaining / 60;
+		if (minutesRemaining < 100)
+		{
+			std::ignore = snprintf(newProfileTimeRemainingText, DATA_STRING_BUFFER_MAX_SIZE, "%u:%02u", minutesRemaining, StepSecondsRemaining % 60);
+		}
+		else
+		{
+			std::ignore = snprintf(newProfileTimeRemainingText, DATA_STRING_BUFFER_MAX_SIZE, "%um", minutesRemaining);
+		}
+	}
+
+	// This is called every loop, so the labels are only refreshed when their text actually changes.
+	if (strcmp(newProfileStepText, profileStepText) != 0)
+	{
+		std::ignore = snprintf(profileStepText, PROFILE_STEP_STRING_BUFFER_MAX_SIZE, "%s", newProfileStepText);
+		lv_label_set_text_static(profileStepTextLabel, nullptr);
+	}
+	if (strcmp(newProfileTimeRemainingText, profileTimeRemainingText) != 0)
+	{
+		std::ignore = snprintf(profileTimeRemainingText, DATA_STRING_BUFFER_MAX_SIZE, "%s", newProfileTimeRemainingText);
+		lv_label_set_text_static(profileTimeRemainingValueTextLabel, nullptr);
+	}
+}
+
+/**
+ * @brief        Stores the usage counters, to be shown in the message bar while there are no errors.
+ *
+ * @param Usage  The session and lifetime usage counters.
+*/
+void StatusAkaMain::SetUsage(const UsageMeter::UsageData& Usage)
+{
+	currentUsage = Usage;
+}
+
 /**
  * @brief           Adds a new error condition to the status message panel.
  *
@@ -450,6 +526,16 @@ void StatusAkaMain::buildOutputUi(int32_t WidgetsContainerWidth)
 			outputWidgetsContainer, currentHeaterDutyCycleText,
 			true, LV_GRID_ALIGN_END, 1, 1, 3, 1
 	);
+
+	profileStepTextLabel = LvglHelpers::CreateTextLabel(
+			outputWidgetsContainer, profileStepText,
+			true, LV_GRID_ALIGN_START, 0, 1, 4, 1
+	);
+
+	profileTimeRemainingValueTextLabel = LvglHelpers::CreateTextLabel(
+			outputWidgetsContainer, profileTimeRemainingText,
+			true, LV_GRID_ALIGN_END, 1, 1, 4, 1
+	);
 }
 
 /**
@@ -538,6 +624,27 @@ bool StatusAkaMain::changeErrorMessage(uint8_t NewErrorCondition)
 			return true;
 		}
 
+		case AutoTuneInProgress:
+		{
+			lv_label_set_text(errorMessagesLabel, "Auto-tuning PID gains");
+			currentDisplayedErrorMessage = AutoTuneInProgress;
+			return true;
+		}
+
+		case AutoTuneFailed:
+		{
+			lv_label_set_text(errorMessagesLabel, "Auto-tune failed");
+			currentDisplayedErrorMessage = AutoTuneFailed;
+			return true;
+		}
+
+		case HeaterPowerLimited:
+		{
+			lv_label_set_text(errorMessagesLabel, "Heater power limited");
+			currentDisplayedErrorMessage = HeaterPowerLimited;
+			return true;
+		}
+
 		default:
 		{
 			return false;
@@ -545,6 +652,35 @@ bool StatusAkaMain::changeErrorMessage(uint8_t NewErrorCondition)
 	}
 }
 
+/**
+ * @brief  Shows the next usage counter in the message bar.
+*/
+void StatusAkaMain::showNextUsageCounter()
+{
+	switch (currentDisplayedUsageCounter)
+	{
+		case 0:
+			std::ignore = snprintf(usageCounterText, USAGE_COUNTER_STRING_BUFFER_MAX_SIZE, "Session energy: %0.1f Wh", currentUsage.SessionHeaterEnergyWh);
+			break;
+
+		case 1:
+			std::ignore = snprintf(usageCounterText, USAGE_COUNTER_STRING_BUFFER_MAX_SIZE, "Lifetime energy: %0.2f kWh", currentUsage.LifetimeHeaterEnergyKWh);
+			break;
+
+		case 2:
+			std::ignore = snprintf(usageCounterText, USAGE_COUNTER_STRING_BUFFER_MAX_SIZE, "SSR switches: %llu", static_cast<unsigned long long>(currentUsage.LifetimeSsrSwitchCount));
+			break;
+
+		default:
+			std::ignore = snprintf(usageCounterText, USAGE_COUNTER_STRING_BUFFER_MAX_SIZE, "Fan run time: %0.1f h", currentUsage.LifetimeFanRunHours);
+			break;
+	}
+
+	lv_label_set_text(errorMessagesLabel, usageCounterText);
+	currentDisplayedErrorMessage = NoErrors;
+	currentDisplayedUsageCounter = (currentDisplayedUsageCounter + 1) % USAGE_COUNTER_COUNT;
+}
+
 /**
  * @brief  Used to instruct given functions to use their debug code.
  *
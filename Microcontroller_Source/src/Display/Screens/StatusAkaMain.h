@@ -15,6 +15,7 @@
 #include <array>
 
 #include "AllScreens.h"
+#include "Misc/UsageMeter.h"
 
 /**
  * @brief  Contains the logic for the main screen.
@@ -24,10 +25,13 @@ class StatusAkaMain
 public:
 	enum ErrorMessages
 	{
-		NoErrors                    = 0b000,
-		FanStuck                    = 0b001,
-		ThermoResistorShortCircuit  = 0b010,
-		ThermoResistorUnplugged     = 0b100,
+		NoErrors                    = 0b000000,
+		FanStuck                    = 0b000001,
+		ThermoResistorShortCircuit  = 0b000010,
+		ThermoResistorUnplugged     = 0b000100,
+		AutoTuneInProgress          = 0b001000,
+		AutoTuneFailed              = 0b010000,
+		HeaterPowerLimited          = 0b100000,
 	};
 
 	static void Init(lv_obj_t* TargetScreen, lv_style_t* ButtonLabelTextStyle, float TargetTemperature);
@@ -43,6 +47,8 @@ public:
 	static void SetPiControllerStatusIndicator(bool IsActive);
 	static void SetCurrentFanRpm(bool IsSwitchedOn, uint32_t Rpm);
 	static void SetCurrentDutyCycles(float FanDutyCycle, float HeaterDutyCycle);
+	static void SetProfileStatus(bool IsRunning, uint8_t Step, uint8_t StepCount, uint32_t StepSecondsRemaining);
+	static void SetUsage(const UsageMeter::UsageData& Usage);
 
 	static void AddErrorCondition(ErrorMessages NewError);
 	static void RemoveErrorCondition(ErrorMessages OutdatedError);
@@ -68,9 +74,12 @@ private:
 	static uint8_t allErrorConditionsPresent;       // Can't define as ErrorMessages type. Otherwise, can't add or remove flags from it.
 	static ErrorMessages currentDisplayedErrorMessage;
 
+	static uint8_t currentDisplayedUsageCounter;
+	static UsageMeter::UsageData currentUsage;
+
 	static std::array<int32_t, 5> rootScreenContainerColumns;
 	static std::array<int32_t, 6> rootScreenContainerRows;
-	static std::array<int32_t, 5> outputWidgetsContainerRows;
+	static std::array<int32_t, 6> outputWidgetsContainerRows;
 	static std::array<int32_t, 5> temperatureWidgetsContainerRows;
 	static std::array<int32_t, 3> widgetsContainerColumns;
 
@@ -79,6 +88,9 @@ private:
 	static char currentFanRpmText[];
 	static char currentFanDutyCycleText[];
 	static char currentHeaterDutyCycleText[];
+	static char profileStepText[];
+	static char profileTimeRemainingText[];
+	static char usageCounterText[];
 
 	static lv_obj_t* rootScreenContainer;
 	static lv_obj_t* currentTemperatureValueTextLabel;
@@ -87,6 +99,8 @@ private:
 	static lv_obj_t* currentFanRpmValueTextLabel;
 	static lv_obj_t* currentFanOutputValueTextLabel;
 	static lv_obj_t* currentHeaterOutputValueTextLabel;
+	static lv_obj_t* profileStepTextLabel;
+	static lv_obj_t* profileTimeRemainingValueTextLabel;
 	static lv_obj_t* onOffButton;
 
 	static lv_obj_t* errorMessagesLabel;
@@ -99,6 +113,7 @@ private:
 	static void targetTemperatureDecrementButtonEventHandler(__attribute__((unused)) lv_event_t* event);
 	static void targetTemperatureIncrementButtonEventHandler(__attribute__((unused)) lv_event_t* event);
 	static bool changeErrorMessage(uint8_t NewErrorCondition);
+	static void showNextUsageCounter();
 
 	static void enableDebugTriggers();
 };
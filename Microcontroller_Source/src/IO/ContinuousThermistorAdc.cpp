@@ -0,0 +1,185 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "ContinuousThermistorAdc.h"
+
+#include <Arduino.h>
+#include <array>
+#include <driver/adc.h>
+#include <tuple>
+
+#include "Misc/SerialHandler.h"
+
+
+#define SAMPLE_FREQUENCY_HZ         (1000 * 1000 / THERMISTOR_ADC_SAMPLE_PERIOD_US)
+#define BYTES_PER_CONVERSION        sizeof(adc_digi_output_data_t)
+#define CONVERSIONS_PER_INTERRUPT   64
+#define DRIVER_BUFFER_CONVERSIONS   ((THERMISTOR_ADC_SAMPLES_PER_BURST * THERMISTOR_ADC_MAX_CHANNELS) + CONVERSIONS_PER_INTERRUPT)
+
+
+/**
+ * @brief  Installs the continuous ADC driver, and sets it up to convert each thermistor's channel at a fixed rate.
+*/
+void ContinuousThermistorAdc::Init()
+{
+	uint32_t channelMask = 0;
+	std::array<adc_digi_pattern_config_t, THERMISTOR_ADC_MAX_CHANNELS> patterns = {};
+	for (uint8_t i = 0; i < channelCount; ++i)
+	{
+		channelMask |= BIT(adcChannels[i]);
+
+		// Matches analogRead's defaults, so the temperature conversion constants don't change.
+		patterns[i].atten = ADC_ATTEN_DB_11;
+		patterns[i].channel = adcChannels[i];
+		patterns[i].unit = 0;
+		patterns[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+	}
+
+	adc_digi_init_config_t initConfig = {};
+	initConfig.max_store_buf_size = DRIVER_BUFFER_CONVERSIONS * BYTES_PER_CONVERSION;
+	initConfig.conv_num_each_intr = CONVERSIONS_PER_INTERRUPT * BYTES_PER_CONVERSION;
+	initConfig.adc1_chan_mask = channelMask;
+	initConfig.adc2_chan_mask = 0;
+	if (adc_digi_initialize(&initConfig) != ESP_OK)
+	{
+		SerialHandler::SafeWriteLn("Continuous ADC driver could not be installed.", true);
+		return;
+	}
+
+	adc_digi_configuration_t controllerConfig = {};
+	controllerConfig.conv_limit_en = false;
+	controllerConfig.conv_limit_num = 0;
+	controllerConfig.pattern_num = channelCount;
+	controllerConfig.adc_pattern = patterns.data();
+	controllerConfig.sample_freq_hz = SAMPLE_FREQUENCY_HZ * channelCount;
+	controllerConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+	controllerConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+	if (adc_digi_controller_configure(&controllerConfig) != ESP_OK)
+	{
+		SerialHandler::SafeWriteLn("Continuous ADC could not be configured.", true);
+	}
+}
+
+/**
+ * @brief  Starts the ADC converting. Conversions left over from the previous burst are thrown away first.
+*/
+void ContinuousThermistorAdc::StartBurst()
+{
+	discardBufferedConversions();
+	resetSamplesCollected();
+	isConverting = (adc_digi_start() == ESP_OK);
+}
+
+/**
+ * @brief   Copies any finished conversions into the burst buffer, without waiting for more.
+ *
+ * @return  True once every channel's samples in the burst have been collected. False otherwise.
+*/
+bool ContinuousThermistorAdc::IsBurstComplete()
+{
+	if (isEveryChannelComplete())
+	{
+		return true;
+	}
+
+	if (!isConverting)
+	{
+		return false;
+	}
+
+	std::array<uint8_t, CONVERSIONS_PER_INTERRUPT * BYTES_PER_CONVERSION> conversionBytes;
+	uint32_t bytesRead = 0;
+	const esp_err_t readResult = adc_digi_read_bytes(conversionBytes.data(), conversionBytes.size(), &bytesRead, 0);
+
+	// ESP_ERR_INVALID_STATE means the driver's buffer filled up, but the conversions that were read are still valid.
+	if ((readResult != ESP_OK) && (readResult != ESP_ERR_INVALID_STATE))
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i + BYTES_PER_CONVERSION <= bytesRead; i += BYTES_PER_CONVERSION)
+	{
+		const adc_digi_output_data_t* conversion = reinterpret_cast<const adc_digi_output_data_t*>(&conversionBytes[i]);
+		uint8_t channelIndex = 0;
+		if ((conversion->type2.unit != 0) || !findChannelIndex(conversion->type2.channel, &channelIndex))
+		{
+			continue;
+		}
+
+		// A channel that fills up first just drops its extra conversions until the others catch up.
+		if (samplesCollected[channelIndex] < burstLength)
+		{
+			samples[channelIndex][samplesCollected[channelIndex]] = conversion->type2.data;
+			samplesCollected[channelIndex]++;
+		}
+	}
+
+	if (isEveryChannelComplete())
+	{
+		stopConverting();
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief  Stops the ADC converting, and throws away the samples collected so far.
+*/
+void ContinuousThermistorAdc::StopBurst()
+{
+	stopConverting();
+	resetSamplesCollected();
+}
+
+/**
+ * @brief                Finds which of the scanned channels a conversion came from.
+ *
+ * @param  AdcChannel    The ADC1 channel the conversion was tagged with.
+ * @param  ChannelIndex  Set to the channel's position in the list given to SetChannels, if it was found.
+ *
+ * @return               True if the channel is one being scanned. False otherwise.
+*/
+bool ContinuousThermistorAdc::findChannelIndex(const uint8_t AdcChannel, uint8_t* ChannelIndex) const
+{
+	for (uint8_t i = 0; i < channelCount; ++i)
+	{
+		if (adcChannels[i] == AdcChannel)
+		{
+			*ChannelIndex = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief  Stops the ADC converting. The samples collected so far are kept.
+*/
+void ContinuousThermistorAdc::stopConverting()
+{
+	if (isConverting)
+	{
+		std::ignore = adc_digi_stop();
+		isConverting = false;
+	}
+}
+
+/**
+ * @brief  Empties the driver's buffer of any conversions that finished after the previous burst was complete.
+*/
+void ContinuousThermistorAdc::discardBufferedConversions()
+{
+	std::array<uint8_t, CONVERSIONS_PER_INTERRUPT * BYTES_PER_CONVERSION> conversionBytes;
+	uint32_t bytesRead = 0;
+	while ((adc_digi_read_bytes(conversionBytes.data(), conversionBytes.size(), &bytesRead, 0) == ESP_OK) && (bytesRead > 0))
+	{}
+}
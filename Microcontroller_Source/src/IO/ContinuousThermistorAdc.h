@@ -0,0 +1,45 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_CONTINUOUSTHERMISTORADC_H
+#define ENGINEERING_PROJECT_CONTINUOUSTHERMISTORADC_H
+
+#include <cstdint>
+
+#include "IO/ThermistorAdc.h"
+
+/**
+ * @brief  Collects thermistor samples with the ESP32-C3's continuous ADC driver.
+ *
+ * The ADC's digital controller triggers each conversion at a fixed rate and DMA moves the results into the driver's
+ * buffer, so the sample spacing doesn't depend on the main loop. Polling the burst just copies out whatever
+ * conversions have finished since the last poll.
+ *
+ * With several channels, the controller's pattern table steps through them one conversion each, and the conversion
+ * rate is scaled up so every channel is still sampled once per THERMISTOR_ADC_SAMPLE_PERIOD_US.
+*/
+class ContinuousThermistorAdc final : public ThermistorAdc
+{
+public:
+	void Init() final;
+	void StartBurst() final;
+	bool IsBurstComplete() final;
+	void StopBurst() final;
+
+private:
+	bool isConverting = false;
+
+	bool findChannelIndex(uint8_t AdcChannel, uint8_t* ChannelIndex) const;
+	void stopConverting();
+	void discardBufferedConversions();
+};
+
+
+#endif //ENGINEERING_PROJECT_CONTINUOUSTHERMISTORADC_H
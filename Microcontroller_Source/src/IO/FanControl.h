@@ -13,6 +13,12 @@
 
 #include <cstdint>
 
+// The fan's power draw at full speed, used to share out the power budget. Can be overridden with
+// -DFAN_RATED_WATTAGE=<n>.
+#ifndef FAN_RATED_WATTAGE
+#define FAN_RATED_WATTAGE   6
+#endif
+
 /**
  * @brief  Contains the logic for the Fan Controller.
 */
@@ -12,6 +12,7 @@
 #include "HeaterControl.h"
 
 #include <Arduino.h>
+#include <cmath>
 
 #include "Misc/SerialHandler.h"
 #include "Misc/Utils.h"
@@ -19,24 +20,94 @@
 
 #define MIN_POWER_LEVEL             0.5
 #define MAX_POWER_LEVEL             99.5
-#define ONE_50HZ_WAVE_PERIOD_IN_US          20000
-#define ONE_HUNDRED_50HZ_WAVE_PERIODS_IN_US (ONE_50HZ_WAVE_PERIOD_IN_US * 100)
+
+#define MAINS_CYCLE_PERIOD_IN_US            (1000000 / HEATER_MAINS_FREQUENCY_HZ)
+#define MAINS_CYCLES_PER_WINDOW             (HEATER_MAINS_FREQUENCY_HZ * 2)     // Each window lasts 2 seconds.
+#define PWM_WINDOW_PERIOD_IN_US             (MAINS_CYCLE_PERIOD_IN_US * MAINS_CYCLES_PER_WINDOW)
+#define ONE_WHOLE_CYCLE_Q16                 (1u << 16)
+
+#ifdef HEATER_MAINS_SYNCHRONOUS
+#define SWITCHING_STEPS_PER_MAINS_CYCLE     2       // The SSR can be switched at every zero crossing.
+#else
+#define SWITCHING_STEPS_PER_MAINS_CYCLE     1
+#endif
+#define SWITCHING_STEPS_PER_WINDOW          (MAINS_CYCLES_PER_WINDOW * SWITCHING_STEPS_PER_MAINS_CYCLE)
+#define SWITCHING_STEP_PERIOD_IN_US         (MAINS_CYCLE_PERIOD_IN_US / SWITCHING_STEPS_PER_MAINS_CYCLE)
 
 #define SSR_CONTROL_PIN 7
 
+#define EDGE_TIMING_REPORT_EDGES            20
+
+#ifdef HEATER_USE_HARDWARE_TIMER
+#define SWITCHING_STEP_TIMER_NUMBER         0
+#define SWITCHING_STEP_TIMER_PRESCALER      80      // Counts the 80 MHz APB clock down to 1 MHz, so the timer counts in us.
+#define SWITCHING_STEP_TIMER_MIN_DELAY_US   20
+#endif
+
+static_assert((SWITCHING_STEPS_PER_WINDOW <= UINT16_MAX), "The heater's switching steps per window don't fit their counter.");
+
+#if defined(HEATER_MAINS_SYNCHRONOUS) && defined(HEATER_ZERO_CROSS_GPIO)
+/**
+ * @brief        Checks that the zero crossing detector isn't given a pin the current board already uses.
+ *
+ * @param  Gpio  The detector's GPIO.
+ *
+ * @returns      True if the pin is free. False otherwise.
+*/
+constexpr bool isZeroCrossGpioFree(const uint8_t Gpio)
+{
+	// Outlet probe, backlight, touch SDA, display DC, fan MOSFET, PWM and speed sense, SSR, touch SCL, display CS,
+	// thermistor supply, USB D- and D+, display SCLK and MOSI.
+	constexpr uint8_t usedGpios[] = {0, 1, 2, 3, 4, 5, 6, SSR_CONTROL_PIN, 8, 9, 10, 18, 19, 20, 21};
+	for (const uint8_t usedGpio : usedGpios)
+	{
+		if (Gpio == usedGpio)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static_assert(isZeroCrossGpioFree(HEATER_ZERO_CROSS_GPIO),
+              "HEATER_ZERO_CROSS_GPIO is already used by the touch controller, display, fan, SSR, thermistors or USB.");
+#endif
+
 
 bool HeaterControl::debug_Init = false;
 bool HeaterControl::debug_UpdatePwmState = false;
 bool HeaterControl::debug_SetHeaterPowerLevel = false;
 bool HeaterControl::debug_setGpioState = false;
+bool HeaterControl::debug_EdgeTiming = false;
 
 bool HeaterControl::isFanRunning = false;
-uint8_t HeaterControl::currentGpioState = LOW;
 uint32_t HeaterControl::currentPowerLevelPercent = 0;
+uint8_t HeaterControl::currentGpioState = LOW;
 uint32_t HeaterControl::microsValueAtStartOfThisCycle = 0;
 uint32_t HeaterControl::currentDutyCycleOnTimeUs = 0;
+uint32_t HeaterControl::microsValueAtLastSwitch = 0;
+uint32_t HeaterControl::switchCount = 0;
+uint64_t HeaterControl::ssrOnTimeUs = 0;
+uint32_t HeaterControl::worstEdgeErrorUs = 0;
+uint32_t HeaterControl::edgeErrorSumUs = 0;
+uint32_t HeaterControl::edgesTimed = 0;
+uint16_t HeaterControl::switchingStepInWindow = 0;
+uint32_t HeaterControl::microsValueAtNextSwitchingStep = 0;
+bool HeaterControl::isSsrOnThisStep = false;
+uint32_t HeaterControl::cycleOnFractionQ16 = 0;
+uint32_t HeaterControl::cycleDistributionAccumulatorQ16 = 0;
 HeaterControl::HeaterStates HeaterControl::heaterState = HeaterStates::SwitchedOff;
 
+#ifdef HEATER_MAINS_SYNCHRONOUS
+MainsTimebase HeaterControl::mainsTimebase;
+uint16_t HeaterControl::onHalfCyclesPerWindow = 0;
+bool HeaterControl::isOddWindow = false;
+#endif
+
+#ifdef HEATER_USE_HARDWARE_TIMER
+hw_timer_t* HeaterControl::switchingStepTimer = nullptr;
+#endif
+
 
 /**
  * @brief  Initialises the heater control class.
@@ -48,6 +119,20 @@ void HeaterControl::Init()
 	pinMode(SSR_CONTROL_PIN, OUTPUT);
 	setHeaterSwitchedOffState();
 	setGpioState(LOW);
+
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	mainsTimebase.Init(HEATER_MAINS_FREQUENCY_HZ, micros());
+#endif
+
+#if defined(HEATER_MAINS_SYNCHRONOUS) && defined(HEATER_ZERO_CROSS_GPIO)
+	pinMode(HEATER_ZERO_CROSS_GPIO, INPUT);
+	attachInterrupt(digitalPinToInterrupt(HEATER_ZERO_CROSS_GPIO), zeroCrossingInterruptHandler, RISING);
+#endif
+
+#ifdef HEATER_USE_HARDWARE_TIMER
+	initSwitchingStepTimer();
+#endif
+
 	SerialHandler::SafeWriteLn("Heater control initialised.", debug_Init);
 }
 
@@ -61,6 +146,67 @@ uint32_t HeaterControl::GetCurrentPowerLevel()
 	return currentPowerLevelPercent;
 }
 
+/**
+ * @brief    Gets the energy the element has delivered since boot, from how long the SSR has been switched on for and
+ *           HEATER_ELEMENT_WATTAGE. A zero crossing SSR rounds each edge to a zero crossing, so outside the mains
+ *           synchronous mode this is only accurate to a half cycle per edge.
+ *
+ * @returns  The energy delivered, in joules.
+*/
+uint64_t HeaterControl::GetEnergyDeliveredJoules()
+{
+	// With the hardware timer, the SSR is switched from an interrupt, so everything is copied in one go.
+	noInterrupts();
+	uint64_t totalSsrOnTimeUs = ssrOnTimeUs;
+	if (currentGpioState == HIGH)
+	{
+		totalSsrOnTimeUs += micros() - microsValueAtLastSwitch;
+	}
+	interrupts();
+
+	return (totalSsrOnTimeUs * HEATER_ELEMENT_WATTAGE) / 1000000;
+}
+
+/**
+ * @brief    Gets when the SSR last switched, and predicts when it will next switch. In the duty cycle state it switches
+ *           on at the start of each cycle and off once the on time is up, or whenever the cycle distribution says so.
+ *           The other states hold the SSR steady.
+ *
+ * @returns  The SSR's switching data. The next switch is only valid if IsSwitchScheduled is true.
+*/
+HeaterControl::SwitchingData HeaterControl::GetSwitchingData()
+{
+	SwitchingData switchingData{};
+
+	// With the hardware timer, the SSR is switched from an interrupt, so everything is copied in one go.
+	noInterrupts();
+	switchingData.IsSsrOn = (currentGpioState == HIGH);
+	switchingData.MicrosValueAtLastSwitch = microsValueAtLastSwitch;
+	switchingData.SwitchCount = switchCount;
+	[[maybe_unused]] const uint32_t microsValueAtStartOfWindow = microsValueAtStartOfThisCycle;
+	interrupts();
+
+	if (heaterState != SwitchedOnPwmState)
+	{
+		return switchingData;
+	}
+
+#if defined(HEATER_USE_CYCLE_DISTRIBUTION) || defined(HEATER_MAINS_SYNCHRONOUS)
+	switchingData.IsSwitchScheduled = predictNextSteppedSwitch(&switchingData);
+#else
+	switchingData.IsSwitchScheduled = true;
+	if ((micros() - microsValueAtStartOfWindow) <= currentDutyCycleOnTimeUs)
+	{
+		switchingData.MicrosValueAtNextSwitch = microsValueAtStartOfWindow + currentDutyCycleOnTimeUs;
+	}
+	else
+	{
+		switchingData.MicrosValueAtNextSwitch = microsValueAtStartOfWindow + PWM_WINDOW_PERIOD_IN_US;
+	}
+#endif
+	return switchingData;
+}
+
 /**
  * @brief                Sets whether or not the fan is currently spinning.
  *
@@ -83,6 +229,18 @@ void HeaterControl::SetHeaterPowerLevel(const float NewPowerLevelPercent)
 		static_cast<uint32_t>(NewPowerLevelPercent) :
 		0;
 
+#ifdef HEATER_USE_CYCLE_DISTRIBUTION
+	// Only whole percents are compared against the limits, as before, but the fraction is kept for the distribution.
+	const uint32_t newCycleOnFractionQ16 = (isFanRunning && (NewPowerLevelPercent > 0.0f)) ?
+		static_cast<uint32_t>(NewPowerLevelPercent * (ONE_WHOLE_CYCLE_Q16 / 100.0f)) :
+		0;
+#elif defined(HEATER_MAINS_SYNCHRONOUS)
+	// The on time is rounded to the nearest half cycle on purpose, so each window delivers a known amount of energy.
+	const uint16_t newOnHalfCyclesPerWindow = (isFanRunning && (NewPowerLevelPercent > 0.0f)) ?
+		static_cast<uint16_t>(std::lround(NewPowerLevelPercent * SWITCHING_STEPS_PER_WINDOW / 100)) :
+		0;
+#endif
+
 	if (newPowerLevelPercentFloored <= MIN_POWER_LEVEL)
 	{
 		if (heaterState != SwitchedOff)
@@ -102,14 +260,35 @@ void HeaterControl::SetHeaterPowerLevel(const float NewPowerLevelPercent)
 		return;
 	}
 
+#ifdef HEATER_USE_CYCLE_DISTRIBUTION
+	if ((newCycleOnFractionQ16 == cycleOnFractionQ16) && (heaterState == SwitchedOnPwmState))
+	{
+		return;
+	}
+#elif defined(HEATER_MAINS_SYNCHRONOUS)
+	if ((newOnHalfCyclesPerWindow == onHalfCyclesPerWindow) && (heaterState == SwitchedOnPwmState))
+	{
+		return;
+	}
+#else
 	if (newPowerLevelPercentFloored == currentPowerLevelPercent)
 	{
 		return;
 	}
+#endif
 
-	heaterState = SwitchedOnPwmState;
+	// The timer's interrupt reads these, so they're all published with it held off. It then sees either the old power
+	// level or the new one, whatever order the stores end up in.
+	noInterrupts();
+#ifdef HEATER_USE_CYCLE_DISTRIBUTION
+	cycleOnFractionQ16 = newCycleOnFractionQ16;
+#elif defined(HEATER_MAINS_SYNCHRONOUS)
+	onHalfCyclesPerWindow = newOnHalfCyclesPerWindow;
+#endif
 	currentPowerLevelPercent = newPowerLevelPercentFloored;
-	currentDutyCycleOnTimeUs = newPowerLevelPercentFloored * ONE_50HZ_WAVE_PERIOD_IN_US;
+	currentDutyCycleOnTimeUs = newPowerLevelPercentFloored * (PWM_WINDOW_PERIOD_IN_US / 100);
+	heaterState = SwitchedOnPwmState;
+	interrupts();
 
 	if (debug_SetHeaterPowerLevel)
 	{
@@ -120,12 +299,25 @@ void HeaterControl::SetHeaterPowerLevel(const float NewPowerLevelPercent)
 
 /**
  * @brief  Checks whether the heater control GPIO state aligns with the current PWM state, and changes it accordingly if not.
+ *         With HEATER_USE_HARDWARE_TIMER defined the timer's interrupt does this instead, so only the edge timing is reported.
 */
 void HeaterControl::UpdatePwmState()
 {
-	if ((micros() - microsValueAtStartOfThisCycle) >= ONE_HUNDRED_50HZ_WAVE_PERIODS_IN_US)
+	reportEdgeTiming();
+
+#if !defined(HEATER_USE_HARDWARE_TIMER) && (defined(HEATER_USE_CYCLE_DISTRIBUTION) || defined(HEATER_MAINS_SYNCHRONOUS))
+	updateSwitchingStepsFromLoop();
+#elif !defined(HEATER_USE_HARDWARE_TIMER)
+	const uint32_t microsValueNow = micros();
+	if ((microsValueNow - microsValueAtStartOfThisCycle) >= PWM_WINDOW_PERIOD_IN_US)
 	{
-		microsValueAtStartOfThisCycle = micros();
+		// Windows follow on from each other, so a late edge doesn't push the rest of them back. After a stall longer
+		// than a whole window, the windows start again from now.
+		microsValueAtStartOfThisCycle += PWM_WINDOW_PERIOD_IN_US;
+		if ((microsValueNow - microsValueAtStartOfThisCycle) >= PWM_WINDOW_PERIOD_IN_US)
+		{
+			microsValueAtStartOfThisCycle = microsValueNow;
+		}
 	}
 
 	switch (heaterState)
@@ -148,14 +340,282 @@ void HeaterControl::UpdatePwmState()
 			if ((micros() - microsValueAtStartOfThisCycle) <= currentDutyCycleOnTimeUs)
 			{
 				SerialHandler::SafeWriteLn("Heater switched into duty cycle high state.", debug_UpdatePwmState && (currentGpioState == LOW));
+				if (currentGpioState == LOW)
+				{
+					recordEdgeTiming(static_cast<int32_t>(micros() - microsValueAtStartOfThisCycle));
+				}
 				setGpioState(HIGH);
 				return;
 			}
 
 			SerialHandler::SafeWriteLn("Heater switched into duty cycle low state.", debug_UpdatePwmState && (currentGpioState == HIGH));
+			if (currentGpioState == HIGH)
+			{
+				recordEdgeTiming(static_cast<int32_t>(micros() - microsValueAtStartOfThisCycle - currentDutyCycleOnTimeUs));
+			}
 			setGpioState(LOW);
 			return;
 	}
+#endif
+}
+
+#ifdef HEATER_USE_HARDWARE_TIMER
+/**
+ * @brief  Starts a hardware timer interrupting once per switching step, which switches the SSR from then on.
+ *         In the mains synchronous mode, the timer is set again after every step to follow the mains timebase.
+*/
+void HeaterControl::initSwitchingStepTimer()
+{
+	switchingStepTimer = timerBegin(SWITCHING_STEP_TIMER_NUMBER, SWITCHING_STEP_TIMER_PRESCALER, true);
+	if (switchingStepTimer == nullptr)
+	{
+		SerialHandler::SafeWriteLn("Heater timer could not be started. The heater will stay off.", true);
+		return;
+	}
+
+	switchingStepInWindow = 0;
+	timerAttachInterrupt(switchingStepTimer, switchingStepInterruptHandler, true);
+
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	microsValueAtStartOfThisCycle = getMicrosValueAtNextSwitchingStep();
+	scheduleNextSwitchingStepInterrupt();
+#else
+	// timerBegin has already started the counter, so the first step is due when it reaches the alarm, not one period
+	// from now. Both are read together so the interrupt can't come between them.
+	noInterrupts();
+	microsValueAtNextSwitchingStep = micros() - static_cast<uint32_t>(timerRead(switchingStepTimer)) + SWITCHING_STEP_PERIOD_IN_US;
+	microsValueAtStartOfThisCycle = microsValueAtNextSwitchingStep;
+	timerAlarmWrite(switchingStepTimer, SWITCHING_STEP_PERIOD_IN_US, true);
+	timerAlarmEnable(switchingStepTimer);
+	interrupts();
+#endif
+}
+
+/**
+ * @brief  Switches the SSR at the start of each switching step.
+ *
+ * @note   Runs in an interrupt, so it mustn't write to the Serial port.
+*/
+void IRAM_ATTR HeaterControl::switchingStepInterruptHandler()
+{
+	const uint32_t microsValueNow = micros();
+	const uint32_t microsValueAtStepStart = getMicrosValueAtNextSwitchingStep();
+	const uint8_t newGpioState = startNextSwitchingStep() ? HIGH : LOW;
+	if (newGpioState != currentGpioState)
+	{
+		recordEdgeTiming(static_cast<int32_t>(microsValueNow - microsValueAtStepStart));
+		writeSsrState(newGpioState);
+	}
+
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	scheduleNextSwitchingStepInterrupt();
+#endif
+}
+
+#ifdef HEATER_MAINS_SYNCHRONOUS
+/**
+ * @brief  Sets the timer's alarm for the next switching step. The half cycle period follows the mains, so the alarm
+ *         can't just reload by itself. A step that is already due runs almost straight away.
+ *
+ * @note   Also called from the timer's interrupt, so it mustn't write to the Serial port.
+*/
+void IRAM_ATTR HeaterControl::scheduleNextSwitchingStepInterrupt()
+{
+	const int32_t microsUntilNextStep = static_cast<int32_t>(getMicrosValueAtNextSwitchingStep() - micros());
+	const uint64_t alarmDelayUs = (microsUntilNextStep > SWITCHING_STEP_TIMER_MIN_DELAY_US) ?
+		static_cast<uint64_t>(microsUntilNextStep) :
+		SWITCHING_STEP_TIMER_MIN_DELAY_US;
+
+	timerAlarmWrite(switchingStepTimer, timerRead(switchingStepTimer) + alarmDelayUs, false);
+	timerAlarmEnable(switchingStepTimer);
+}
+#endif
+#else
+/**
+ * @brief  Starts every switching step that has come due since the last loop, and switches the SSR to suit the latest
+ *         one. After a stall longer than a whole window, the missed steps are passed over without switching.
+*/
+void HeaterControl::updateSwitchingStepsFromLoop()
+{
+	// The zero crossing interrupt moves the mains timebase, so it's held off while the steps are worked through.
+	noInterrupts();
+	if (static_cast<int32_t>(micros() - getMicrosValueAtNextSwitchingStep()) > static_cast<int32_t>(PWM_WINDOW_PERIOD_IN_US))
+	{
+#ifdef HEATER_MAINS_SYNCHRONOUS
+		// The timebase has to stay in step with the mains, so it's moved on a half cycle at a time.
+		while (static_cast<int32_t>(micros() - getMicrosValueAtNextSwitchingStep()) >= 0)
+		{
+			mainsTimebase.AdvanceHalfCycle();
+		}
+#else
+		microsValueAtNextSwitchingStep = micros();
+#endif
+	}
+
+	uint8_t newGpioState = currentGpioState;
+	uint32_t microsValueAtStepStart = getMicrosValueAtNextSwitchingStep();
+	while (static_cast<int32_t>(micros() - getMicrosValueAtNextSwitchingStep()) >= 0)
+	{
+		microsValueAtStepStart = getMicrosValueAtNextSwitchingStep();
+		newGpioState = startNextSwitchingStep() ? HIGH : LOW;
+	}
+	interrupts();
+
+	if (newGpioState != currentGpioState)
+	{
+		recordEdgeTiming(static_cast<int32_t>(micros() - microsValueAtStepStart));
+		setGpioState(newGpioState);
+	}
+}
+#endif
+
+#if defined(HEATER_MAINS_SYNCHRONOUS) && defined(HEATER_ZERO_CROSS_GPIO)
+/**
+ * @brief  Passes each zero crossing seen by the detector on to the mains timebase.
+ *
+ * @note   Runs in an interrupt, so it mustn't write to the Serial port.
+*/
+void IRAM_ATTR HeaterControl::zeroCrossingInterruptHandler()
+{
+	mainsTimebase.RecordZeroCrossing(micros());
+}
+#endif
+
+/**
+ * @brief    Decides whether the SSR is on for the switching step that is starting, and moves on to the next step.
+ *
+ * @returns  True if the SSR is on for the step. False otherwise.
+ *
+ * @note     Also called from the timer's interrupt, so it mustn't write to the Serial port.
+*/
+bool IRAM_ATTR HeaterControl::startNextSwitchingStep()
+{
+	if (switchingStepInWindow == 0)
+	{
+		microsValueAtStartOfThisCycle = getMicrosValueAtNextSwitchingStep();
+	}
+
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	isSsrOnThisStep = decideSwitchingStep(switchingStepInWindow, isOddWindow, &cycleDistributionAccumulatorQ16, isSsrOnThisStep);
+	mainsTimebase.AdvanceHalfCycle();
+#else
+	isSsrOnThisStep = decideSwitchingStep(switchingStepInWindow, false, &cycleDistributionAccumulatorQ16, isSsrOnThisStep);
+	microsValueAtNextSwitchingStep += SWITCHING_STEP_PERIOD_IN_US;
+#endif
+	switchingStepInWindow = (switchingStepInWindow + 1) % SWITCHING_STEPS_PER_WINDOW;
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	if (switchingStepInWindow == 0)
+	{
+		isOddWindow = !isOddWindow;
+	}
+#endif
+	return isSsrOnThisStep;
+}
+
+/**
+ * @brief                    Decides whether the SSR is on for a switching step.
+ *
+ *                           With HEATER_USE_CYCLE_DISTRIBUTION defined, the accumulator gains the on fraction every
+ *                           mains cycle, and the cycle is on whenever a whole cycle's worth has built up. This is
+ *                           Bresenham's line algorithm, so the on cycles are as evenly spread as they can be. Both
+ *                           halves of a cycle are always switched together, so no DC flows through the element.
+ *                           With HEATER_MAINS_SYNCHRONOUS defined, a block of half cycles at the start of each window is
+ *                           on. Every window starts on the same polarity, so an odd number of them would always add the
+ *                           extra half cycle to the same polarity. Odd windows start the block a half cycle later to
+ *                           balance it out. Otherwise the first steps of each window are on, up to the on time.
+ *
+ * @param  StepInWindow      The switching step's position in the window.
+ * @param  IsOddWindow       Whether the step is in an odd numbered window. Only used in the mains synchronous mode.
+ * @param  AccumulatorQ16    The cycle distribution's accumulator, which is updated if a new cycle is starting.
+ * @param  WasSsrOnLastStep  Whether the SSR was on for the step before.
+ *
+ * @returns                  True if the SSR is on for the step. False otherwise.
+ *
+ * @note                     Also called from the timer's interrupt, so it mustn't write to the Serial port.
+*/
+bool IRAM_ATTR HeaterControl::decideSwitchingStep(const uint16_t StepInWindow, [[maybe_unused]] const bool IsOddWindow,
+                                                  [[maybe_unused]] uint32_t* AccumulatorQ16,
+                                                  [[maybe_unused]] const bool WasSsrOnLastStep)
+{
+	if (heaterState != SwitchedOnPwmState)
+	{
+		return (heaterState == SwitchedOnMaxPower);
+	}
+
+#if defined(HEATER_USE_CYCLE_DISTRIBUTION)
+	if ((StepInWindow % SWITCHING_STEPS_PER_MAINS_CYCLE) != 0)
+	{
+		return WasSsrOnLastStep;
+	}
+
+	*AccumulatorQ16 += cycleOnFractionQ16;
+	if (*AccumulatorQ16 < ONE_WHOLE_CYCLE_Q16)
+	{
+		return false;
+	}
+	*AccumulatorQ16 -= ONE_WHOLE_CYCLE_Q16;
+	return true;
+#elif defined(HEATER_MAINS_SYNCHRONOUS)
+	const uint16_t firstOnStep = (IsOddWindow && ((onHalfCyclesPerWindow % 2) != 0)) ? 1 : 0;
+	return (StepInWindow >= firstOnStep) && (StepInWindow < (firstOnStep + onHalfCyclesPerWindow));
+#else
+	return ((StepInWindow * SWITCHING_STEP_PERIOD_IN_US) < currentDutyCycleOnTimeUs);
+#endif
+}
+
+/**
+ * @brief    Gets when the next switching step starts. In the mains synchronous mode, this is HEATER_ZERO_CROSS_LEAD_US
+ *           before the next zero crossing the mains timebase predicts.
+ *
+ * @returns  The value of micros() at the start of the next switching step.
+*/
+uint32_t IRAM_ATTR HeaterControl::getMicrosValueAtNextSwitchingStep()
+{
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	return mainsTimebase.GetMicrosValueAtNextZeroCrossing() - HEATER_ZERO_CROSS_LEAD_US;
+#else
+	return microsValueAtNextSwitchingStep;
+#endif
+}
+
+/**
+ * @brief                 Runs a copy of the switching steps forwards to find the next step the SSR switches at.
+ *
+ * @param  SwitchingData  The switching data to add the next switch to. IsSsrOn must already be set.
+ *
+ * @returns               True if the SSR switches within the next window. False otherwise.
+*/
+bool HeaterControl::predictNextSteppedSwitch(SwitchingData* SwitchingData)
+{
+	noInterrupts();
+	uint32_t accumulatorQ16 = cycleDistributionAccumulatorQ16;
+	uint16_t stepInWindow = switchingStepInWindow;
+	bool isSsrOnStep = isSsrOnThisStep;
+	uint32_t microsValueAtStepStart = getMicrosValueAtNextSwitchingStep();
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	bool isOddWindowStep = isOddWindow;
+	const uint32_t stepPeriodUs = mainsTimebase.GetHalfCyclePeriodUs();
+#else
+	const bool isOddWindowStep = false;
+	const uint32_t stepPeriodUs = SWITCHING_STEP_PERIOD_IN_US;
+#endif
+	interrupts();
+
+	for (uint16_t i = 0; i < SWITCHING_STEPS_PER_WINDOW; ++i)
+	{
+		isSsrOnStep = decideSwitchingStep(stepInWindow, isOddWindowStep, &accumulatorQ16, isSsrOnStep);
+		if (isSsrOnStep != SwitchingData->IsSsrOn)
+		{
+			SwitchingData->MicrosValueAtNextSwitch = microsValueAtStepStart;
+			return true;
+		}
+		stepInWindow = (stepInWindow + 1) % SWITCHING_STEPS_PER_WINDOW;
+#ifdef HEATER_MAINS_SYNCHRONOUS
+		isOddWindowStep = (stepInWindow == 0) ? !isOddWindowStep : isOddWindowStep;
+#endif
+		microsValueAtStepStart += stepPeriodUs;
+	}
+	return false;
 }
 
 /**
@@ -163,8 +623,10 @@ void HeaterControl::UpdatePwmState()
 */
 void HeaterControl::setHeaterSwitchedOffState()
 {
+	noInterrupts();
 	heaterState = SwitchedOff;
 	currentPowerLevelPercent = 0;
+	interrupts();
 }
 
 /**
@@ -172,8 +634,10 @@ void HeaterControl::setHeaterSwitchedOffState()
 */
 void HeaterControl::setHeaterMaxPowerState()
 {
+	noInterrupts();
 	currentPowerLevelPercent = 100.0;
 	heaterState = SwitchedOnMaxPower;
+	interrupts();
 }
 
 /**
@@ -188,8 +652,7 @@ void HeaterControl::setGpioState(const uint8_t State)
 		return;
 	}
 
-	digitalWrite(SSR_CONTROL_PIN, State);
-	currentGpioState = State;
+	writeSsrState(State);
 
 	if (debug_setGpioState)
 	{
@@ -198,6 +661,77 @@ void HeaterControl::setGpioState(const uint8_t State)
 	}
 }
 
+/**
+ * @brief         Writes the SSR's GPIO, and records when it switched and how long it was on for.
+ *
+ * @param  State  Whether to set the GPIO to a Low or High state.
+ *
+ * @note          Also called from the timer's interrupt, so it mustn't write to the Serial port.
+*/
+void IRAM_ATTR HeaterControl::writeSsrState(const uint8_t State)
+{
+	digitalWrite(SSR_CONTROL_PIN, State);
+	const uint32_t microsValueNow = micros();
+	if (currentGpioState == HIGH)
+	{
+		ssrOnTimeUs += microsValueNow - microsValueAtLastSwitch;
+	}
+	currentGpioState = State;
+	microsValueAtLastSwitch = microsValueNow;
+	switchCount++;
+}
+
+/**
+ * @brief               Adds how late an SSR edge was to the edge timing totals.
+ *
+ * @param  EdgeErrorUs  How long after the edge was due the SSR actually switched. An edge a little early, from the
+ *                      timer and micros() not quite agreeing, counts as on time rather than wrapping round.
+ *
+ * @note                Also called from the timer's interrupt, so it mustn't write to the Serial port.
+*/
+void IRAM_ATTR HeaterControl::recordEdgeTiming(const int32_t EdgeErrorUs)
+{
+	const uint32_t edgeLatenessUs = (EdgeErrorUs > 0) ? static_cast<uint32_t>(EdgeErrorUs) : 0;
+	if (edgeLatenessUs > worstEdgeErrorUs)
+	{
+		worstEdgeErrorUs = edgeLatenessUs;
+	}
+	edgeErrorSumUs += edgeLatenessUs;
+	edgesTimed++;
+}
+
+/**
+ * @brief  Writes the average and worst edge lateness to the Serial port every EDGE_TIMING_REPORT_EDGES edges, then
+ *         starts the totals again.
+*/
+void HeaterControl::reportEdgeTiming()
+{
+	// The timer's interrupt adds to the totals, so even the count is only read with it held off.
+	noInterrupts();
+	if (edgesTimed < EDGE_TIMING_REPORT_EDGES)
+	{
+		interrupts();
+		return;
+	}
+
+	const uint32_t worstEdgeErrorCopyUs = worstEdgeErrorUs;
+	const uint32_t edgeErrorSumCopyUs = edgeErrorSumUs;
+	const uint32_t edgesTimedCopy = edgesTimed;
+	worstEdgeErrorUs = 0;
+	edgeErrorSumUs = 0;
+	edgesTimed = 0;
+	interrupts();
+
+	if (debug_EdgeTiming)
+	{
+		std::string edgeTimingMsg = Utils::StringFormat(
+				"SSR edges were %u us late on average, and %u us late at worst, over %u edges.",
+				edgeErrorSumCopyUs / edgesTimedCopy, worstEdgeErrorCopyUs, edgesTimedCopy
+		);
+		SerialHandler::SafeWriteLn(edgeTimingMsg, true);
+	}
+}
+
 /**
  * @brief  Used to instruct given functions to use their debug code.
  *
@@ -209,4 +743,5 @@ void HeaterControl::enableDebugTriggers()
 //	debug_UpdatePwmState = true;
 //	debug_SetHeaterPowerLevel = true;
 //	debug_setGpioState = true;
+//	debug_EdgeTiming = true;
 }
@@ -13,14 +13,66 @@
 
 #include <cstdint>
 
+#include "IO/MainsTimebase.h"
+
+struct hw_timer_s;
+
+// The mains frequency the heater is supplied at. Can be overridden with -DHEATER_MAINS_FREQUENCY_HZ=60.
+#ifndef HEATER_MAINS_FREQUENCY_HZ
+#define HEATER_MAINS_FREQUENCY_HZ   50
+#endif
+
+// The heating element's power rating, used to work out the energy it has delivered. Can be overridden with
+// -DHEATER_ELEMENT_WATTAGE=<n>.
+#ifndef HEATER_ELEMENT_WATTAGE
+#define HEATER_ELEMENT_WATTAGE      1500
+#endif
+
+// How long before each predicted zero crossing the SSR is switched in the mains synchronous mode, so it has settled by
+// the time the crossing comes. Can be overridden with -DHEATER_ZERO_CROSS_LEAD_US=<n>.
+#ifndef HEATER_ZERO_CROSS_LEAD_US
+#define HEATER_ZERO_CROSS_LEAD_US   500
+#endif
+
 /**
  * @brief  Contains the logic for the Heater Controller.
+ *
+ * The SSR is switched on for a share of each 2 second window. By default the main loop switches it by polling
+ * UpdatePwmState, so a slow loop pass makes the edges late. With HEATER_USE_HARDWARE_TIMER defined, a hardware timer
+ * interrupts once per switching step and switches the SSR itself, and the main loop only publishes the power level.
+ * Either way, how late the edges are is measured, and can be written to the Serial port with debug_EdgeTiming.
+ *
+ * With HEATER_USE_CYCLE_DISTRIBUTION defined, each mains cycle is switched on or off by a sigma-delta accumulator
+ * instead, which spreads the on cycles out evenly. The power level isn't rounded to a whole percent, and the part of a
+ * cycle that is left over carries on into the next window, so the average power matches the request exactly.
+ *
+ * With HEATER_MAINS_SYNCHRONOUS defined, each switching step is a half cycle of the mains, and the SSR is switched
+ * HEATER_ZERO_CROSS_LEAD_US before the zero crossing predicted by the mains timebase. A zero crossing SSR then conducts
+ * for exactly the half cycles it was asked to, and the on time is rounded to a whole number of half cycles, so the
+ * energy delivered in each window is known in advance. An odd number of half cycles is shifted on by one half cycle every
+ * other window, so the extra half cycle alternates polarity and no DC flows through the element. The timebase follows a zero crossing detector on
+ * HEATER_ZERO_CROSS_GPIO if one is fitted.
 */
 class HeaterControl
 {
 public:
+	/**
+	 * @brief  Contains data about when the SSR last switched, and when it is next due to switch. Lets other classes
+	 *         keep their measurements away from the switching noise.
+	*/
+	struct SwitchingData
+	{
+		bool IsSsrOn;
+		bool IsSwitchScheduled;
+		uint32_t MicrosValueAtLastSwitch;
+		uint32_t MicrosValueAtNextSwitch;
+		uint32_t SwitchCount;
+	};
+
 	static void Init();
 	static uint32_t GetCurrentPowerLevel();
+	static uint64_t GetEnergyDeliveredJoules();
+	static SwitchingData GetSwitchingData();
 	static void SetFanIsRunning(bool IsFanRunning);
 	static void SetHeaterPowerLevel(float NewPowerLevelPercent);
 	static void UpdatePwmState();
@@ -38,17 +90,62 @@ private:
 	static bool debug_UpdatePwmState;
 	static bool debug_SetHeaterPowerLevel;
 	static bool debug_setGpioState;
+	static bool debug_EdgeTiming;
 
 	static bool isFanRunning;
-	static uint8_t currentGpioState;
 	static uint32_t currentPowerLevelPercent;
+
+	// Shared with the switching step and zero crossing interrupts, which run on the same single core. The main loop only
+	// writes these, or reads the ones the interrupts write, with interrupts held off.
+	static uint8_t currentGpioState;
 	static uint32_t microsValueAtStartOfThisCycle;
 	static uint32_t currentDutyCycleOnTimeUs;
+	static uint32_t microsValueAtLastSwitch;
+	static uint32_t switchCount;
+	static uint64_t ssrOnTimeUs;
+	static uint32_t worstEdgeErrorUs;
+	static uint32_t edgeErrorSumUs;
+	static uint32_t edgesTimed;
+	static uint16_t switchingStepInWindow;
+	static uint32_t microsValueAtNextSwitchingStep;
+	static bool isSsrOnThisStep;
+	static uint32_t cycleOnFractionQ16;
+	static uint32_t cycleDistributionAccumulatorQ16;
 	static HeaterStates heaterState;
 
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	static MainsTimebase mainsTimebase;
+	static uint16_t onHalfCyclesPerWindow;
+	static bool isOddWindow;
+#endif
+
+#ifdef HEATER_USE_HARDWARE_TIMER
+	static hw_timer_s* switchingStepTimer;
+
+	static void initSwitchingStepTimer();
+	static void switchingStepInterruptHandler();
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	static void scheduleNextSwitchingStepInterrupt();
+#endif
+#else
+	static void updateSwitchingStepsFromLoop();
+#endif
+
+#if defined(HEATER_MAINS_SYNCHRONOUS) && defined(HEATER_ZERO_CROSS_GPIO)
+	static void zeroCrossingInterruptHandler();
+#endif
+
+	static bool startNextSwitchingStep();
+	static bool decideSwitchingStep(uint16_t StepInWindow, bool IsOddWindow, uint32_t* AccumulatorQ16, bool WasSsrOnLastStep);
+	static uint32_t getMicrosValueAtNextSwitchingStep();
+	static bool predictNextSteppedSwitch(SwitchingData* SwitchingData);
+
 	static void setHeaterSwitchedOffState();
 	static void setHeaterMaxPowerState();
 	static void setGpioState(uint8_t State);
+	static void writeSsrState(uint8_t State);
+	static void recordEdgeTiming(int32_t EdgeErrorUs);
+	static void reportEdgeTiming();
 
 	static void enableDebugTriggers();
 };
@@ -0,0 +1,157 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "MainsTimebase.h"
+
+#include <Arduino.h>
+
+
+#define ONE_SECOND_IN_US                    1000000
+#define PHASE_GAIN_DIVISOR                  4
+#define FREQUENCY_GAIN_DIVISOR              64
+#define MAX_FREQUENCY_DEVIATION_DIVISOR     50      // The period is kept within 2% of the nominal one.
+#define LOCK_WINDOW_US                      100
+#define CROSSINGS_INSIDE_LOCK_WINDOW_TO_LOCK    8
+#define CROSSINGS_REJECTED_TO_REACQUIRE     4
+
+
+/**
+ * @brief                  Starts the timebase free running at the nominal frequency, with a zero crossing one half cycle
+ *                         from now.
+ *
+ * @param  FrequencyHz     The nominal mains frequency, normally 50 or 60 Hz.
+ * @param  MicrosValueNow  The current value of micros().
+*/
+void MainsTimebase::Init(const uint32_t FrequencyHz, const uint32_t MicrosValueNow)
+{
+	nominalHalfCyclePeriodQ16 = static_cast<uint32_t>((static_cast<uint64_t>(ONE_SECOND_IN_US) << 16) / (2 * FrequencyHz));
+	halfCyclePeriodQ16 = nominalHalfCyclePeriodQ16;
+	microsValueAtNextZeroCrossing = MicrosValueNow;
+	nextZeroCrossingFractionQ16 = 0;
+	crossingsInsideLockWindow = 0;
+	crossingsRejectedInARow = 0;
+	moveNextZeroCrossing(static_cast<int32_t>(halfCyclePeriodQ16));
+}
+
+/**
+ * @brief               Corrects the timebase's phase and period from a zero crossing seen by the detector.
+ *
+ *                      The crossing is compared against whichever predicted crossing is nearest, so it doesn't matter
+ *                      whether the timebase has already been moved past it, or whether the detector only pulses once per
+ *                      cycle. A crossing more than a quarter of a half cycle out is treated as noise, unless several come
+ *                      in a row, in which case the timebase jumps straight to the detector's phase.
+ *
+ * @param  MicrosValue  The value of micros() when the zero crossing was detected.
+ *
+ * @note                Called from the zero crossing interrupt, so it mustn't write to the Serial port.
+*/
+void IRAM_ATTR MainsTimebase::RecordZeroCrossing(const uint32_t MicrosValue)
+{
+	const int32_t halfCyclePeriodUs = static_cast<int32_t>(halfCyclePeriodQ16 >> 16);
+	int32_t phaseErrorUs = static_cast<int32_t>(MicrosValue - microsValueAtNextZeroCrossing) % halfCyclePeriodUs;
+	if (phaseErrorUs > (halfCyclePeriodUs / 2))
+	{
+		phaseErrorUs -= halfCyclePeriodUs;
+	}
+	else if (phaseErrorUs < -(halfCyclePeriodUs / 2))
+	{
+		phaseErrorUs += halfCyclePeriodUs;
+	}
+	const int32_t phaseErrorQ16 = phaseErrorUs * (1 << 16);
+
+	if ((phaseErrorUs > (halfCyclePeriodUs / 4)) || (phaseErrorUs < -(halfCyclePeriodUs / 4)))
+	{
+		crossingsInsideLockWindow = 0;
+		crossingsRejectedInARow++;
+		if (crossingsRejectedInARow >= CROSSINGS_REJECTED_TO_REACQUIRE)
+		{
+			moveNextZeroCrossing(phaseErrorQ16);
+			crossingsRejectedInARow = 0;
+		}
+		return;
+	}
+	crossingsRejectedInARow = 0;
+
+	moveNextZeroCrossing(phaseErrorQ16 / PHASE_GAIN_DIVISOR);
+
+	const uint32_t maxDeviationQ16 = nominalHalfCyclePeriodQ16 / MAX_FREQUENCY_DEVIATION_DIVISOR;
+	halfCyclePeriodQ16 += static_cast<uint32_t>(phaseErrorQ16 / FREQUENCY_GAIN_DIVISOR);
+	if (halfCyclePeriodQ16 > (nominalHalfCyclePeriodQ16 + maxDeviationQ16))
+	{
+		halfCyclePeriodQ16 = nominalHalfCyclePeriodQ16 + maxDeviationQ16;
+	}
+	else if (halfCyclePeriodQ16 < (nominalHalfCyclePeriodQ16 - maxDeviationQ16))
+	{
+		halfCyclePeriodQ16 = nominalHalfCyclePeriodQ16 - maxDeviationQ16;
+	}
+
+	const bool isInsideLockWindow = (phaseErrorUs <= LOCK_WINDOW_US) && (phaseErrorUs >= -LOCK_WINDOW_US);
+	if (!isInsideLockWindow)
+	{
+		crossingsInsideLockWindow = 0;
+	}
+	else if (crossingsInsideLockWindow < CROSSINGS_INSIDE_LOCK_WINDOW_TO_LOCK)
+	{
+		crossingsInsideLockWindow++;
+	}
+}
+
+/**
+ * @brief  Moves the predicted zero crossing on by one half cycle.
+ *
+ * @note   Also called from the heater's timer interrupt, so it mustn't write to the Serial port.
+*/
+void IRAM_ATTR MainsTimebase::AdvanceHalfCycle()
+{
+	moveNextZeroCrossing(static_cast<int32_t>(halfCyclePeriodQ16));
+}
+
+/**
+ * @brief    Gets when the mains voltage is next predicted to cross zero.
+ *
+ * @returns  The value of micros() at the next zero crossing, rounded down to the microsecond.
+*/
+uint32_t IRAM_ATTR MainsTimebase::GetMicrosValueAtNextZeroCrossing() const
+{
+	return microsValueAtNextZeroCrossing;
+}
+
+/**
+ * @brief    Gets the half cycle period the timebase is currently running at.
+ *
+ * @returns  The half cycle period, rounded down to the microsecond.
+*/
+uint32_t MainsTimebase::GetHalfCyclePeriodUs() const
+{
+	return halfCyclePeriodQ16 >> 16;
+}
+
+/**
+ * @brief    Checks whether the timebase is locked to the detector.
+ *
+ * @returns  True if the last few zero crossings were all within LOCK_WINDOW_US of their predictions. False otherwise.
+*/
+bool MainsTimebase::IsLocked() const
+{
+	return (crossingsInsideLockWindow >= CROSSINGS_INSIDE_LOCK_WINDOW_TO_LOCK);
+}
+
+/**
+ * @brief             Moves the predicted zero crossing, keeping the fraction of a microsecond that doesn't fit.
+ *
+ * @param  OffsetQ16  How far to move it, in Q16.16 microseconds. Negative values move it earlier.
+*/
+void IRAM_ATTR MainsTimebase::moveNextZeroCrossing(const int32_t OffsetQ16)
+{
+	const int32_t fractionQ16 = static_cast<int32_t>(nextZeroCrossingFractionQ16) + OffsetQ16;
+	microsValueAtNextZeroCrossing += static_cast<uint32_t>(fractionQ16 >> 16);
+	nextZeroCrossingFractionQ16 = static_cast<uint32_t>(fractionQ16) & 0xFFFF;
+}
@@ -0,0 +1,47 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_MAINS_TIMEBASE_H
+#define ENGINEERING_PROJECT_MAINS_TIMEBASE_H
+
+#include <cstdint>
+
+/**
+ * @brief  Predicts when the mains voltage next crosses zero, by counting half cycles forwards from a phase locked loop.
+ *
+ * The half cycle period is kept in Q16.16 microseconds, so 60 Hz's 8333.33 us half cycle doesn't drift. Each zero
+ * crossing reported by a detector is compared against the nearest predicted one. A quarter of the difference corrects
+ * the phase straight away, and a sixty-fourth of it corrects the period, so the prediction follows the mains frequency
+ * as it wanders. Without a detector, the timebase free runs at the nominal frequency.
+ *
+ * This class is instantiable, so the heater firing benchmark can run its own copy against a simulated mains supply.
+*/
+class MainsTimebase
+{
+public:
+	void Init(uint32_t FrequencyHz, uint32_t MicrosValueNow);
+	void RecordZeroCrossing(uint32_t MicrosValue);
+	void AdvanceHalfCycle();
+	uint32_t GetMicrosValueAtNextZeroCrossing() const;
+	uint32_t GetHalfCyclePeriodUs() const;
+	bool IsLocked() const;
+
+private:
+	uint32_t nominalHalfCyclePeriodQ16 = 0;
+	uint32_t halfCyclePeriodQ16 = 0;
+	uint32_t microsValueAtNextZeroCrossing = 0;
+	uint32_t nextZeroCrossingFractionQ16 = 0;
+	uint8_t crossingsInsideLockWindow = 0;
+	uint8_t crossingsRejectedInARow = 0;
+
+	void moveNextZeroCrossing(int32_t OffsetQ16);
+};
+
+#endif //ENGINEERING_PROJECT_MAINS_TIMEBASE_H
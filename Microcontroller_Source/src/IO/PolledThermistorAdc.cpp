@@ -0,0 +1,96 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "PolledThermistorAdc.h"
+
+#include <Arduino.h>
+
+
+/**
+ * @brief  Sets up each channel's pin and the ADC's resolution.
+*/
+void PolledThermistorAdc::Init()
+{
+	for (uint8_t i = 0; i < channelCount; ++i)
+	{
+		pinMode(adcChannels[i], INPUT);
+	}
+	analogReadResolution(12);
+}
+
+/**
+ * @brief  Starts a new burst. The first sample is taken the next time the burst is polled.
+*/
+void PolledThermistorAdc::StartBurst()
+{
+	resetSamplesCollected();
+	microsValueAtBurstStart = micros();
+	microsValueAtLastSample = microsValueAtBurstStart - THERMISTOR_ADC_SAMPLE_PERIOD_US;
+}
+
+/**
+ * @brief   Takes a sample from every channel if enough time has passed since the last ones.
+ *
+ * @return  True once every sample in the burst has been collected. False otherwise.
+*/
+bool PolledThermistorAdc::IsBurstComplete()
+{
+	// Every channel is sampled on the same poll, so they all fill up together.
+	const uint16_t scansCollected = samplesCollected[0];
+	if (scansCollected >= burstLength)
+	{
+		return true;
+	}
+
+	if ((micros() - microsValueAtLastSample) < THERMISTOR_ADC_SAMPLE_PERIOD_US)
+	{
+		return false;
+	}
+
+	microsValueAtLastSample = micros();
+	for (uint8_t i = 0; i < channelCount; ++i)
+	{
+		samples[i][scansCollected] = analogRead(adcChannels[i]);
+		samplesCollected[i] = scansCollected + 1;
+	}
+
+	if (scansCollected + 1 < burstLength)
+	{
+		return false;
+	}
+
+	// Kept per scan, so the estimate still holds if the burst length changes before the next one.
+	const uint32_t scanPeriodUs = (microsValueAtLastSample - microsValueAtBurstStart) / burstLength;
+	lastScanPeriodUs = (scanPeriodUs > THERMISTOR_ADC_SAMPLE_PERIOD_US) ? scanPeriodUs : THERMISTOR_ADC_SAMPLE_PERIOD_US;
+	return true;
+}
+
+/**
+ * @brief  Stops the burst. Nothing runs in the background, so there is nothing to stop.
+*/
+void PolledThermistorAdc::StopBurst()
+{
+	resetSamplesCollected();
+}
+
+/**
+ * @brief                Estimates how long a burst takes to collect, from how far apart the last complete burst's samples
+ *                       ended up. Until a burst has completed, the samples are assumed to be THERMISTOR_ADC_SAMPLE_PERIOD_US
+ *                       apart.
+ *
+ * @param  BurstLength   The number of samples per channel the burst will collect.
+ *
+ * @return               The expected duration in microseconds.
+*/
+uint32_t PolledThermistorAdc::GetExpectedBurstDurationUs(const uint16_t BurstLength) const
+{
+	return static_cast<uint32_t>(BurstLength) * lastScanPeriodUs;
+}
@@ -0,0 +1,41 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_POLLEDTHERMISTORADC_H
+#define ENGINEERING_PROJECT_POLLEDTHERMISTORADC_H
+
+#include <cstdint>
+
+#include "IO/ThermistorAdc.h"
+
+/**
+ * @brief  Collects thermistor samples with analogRead, taking at most one sample per channel each time the burst is polled.
+ *
+ * Samples are at least THERMISTOR_ADC_SAMPLE_PERIOD_US apart, but the actual spacing depends on how often the main
+ * loop gets around to polling. Every channel is read back to back on the same poll, so extra channels don't make the
+ * burst any longer. Because of this, the expected burst duration is taken from how long the last burst actually took.
+*/
+class PolledThermistorAdc final : public ThermistorAdc
+{
+public:
+	void Init() final;
+	void StartBurst() final;
+	bool IsBurstComplete() final;
+	void StopBurst() final;
+	uint32_t GetExpectedBurstDurationUs(uint16_t BurstLength) const final;
+
+private:
+	uint32_t microsValueAtBurstStart = 0;
+	uint32_t microsValueAtLastSample = 0;
+	uint32_t lastScanPeriodUs = THERMISTOR_ADC_SAMPLE_PERIOD_US;
+};
+
+
+#endif //ENGINEERING_PROJECT_POLLEDTHERMISTORADC_H
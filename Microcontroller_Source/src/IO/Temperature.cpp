@@ -16,57 +16,162 @@
 #include "Temperature.h"
 
 #include <Arduino.h>
+#include <tuple>
+
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+// ADC1 channels each probe's voltage is read on. On the ESP32-C3 these match the GPIO numbers, and only GPIO 0 to 4 have
+// ADC1 channels. The current board uses all of them, so the inlet and element surface probes' channels have no default,
+// and have to be set in the build flags for whichever board they're fitted to.
+#define OUTLET_PROBE_ADC_CHANNEL            0
+#define PROBE_ADC_CHANNEL_NOT_SET           0xFF
+#ifndef INLET_PROBE_ADC_CHANNEL
+#define INLET_PROBE_ADC_CHANNEL             PROBE_ADC_CHANNEL_NOT_SET
+#endif
+#ifndef ELEMENT_SURFACE_PROBE_ADC_CHANNEL
+#define ELEMENT_SURFACE_PROBE_ADC_CHANNEL   PROBE_ADC_CHANNEL_NOT_SET
+#endif
+#define MAX_ADC1_CHANNEL                    4
+#define THERMO_RESISTOR_VSS_GPIO            10      // Powers every probe's divider, so they all charge together.
 
+/**
+ * @brief                        Checks that an extra probe's ADC channel has been set, exists on ADC1, and isn't on a pin
+ *                               the board or another probe already uses.
+ *
+ * @param  AdcChannel            The probe's ADC1 channel.
+ * @param  OtherProbeAdcChannel  The other extra probe's ADC1 channel, or PROBE_ADC_CHANNEL_NOT_SET.
+ *
+ * @returns                      True if the channel can be used. False otherwise.
+*/
+constexpr bool isExtraProbeAdcChannelFree(const uint8_t AdcChannel, const uint8_t OtherProbeAdcChannel)
+{
+	if ((AdcChannel > MAX_ADC1_CHANNEL) || (AdcChannel == OtherProbeAdcChannel))
+	{
+		return false;
+	}
 
-#define THERMO_RESISTOR_VOLTAGE_READ_GPIO   0
-#define THERMO_RESISTOR_VSS_GPIO            10
+	// Outlet probe, backlight, touch SDA, display DC, fan MOSFET, PWM and speed sense, SSR, touch SCL, display CS,
+	// thermistor supply, USB D- and D+, display SCLK and MOSI.
+	constexpr uint8_t usedGpios[] = {OUTLET_PROBE_ADC_CHANNEL, 1, 2, 3, 4, 5, 6, 7, 8, 9, THERMO_RESISTOR_VSS_GPIO, 18, 19, 20, 21};
+	const uint8_t probeGpio = AdcChannel;
+	for (const uint8_t usedGpio : usedGpios)
+	{
+		if (probeGpio == usedGpio)
+		{
+			return false;
+		}
+	}
+	return true;
+}
 
-#define NUM_TEMP_SAMPLES_PER_READING            200
-#define ZERO_DEGREES_C_THERMORESISTOR_VOLTAGE   170
-#define VOLTAGE_STEPS_BETWEEN_DEGREES_C         9
+static_assert((TEMPERATURE_PROBE_COUNT <= InletProbe) || isExtraProbeAdcChannelFree(INLET_PROBE_ADC_CHANNEL, ELEMENT_SURFACE_PROBE_ADC_CHANNEL),
+              "The inlet probe has no ADC channel, or its GPIO is already used by the outlet probe, backlight, touch, display, fan "
+              "or the other probe. Set INLET_PROBE_ADC_CHANNEL to a free ADC1 channel.");
+static_assert((TEMPERATURE_PROBE_COUNT <= ElementSurfaceProbe) || isExtraProbeAdcChannelFree(ELEMENT_SURFACE_PROBE_ADC_CHANNEL, INLET_PROBE_ADC_CHANNEL),
+              "The element surface probe has no ADC channel, or its GPIO is already used by the outlet probe, backlight, touch, "
+              "display, fan or the other probe. Set ELEMENT_SURFACE_PROBE_ADC_CHANNEL to a free ADC1 channel.");
+
+// Per unit correction added to every outlet probe reading. Can be set from the build flags, or for any probe at runtime
+// with SetCalibrationOffset.
+#ifndef TEMPERATURE_CALIBRATION_OFFSET_CENTI_DEG_C
+#define TEMPERATURE_CALIBRATION_OFFSET_CENTI_DEG_C  0
+#endif
 
 #define CAPACITOR_CHARGING_TIME_MS          (2)
 #define WAIT_TIME_AFTER_FAULT_MS            (100)
-#define WAIT_TIME_BETWEEN_SAMPLES_US        (100)
+
+#define HEATER_SWITCH_SETTLING_TIME_US      2000    // Kept clear either side of an SSR switch.
+#define MAX_BURST_DEFERRAL_MS               30      // Longest a reading is held back waiting for the SSR to settle.
+#define HEATER_PHASE_NOISE_REPORT_READINGS  100
+
+// Even a burst paced by hardware must finish before the next reading is due, or the thermistor is never switched off.
+static_assert(TEMPERATURE_READING_INTERVAL_MS > (CAPACITOR_CHARGING_TIME_MS + (THERMISTOR_ADC_SAMPLES_PER_BURST * THERMISTOR_ADC_SAMPLE_PERIOD_US / 1000)),
+              "The reading interval must be longer than a full burst.");
 
 #define PROBE_UNPLUGGED_MAX_VALUE 30
 #define PROBE_SHORT_CIRCUIT_MIN_VALUE 3900
 
+// Out of range samples are thrown away as noise, unless at least this much of the burst is out of range.
+#ifndef PROBE_FAULT_MIN_OUTLIER_PERCENT
+#define PROBE_FAULT_MIN_OUTLIER_PERCENT     25
+#endif
+
+// With TEMPERATURE_ADAPTIVE_OVERSAMPLING defined, the burst length is changed after every reading so that the noise left
+// in the averaged reading is close to the target, while staying between the minimum and maximum burst lengths.
+#ifndef TEMPERATURE_ADAPTIVE_MIN_SAMPLES
+#define TEMPERATURE_ADAPTIVE_MIN_SAMPLES            16
+#endif
+#ifndef TEMPERATURE_ADAPTIVE_MAX_SAMPLES
+#define TEMPERATURE_ADAPTIVE_MAX_SAMPLES            THERMISTOR_ADC_SAMPLES_PER_BURST
+#endif
+#ifndef TEMPERATURE_ADAPTIVE_TARGET_NOISE_ADC_CODES
+#define TEMPERATURE_ADAPTIVE_TARGET_NOISE_ADC_CODES 0.2f    // Standard deviation of the averaged reading. Roughly 0.02°C.
+#endif
+
+static_assert((TEMPERATURE_ADAPTIVE_MIN_SAMPLES >= 2) && (TEMPERATURE_ADAPTIVE_MIN_SAMPLES <= TEMPERATURE_ADAPTIVE_MAX_SAMPLES)
+              && (TEMPERATURE_ADAPTIVE_MAX_SAMPLES <= THERMISTOR_ADC_SAMPLES_PER_BURST),
+              "The adaptive oversampling bounds must fit within a burst, and need at least 2 samples to measure the noise.");
+
+
+bool Temperature::debug_ReduceBurstSamples = false;
+bool Temperature::debug_AdaptiveOversampling = false;
+bool Temperature::debug_HeaterPhaseNoise = false;
 
 bool Temperature::isFanSwitchedOn = false;
-bool Temperature::isPidControllerReadyForTempMeasurement = false;
-bool Temperature::isMostRecentTemperatureReadingsArrayInitialised = false;
-int16_t Temperature::numVoltageReadingsOutstanding = 0;
 uint32_t Temperature::startingMillisValue = 0;
-uint32_t Temperature::startingMicrosValue = 0;
+uint32_t Temperature::millisValueAtLastReadingStart = 0;
 uint32_t Temperature::targetWaitTimeMs = 0;
-uint32_t Temperature::targetWaitTimeUs = 0;
-uint32_t Temperature::waitTimeAfterReadingDoneMs = 0;
-uint64_t Temperature::thermoresistorReadingsAccumulatedSoFar = 0;
+uint32_t Temperature::totalOutlierSamples = 0;
+uint32_t Temperature::readingsWithOutliers = 0;
+#ifdef TEMPERATURE_ADAPTIVE_OVERSAMPLING
+uint16_t Temperature::samplesPerBurst = TEMPERATURE_ADAPTIVE_MAX_SAMPLES;
+#else
+uint16_t Temperature::samplesPerBurst = THERMISTOR_ADC_SAMPLES_PER_BURST;
+#endif
+uint32_t Temperature::microsValueAtBurstStart = 0;
+uint32_t Temperature::heaterSwitchCountAtBurstStart = 0;
+HeaterControl::SwitchingData Temperature::heaterSwitching = {};
+std::array<float, Temperature::HeaterPhaseCount> Temperature::heaterPhaseVarianceSums = {};
+std::array<uint16_t, Temperature::HeaterPhaseCount> Temperature::heaterPhaseReadingCounts = {};
 Temperature::TempReadingStage Temperature::currentStage = Temperature::TempReadingStage::Idle;
-std::array<float, 3> Temperature::mostRecentTemperatureReadings = {};
+const std::array<uint8_t, THERMISTOR_ADC_MAX_CHANNELS> Temperature::probeAdcChannels = {
+		OUTLET_PROBE_ADC_CHANNEL, INLET_PROBE_ADC_CHANNEL, ELEMENT_SURFACE_PROBE_ADC_CHANNEL
+};
+std::array<int32_t, TEMPERATURE_PROBE_COUNT> Temperature::calibrationOffsetsCentiDegC = {TEMPERATURE_CALIBRATION_OFFSET_CENTI_DEG_C};
+std::array<TempReadingResult, TEMPERATURE_PROBE_COUNT> Temperature::latestResults = {};
+std::array<ReadingRingBuffer<TempReadData, 32>, TEMPERATURE_PROBE_COUNT> Temperature::recentReadings;
+std::array<FilterPipeline<TEMPERATURE_FILTER_STAGES>, TEMPERATURE_PROBE_COUNT> Temperature::temperatureFilters;
+
+#ifdef TEMPERATURE_USE_CONTINUOUS_ADC
+ContinuousThermistorAdc Temperature::hardwareAdc;
+#else
+PolledThermistorAdc Temperature::hardwareAdc;
+#endif
+ThermistorAdc* Temperature::adc = &hardwareAdc;
 
 
 /**
- * @brief                              Initialises the Temperature class.
- *
- * @param  WaitTimeAfterReadingDoneMs  The time to wait after a temperature reading is completed, in ms.
+ * @brief  Initialises the Temperature class.
 */
-void Temperature::Init(uint32_t WaitTimeAfterReadingDoneMs)
+void Temperature::Init()
 {
+	enableDebugTriggers();
+
 	pinMode(THERMO_RESISTOR_VSS_GPIO, OUTPUT);
 	digitalWrite(THERMO_RESISTOR_VSS_GPIO, LOW);
 
-	pinMode(THERMO_RESISTOR_VOLTAGE_READ_GPIO, INPUT);
-	analogReadResolution(12);
-
-	waitTimeAfterReadingDoneMs = WaitTimeAfterReadingDoneMs - CAPACITOR_CHARGING_TIME_MS - (WAIT_TIME_BETWEEN_SAMPLES_US * NUM_TEMP_SAMPLES_PER_READING / 1000) + 1;
+	hardwareAdc.SetChannels(probeAdcChannels.data(), TEMPERATURE_PROBE_COUNT);
+	hardwareAdc.Init();
 }
 
 /**
- * @brief    Attempt to perform a temperature reading.
+ * @brief    Moves the background temperature reading along. A new reading is started every TEMPERATURE_READING_INTERVAL_MS.
  *
- * @returns  Data concerning the results of the reading attempt.
+ * @returns  Data concerning the results of the outlet probe's reading attempt. A successful result is only returned on
+ *           the call that completed the reading, which has also been added to the ring buffer by then. The other probes'
+ *           results are only available from their ring buffers and GetLatestResult.
 */
 TempReadData Temperature::Read()
 {
@@ -77,6 +182,12 @@ TempReadData Temperature::Read()
 	{
 		case Idle:
 		{
+			// The reading is held back while the SSR is switching, but never long enough to starve the consumers.
+			const bool canBeDeferred = ((millis() - millisValueAtLastReadingStart) < (TEMPERATURE_READING_INTERVAL_MS + MAX_BURST_DEFERRAL_MS));
+			if (canBeDeferred && !isBurstClearOfHeaterSwitching())
+			{
+				return tempReadData;
+			}
 			startChargingFilterCapacitor();
 			return tempReadData;
 		}
@@ -90,27 +201,21 @@ TempReadData Temperature::Read()
 			return tempReadData;
 		}
 
-		case CollectingTempSample:
-		{
-			return collectTempReading();
-		}
-
-		case WaitingForNextTempSample:
+		case CollectingTempSamples:
 		{
-			if (hasEnoughMicrosecondsElapsed())
+			if (!adc->IsBurstComplete())
 			{
-				currentStage = TempReadingStage::CollectingTempSample;
+				return tempReadData;
 			}
-			return tempReadData;
+			return collectTempReading();
 		}
 
-		case WaitingForPIDController:
+		case WaitingForNextReading:
 		{
-			tempReadData.Result = TempReadingResult::LockoutActive;
-			if (isPidControllerReadyForTempMeasurement)
+			// Readings are started a fixed interval apart, so the consumers see an evenly spaced series.
+			if ((millis() - millisValueAtLastReadingStart) >= TEMPERATURE_READING_INTERVAL_MS)
 			{
 				currentStage = TempReadingStage::Idle;
-				isPidControllerReadyForTempMeasurement = false;
 			}
 			return tempReadData;
 		}
@@ -144,11 +249,102 @@ void Temperature::SetFanPowerState(bool IsFanSwitchedOn)
 }
 
 /**
- * @brief  Set whether or not the PID Controller is ready for a new temperature reading.
+ * @brief                 Passes the heater's latest switching data to the class, so bursts can be kept clear of the
+ *                        SSR's switching noise.
+ *
+ * @param  SwitchingData  When the SSR last switched, and when it is next due to switch.
+*/
+void Temperature::SetHeaterSwitching(const HeaterControl::SwitchingData& SwitchingData)
+{
+	heaterSwitching = SwitchingData;
+}
+
+/**
+ * @brief                 Copies out a probe's most recent successful reading.
+ *
+ * @param  Probe          The probe to get the reading of. Must be one of the TEMPERATURE_PROBE_COUNT fitted probes.
+ * @param  LatestReading  Set to the most recent reading, if there has been one.
+ *
+ * @returns               True if a reading was copied. False if no reading has succeeded yet.
+*/
+bool Temperature::GetLatestReading(const TemperatureProbe Probe, TempReadData* LatestReading)
+{
+	return recentReadings[Probe].GetLatest(LatestReading);
+}
+
+/**
+ * @brief               Copies out a probe's most recent successful readings, oldest first.
+ *
+ * @param  Probe        The probe to get the readings of. Must be one of the TEMPERATURE_PROBE_COUNT fitted probes.
+ * @param  Readings     Array the readings are copied into. Must have room for MaxReadings.
+ * @param  MaxReadings  The most readings to copy. Up to 31 are kept.
+ *
+ * @returns             The number of readings copied.
+*/
+uint8_t Temperature::GetRecentReadings(const TemperatureProbe Probe, TempReadData* Readings, const uint8_t MaxReadings)
+{
+	return recentReadings[Probe].GetWindow(Readings, MaxReadings);
+}
+
+/**
+ * @brief         Gets the number of successful readings a probe has had so far. A consumer can compare it with the
+ *                count it saw last, to check for a new reading without copying one out.
+ *
+ * @param  Probe  The probe to get the count of. Must be one of the TEMPERATURE_PROBE_COUNT fitted probes.
+ *
+ * @returns       The number of successful readings since boot.
+*/
+uint32_t Temperature::GetReadingCount(const TemperatureProbe Probe)
+{
+	return recentReadings[Probe].GetWriteCount();
+}
+
+/**
+ * @brief         Gets the result of a probe's most recent reading, so a fault on a probe that doesn't cause a lockout
+ *                can still be reported.
+ *
+ * @param  Probe  The probe to get the result of. Must be one of the TEMPERATURE_PROBE_COUNT fitted probes.
+ *
+ * @returns       The result of the most recent reading. ProcessingCurrentRequest if the probe hasn't been read yet.
+*/
+TempReadingResult Temperature::GetLatestResult(const TemperatureProbe Probe)
+{
+	return latestResults[Probe];
+}
+
+/**
+ * @brief    Gets how many samples each probe is taking per reading. Only changes with TEMPERATURE_ADAPTIVE_OVERSAMPLING defined.
+ *
+ * @returns  The number of samples in the next burst.
+*/
+uint16_t Temperature::GetSamplesPerBurst()
+{
+	return samplesPerBurst;
+}
+
+/**
+ * @brief                  Sets the correction added to every reading from a probe, to make up for differences between units.
+ *
+ * @param  Probe           The probe to correct. Must be one of the TEMPERATURE_PROBE_COUNT fitted probes.
+ * @param  OffsetDegreesC  The correction in °C. Positive values make the readings hotter.
+*/
+void Temperature::SetCalibrationOffset(const TemperatureProbe Probe, const float OffsetDegreesC)
+{
+	calibrationOffsetsCentiDegC[Probe] = static_cast<int32_t>(OffsetDegreesC * 100.0f);
+}
+
+/**
+ * @brief       Changes where the thermistor samples come from. Any reading in progress is restarted.
+ *
+ * @param  Adc  The ADC to take samples from. Pass nullptr to go back to using the microcontroller's ADC.
 */
-void Temperature::SetPidReadyForNextTempReading()
+void Temperature::SetAdc(ThermistorAdc* Adc)
 {
-	isPidControllerReadyForTempMeasurement = true;
+	adc->StopBurst();
+	adc = (Adc != nullptr) ? Adc : &hardwareAdc;
+	adc->SetChannels(probeAdcChannels.data(), TEMPERATURE_PROBE_COUNT);
+	digitalWrite(THERMO_RESISTOR_VSS_GPIO, LOW);
+	currentStage = TempReadingStage::Idle;
 }
 
 /**
@@ -157,7 +353,10 @@ void Temperature::SetPidReadyForNextTempReading()
 void Temperature::startChargingFilterCapacitor()
 {
 	digitalWrite(THERMO_RESISTOR_VSS_GPIO, HIGH);
+	microsValueAtBurstStart = micros();
+	heaterSwitchCountAtBurstStart = heaterSwitching.SwitchCount;
 	startingMillisValue = millis();
+	millisValueAtLastReadingStart = startingMillisValue;
 	targetWaitTimeMs = CAPACITOR_CHARGING_TIME_MS;
 	currentStage = TempReadingStage::ChargingFilterCapacitor;
 }
@@ -167,69 +366,145 @@ void Temperature::startChargingFilterCapacitor()
 */
 void Temperature::beginCollectingTempReadings()
 {
-	numVoltageReadingsOutstanding = NUM_TEMP_SAMPLES_PER_READING;
-	currentStage = TempReadingStage::CollectingTempSample;
+	adc->SetBurstLength(samplesPerBurst);
+	adc->StartBurst();
+	currentStage = TempReadingStage::CollectingTempSamples;
 }
 
 /**
- * @brief    Collect a temperature reading.
+ * @brief    Turns the ADC's completed burst of samples into a temperature reading for each probe.
  *
- * @returns  Data concerning the results of the reading attempt.
+ * @returns  Data concerning the results of the outlet probe's reading attempt.
 */
 TempReadData Temperature::collectTempReading()
 {
-	TempReadData tempReadData {};
-
-	const uint32_t thermoVoltageBitmask = getThermoresistorVoltageReading();
+	digitalWrite(THERMO_RESISTOR_VSS_GPIO, LOW);
+	const uint32_t timestampMs = millis();
+	const bool wasHeaterSwitching = wasHeaterSwitchingDuringBurst();
 
-	const TempReadingResult tempReadingResult = checkVoltageReadingForFaults(thermoVoltageBitmask);
-	if (tempReadingResult != TempReadingResult::TempReadSuccessfully)
+	// Every probe shares the burst length, so it is set by whichever probe is noisiest.
+	float highestSampleVariance = 0.0f;
+	for (uint8_t probe = InletProbe; probe < TEMPERATURE_PROBE_COUNT; ++probe)
 	{
-		tempReadData.Result = tempReadingResult;
-		lockoutAfterThermoresistorFault();
-		return tempReadData;
+		const TempReadData probeReadData = reduceProbeReading(static_cast<TemperatureProbe>(probe), timestampMs, wasHeaterSwitching);
+		if ((probeReadData.Result == TempReadingResult::TempReadSuccessfully) && (probeReadData.SampleVariance > highestSampleVariance))
+		{
+			highestSampleVariance = probeReadData.SampleVariance;
+		}
 	}
 
-	if (!checkIfAllVoltageReadingsDone(thermoVoltageBitmask))
+	const TempReadData tempReadData = reduceProbeReading(OutletProbe, timestampMs, wasHeaterSwitching);
+	if (tempReadData.Result != TempReadingResult::TempReadSuccessfully)
 	{
-		tempReadData.Result = TempReadingResult::ProcessingCurrentRequest;
-		currentStage = TempReadingStage::WaitingForNextTempSample;
+		lockoutAfterThermoresistorFault();
 		return tempReadData;
 	}
 
-	const float mostRecentTemperatureReading = convertThermoresistorVoltagesToTemperature();
-	float averageOfRecentTemperatureReadings = 0.0;
-	for (int i = 0; i < mostRecentTemperatureReadings.size(); ++i)
+	recordHeaterPhaseNoise(wasHeaterSwitching, tempReadData.SampleVariance);
+
+#ifdef TEMPERATURE_ADAPTIVE_OVERSAMPLING
+	adaptSamplesPerBurst((tempReadData.SampleVariance > highestSampleVariance) ? tempReadData.SampleVariance : highestSampleVariance);
+#endif
+
+	currentStage = TempReadingStage::WaitingForNextReading;
+	return tempReadData;
+}
+
+/**
+ * @brief               Turns one probe's samples from the completed burst into a temperature reading, and adds it to
+ *                      the probe's ring buffer if it was successful.
+ *
+ * @param  Probe               The probe to reduce the samples of.
+ * @param  TimestampMs         The millis() value the burst was completed at.
+ * @param  WasHeaterSwitching  True if the SSR switched close enough to the burst to add noise to it.
+ *
+ * @returns                    Data concerning the results of the probe's reading attempt.
+*/
+TempReadData Temperature::reduceProbeReading(const TemperatureProbe Probe, const uint32_t TimestampMs, const bool WasHeaterSwitching)
+{
+	TempReadData tempReadData {};
+	tempReadData.WasHeaterSwitching = WasHeaterSwitching;
+
+	uint32_t averageAdcCode = 0;
+	tempReadData.SampleCount = adc->GetBurstLength();
+	tempReadData.Result = ReduceBurstSamples(adc->GetBurstSamples(Probe), tempReadData.SampleCount, &averageAdcCode,
+	                                         &tempReadData.OutlierSamples, &tempReadData.SampleVariance);
+	recordOutliers(Probe, tempReadData.OutlierSamples);
+	latestResults[Probe] = tempReadData.Result;
+	if (tempReadData.Result != TempReadingResult::TempReadSuccessfully)
 	{
-		if ((i >= (mostRecentTemperatureReadings.size() - 1)) || (!isMostRecentTemperatureReadingsArrayInitialised))
-		{
-			mostRecentTemperatureReadings[i] = mostRecentTemperatureReading;
-		}
-		else
-		{
-			mostRecentTemperatureReadings[i] = mostRecentTemperatureReadings[i + 1];
-		}
-		averageOfRecentTemperatureReadings += mostRecentTemperatureReadings[i];
+		return tempReadData;
 	}
 
-	isMostRecentTemperatureReadingsArrayInitialised = true;
-	tempReadData.Temp = averageOfRecentTemperatureReadings / mostRecentTemperatureReadings.size();
-	tempReadData.Result = TempReadingResult::TempReadSuccessfully;
+	const int32_t filteredCentiDegreesC = temperatureFilters[Probe].Apply(convertAdcCodeToCentiDegreesC(Probe, averageAdcCode));
+	tempReadData.Temp = static_cast<float>(filteredCentiDegreesC) * 0.01f;
+	tempReadData.TimestampMs = TimestampMs;
 
-	currentStage = TempReadingStage::WaitingForPIDController;
-	startingMillisValue = millis();
-	targetWaitTimeMs = waitTimeAfterReadingDoneMs;
+	recentReadings[Probe].Push(tempReadData);
 	return tempReadData;
 }
 
 /**
- * @brief    Get a reading from the thermistor.
+ * @brief                   Averages a burst of ADC samples, throwing away any that are out of range.
  *
- * @returns  The voltage reading from the microcontroller's ADC.
+ * @param  Samples          The burst of raw ADC samples.
+ * @param  SampleCount      The number of samples in the burst, counting from the start of Samples.
+ * @param  AverageAdcCode   Set to the average of the in range samples with THERMISTOR_ADC_CODE_FRACTIONAL_BITS
+ *                          fractional bits, if the burst didn't indicate a fault.
+ * @param  OutlierSamples   Set to the number of samples that were out of range.
+ * @param  SampleVariance   Set to the variance of the in range samples in ADC codes squared, if the burst didn't
+ *                          indicate a fault.
+ *
+ * @returns                 A fault if at least PROBE_FAULT_MIN_OUTLIER_PERCENT of the samples were out of range, or
+ *                          TempReadSuccessfully otherwise.
+ *
+ * @note                    Doesn't touch the hardware, so it can be run against samples from any source.
 */
-uint32_t Temperature::getThermoresistorVoltageReading()
+TempReadingResult Temperature::ReduceBurstSamples(const ThermistorAdc::burstSamples& Samples, uint16_t SampleCount,
+                                                  uint32_t* AverageAdcCode, uint16_t* OutlierSamples, float* SampleVariance)
 {
-	return analogRead(THERMO_RESISTOR_VOLTAGE_READ_GPIO);
+	if (SampleCount > Samples.size())
+	{
+		SampleCount = Samples.size();
+	}
+
+	uint32_t inRangeSampleSum = 0;
+	uint64_t inRangeSquaredSampleSum = 0;
+	uint16_t unpluggedSamples = 0;
+	uint16_t shortCircuitSamples = 0;
+	for (uint16_t i = 0; i < SampleCount; ++i)
+	{
+		const uint16_t sample = Samples[i];
+		switch (checkVoltageReadingForFaults(sample))
+		{
+			case ProbeUnplugged:
+				unpluggedSamples++;
+				break;
+
+			case ProbeShortCircuit:
+				shortCircuitSamples++;
+				break;
+
+			default:
+				inRangeSampleSum += sample;
+				inRangeSquaredSampleSum += static_cast<uint32_t>(sample) * sample;
+				break;
+		}
+	}
+
+	*OutlierSamples = unpluggedSamples + shortCircuitSamples;
+	if ((SampleCount == 0) || ((*OutlierSamples * 100u) >= (PROBE_FAULT_MIN_OUTLIER_PERCENT * SampleCount)))
+	{
+		return (unpluggedSamples >= shortCircuitSamples) ? TempReadingResult::ProbeUnplugged : TempReadingResult::ProbeShortCircuit;
+	}
+
+	const uint32_t inRangeSamples = SampleCount - *OutlierSamples;
+	*AverageAdcCode = (inRangeSampleSum << THERMISTOR_ADC_CODE_FRACTIONAL_BITS) / inRangeSamples;
+
+	// Sum of squared deviations, times the sample count, kept in integers so nothing is lost to rounding.
+	const uint64_t scaledSquaredDeviationSum = (inRangeSquaredSampleSum * inRangeSamples) - (static_cast<uint64_t>(inRangeSampleSum) * inRangeSampleSum);
+	*SampleVariance = (inRangeSamples < 2) ? 0.0f : static_cast<float>(scaledSquaredDeviationSum) / static_cast<float>(inRangeSamples * (inRangeSamples - 1));
+	return TempReadingResult::TempReadSuccessfully;
 }
 
 /**
@@ -255,71 +530,180 @@ TempReadingResult Temperature::checkVoltageReadingForFaults(const uint32_t Volta
 }
 
 /**
- * @brief                  Checks if all required ADC readings have been finished.
+ * @brief                   Converts an averaged thermistor reading into a temperature, and applies the probe's calibration offset.
  *
- * @param  VoltageBitmask  The most recent ADC reading.
+ * @param  Probe            The probe the reading came from.
+ * @param  AverageAdcCode   The average of the burst's ADC samples, with THERMISTOR_ADC_CODE_FRACTIONAL_BITS fractional bits.
  *
- * @returns                True if all readings have been taken. False otherwise.
+ * @returns                 The measured temperature in hundredths of a °C.
 */
-bool Temperature::checkIfAllVoltageReadingsDone(const uint32_t VoltageBitmask)
+int32_t Temperature::convertAdcCodeToCentiDegreesC(const TemperatureProbe Probe, const uint32_t AverageAdcCode)
 {
-	thermoresistorReadingsAccumulatedSoFar += VoltageBitmask;
-	numVoltageReadingsOutstanding -= 1;
-	if (numVoltageReadingsOutstanding <= 0)
+	return ThermistorLookupTable::ConvertToCentiDegreesC(AverageAdcCode) + calibrationOffsetsCentiDegC[Probe];
+}
+
+/**
+ * @brief    Checks if enough milliseconds have elapsed since a defined delay was set.
+ *
+ * @returns  True if enough time has passed. False otherwise.
+*/
+bool Temperature::hasEnoughMillisecondsElapsed()
+{
+	if ((millis() - startingMillisValue) >= targetWaitTimeMs)
 	{
 		return true;
 	}
 
-	startingMicrosValue = micros();
-	targetWaitTimeUs = WAIT_TIME_BETWEEN_SAMPLES_US;
 	return false;
 }
 
 /**
- * @brief    Converts all the measured thermistor readings into an averaged temperature reading.
+ * @brief                   Adds a reading's outliers to the running totals.
  *
- * @returns  The measured temperature in °C.
+ * @param  Probe            The probe the reading came from.
+ * @param  OutlierSamples   The number of samples that were thrown away from the reading.
 */
-float Temperature::convertThermoresistorVoltagesToTemperature()
+void Temperature::recordOutliers(const TemperatureProbe Probe, const uint16_t OutlierSamples)
 {
-	digitalWrite(THERMO_RESISTOR_VSS_GPIO, LOW);
+	if (OutlierSamples == 0)
+	{
+		return;
+	}
 
-	float averageVoltageReading = static_cast<float>(thermoresistorReadingsAccumulatedSoFar);
-	averageVoltageReading /= NUM_TEMP_SAMPLES_PER_READING;
-	thermoresistorReadingsAccumulatedSoFar = 0;
+	totalOutlierSamples += OutlierSamples;
+	readingsWithOutliers++;
 
-	const float temperature = (averageVoltageReading - ZERO_DEGREES_C_THERMORESISTOR_VOLTAGE) / VOLTAGE_STEPS_BETWEEN_DEGREES_C;
-	return temperature;
+	if (debug_ReduceBurstSamples)
+	{
+		std::string outliersMsg = Utils::StringFormat(
+				"Threw away %u out of range samples from thermistor %u. %u samples over %u readings so far.",
+				OutlierSamples, Probe, totalOutlierSamples, readingsWithOutliers
+		);
+		SerialHandler::SafeWriteLn(outliersMsg, true);
+	}
 }
 
 /**
- * @brief    Checks if enough milliseconds have elapsed since a defined delay was set.
+ * @brief    Checks that the SSR has settled since it last switched, and isn't due to switch again before a burst
+ *           started now would be finished.
  *
- * @returns  True if enough time has passed. False otherwise.
+ * @returns  True if a burst can be started without picking up switching noise. False otherwise.
 */
-bool Temperature::hasEnoughMillisecondsElapsed()
+bool Temperature::isBurstClearOfHeaterSwitching()
 {
-	if ((millis() - startingMillisValue) >= targetWaitTimeMs)
+	const uint32_t microsValueNow = micros();
+	if ((microsValueNow - heaterSwitching.MicrosValueAtLastSwitch) < HEATER_SWITCH_SETTLING_TIME_US)
+	{
+		return false;
+	}
+
+	if (!heaterSwitching.IsSwitchScheduled)
 	{
 		return true;
 	}
 
-	return false;
+	// A switch that's overdue will happen on the heater's next update, so it counts as about to happen.
+	const int32_t microsUntilNextSwitch = static_cast<int32_t>(heaterSwitching.MicrosValueAtNextSwitch - microsValueNow);
+	// The polled ADC's samples drift apart when the main loop is busy, so the ADC is asked rather than assuming its pace.
+	const uint32_t burstDurationUs = (CAPACITOR_CHARGING_TIME_MS * 1000) + adc->GetExpectedBurstDurationUs(samplesPerBurst);
+	return (microsUntilNextSwitch > 0) && (static_cast<uint32_t>(microsUntilNextSwitch) > (burstDurationUs + HEATER_SWITCH_SETTLING_TIME_US));
 }
 
 /**
- * @brief    Checks if enough microseconds have elapsed since a defined delay was set.
+ * @brief    Checks if the SSR switched during the burst that just finished, or so shortly before it that it hadn't settled.
  *
- * @returns  True if enough time has passed. False otherwise.
+ * @returns  True if the burst may have picked up switching noise. False otherwise.
 */
-bool Temperature::hasEnoughMicrosecondsElapsed()
+bool Temperature::wasHeaterSwitchingDuringBurst()
 {
-	if ((micros() - startingMicrosValue) >= targetWaitTimeUs)
+	if (heaterSwitching.SwitchCount != heaterSwitchCountAtBurstStart)
 	{
 		return true;
 	}
 
-	return false;
+	return (heaterSwitching.SwitchCount != 0) && ((microsValueAtBurstStart - heaterSwitching.MicrosValueAtLastSwitch) < HEATER_SWITCH_SETTLING_TIME_US);
+}
+
+/**
+ * @brief                      Adds a reading's sample variance to the totals for the heater phase it was taken in, and
+ *                             writes the average for each phase to the Serial port every HEATER_PHASE_NOISE_REPORT_READINGS.
+ *
+ * @param  WasHeaterSwitching  True if the SSR switched close to the burst.
+ * @param  SampleVariance      The variance of the burst's samples in ADC codes squared.
+*/
+void Temperature::recordHeaterPhaseNoise(const bool WasHeaterSwitching, const float SampleVariance)
+{
+	heaterPhases phase = heaterSwitching.IsSsrOn ? HeaterOn : HeaterOff;
+	if (WasHeaterSwitching)
+	{
+		phase = HeaterSwitching;
+	}
+	heaterPhaseVarianceSums[phase] += SampleVariance;
+	heaterPhaseReadingCounts[phase]++;
+
+	const uint32_t readingsRecorded = heaterPhaseReadingCounts[HeaterOff] + heaterPhaseReadingCounts[HeaterOn] + heaterPhaseReadingCounts[HeaterSwitching];
+	if (readingsRecorded < HEATER_PHASE_NOISE_REPORT_READINGS)
+	{
+		return;
+	}
+
+	if (debug_HeaterPhaseNoise)
+	{
+		std::array<float, HeaterPhaseCount> averageVariances = {};
+		for (uint8_t i = 0; i < HeaterPhaseCount; ++i)
+		{
+			averageVariances[i] = (heaterPhaseReadingCounts[i] > 0) ? (heaterPhaseVarianceSums[i] / heaterPhaseReadingCounts[i]) : 0.0f;
+		}
+
+		std::string phaseNoiseMsg = Utils::StringFormat(
+				"Sample variance by heater phase: off %0.2f (%u readings), on %0.2f (%u readings), switching %0.2f (%u readings).",
+				averageVariances[HeaterOff], heaterPhaseReadingCounts[HeaterOff], averageVariances[HeaterOn], heaterPhaseReadingCounts[HeaterOn],
+				averageVariances[HeaterSwitching], heaterPhaseReadingCounts[HeaterSwitching]
+		);
+		SerialHandler::SafeWriteLn(phaseNoiseMsg, true);
+	}
+
+	heaterPhaseVarianceSums.fill(0.0f);
+	heaterPhaseReadingCounts.fill(0);
+}
+
+/**
+ * @brief                   Picks the next burst length from how noisy the last burst was. The noise left after averaging
+ *                          n samples has a variance of SampleVariance / n, so n is chosen to bring that to the target.
+ *                          Bursts get longer straight away when the noise rises, but only shrink halfway towards the
+ *                          shorter length each time, so one quiet burst doesn't throw away the averaging.
+ *
+ * @param  SampleVariance   The variance of the last burst's samples in ADC codes squared.
+*/
+void Temperature::adaptSamplesPerBurst(const float SampleVariance)
+{
+	constexpr float targetVariance = TEMPERATURE_ADAPTIVE_TARGET_NOISE_ADC_CODES * TEMPERATURE_ADAPTIVE_TARGET_NOISE_ADC_CODES;
+	const float wantedSamples = SampleVariance / targetVariance;
+
+	uint16_t nextSamplesPerBurst = TEMPERATURE_ADAPTIVE_MAX_SAMPLES;
+	if (wantedSamples < TEMPERATURE_ADAPTIVE_MAX_SAMPLES)
+	{
+		nextSamplesPerBurst = static_cast<uint16_t>(wantedSamples) + 1;
+	}
+	if (nextSamplesPerBurst < TEMPERATURE_ADAPTIVE_MIN_SAMPLES)
+	{
+		nextSamplesPerBurst = TEMPERATURE_ADAPTIVE_MIN_SAMPLES;
+	}
+	if (nextSamplesPerBurst < samplesPerBurst)
+	{
+		nextSamplesPerBurst = samplesPerBurst - ((samplesPerBurst - nextSamplesPerBurst + 1) / 2);
+	}
+
+	if (debug_AdaptiveOversampling && (nextSamplesPerBurst != samplesPerBurst))
+	{
+		std::string oversamplingMsg = Utils::StringFormat(
+				"Burst length changed from %u to %u samples. Sample variance %0.2f codes squared.",
+				samplesPerBurst, nextSamplesPerBurst, SampleVariance
+		);
+		SerialHandler::SafeWriteLn(oversamplingMsg, true);
+	}
+
+	samplesPerBurst = nextSamplesPerBurst;
 }
 
 /**
@@ -327,13 +711,21 @@ bool Temperature::hasEnoughMicrosecondsElapsed()
 */
 void Temperature::lockoutAfterThermoresistorFault()
 {
+	adc->StopBurst();
 	digitalWrite(THERMO_RESISTOR_VSS_GPIO, LOW);
 	startingMillisValue = millis();
 	targetWaitTimeMs = WAIT_TIME_AFTER_FAULT_MS;
 	currentStage = TempReadingStage::FaultLockOut;
+}
 
-	numVoltageReadingsOutstanding = 0;
-	thermoresistorReadingsAccumulatedSoFar = 0;
+/**
+ * @brief  Sets which debug messages will be written to the Serial port.
+*/
+void Temperature::enableDebugTriggers()
+{
+//	debug_ReduceBurstSamples = true;
+//	debug_AdaptiveOversampling = true;
+//	debug_HeaterPhaseNoise = true;
 }
 
 #pragma clang diagnostic pop
@@ -15,6 +15,41 @@
 #include <cstdint>
 #include <utility>
 
+#include "IO/ContinuousThermistorAdc.h"
+#include "IO/HeaterControl.h"
+#include "IO/PolledThermistorAdc.h"
+#include "IO/TemperatureFilters.h"
+#include "IO/ThermistorAdc.h"
+#include "IO/ThermistorLookupTable.h"
+#include "Misc/ReadingRingBuffer.h"
+
+// How often a reading is started. Can be overridden with -DTEMPERATURE_READING_INTERVAL_MS=<n>. The continuous ADC's
+// bursts take a fixed 22 ms, so it can read every 100 ms. The polled ADC's bursts stretch out to as long as the main loop
+// takes to poll them 200 times, so it reads once per default loop time step, as the PID Controller used to ask it to.
+#ifndef TEMPERATURE_READING_INTERVAL_MS
+#ifdef TEMPERATURE_USE_CONTINUOUS_ADC
+#define TEMPERATURE_READING_INTERVAL_MS     100
+#else
+#define TEMPERATURE_READING_INTERVAL_MS     500
+#endif
+#endif
+
+// Number of thermistors fitted, counting through TemperatureProbe in order. Set it in the build flags on units with more
+// probes, e.g. -DTEMPERATURE_PROBE_COUNT=3 for the outlet, inlet and element surface probes.
+#ifndef TEMPERATURE_PROBE_COUNT
+#define TEMPERATURE_PROBE_COUNT             1
+#endif
+
+/**
+ * @brief  The thermistors that can be fitted. The outlet probe is the one the heater is regulated on, and is always fitted.
+*/
+enum TemperatureProbe : uint8_t
+{
+	OutletProbe,
+	InletProbe,
+	ElementSurfaceProbe
+};
+
 /**
  * @brief  All of the possible results of a temperature reading.
 */
@@ -29,58 +64,125 @@ enum TempReadingResult
 
 /**
  * @brief  Struct that contains the result of a temperature reading, and the measured temperature if successful in °C.
+ * The timestamp is the millis() value when the reading was completed. OutlierSamples is how many of the burst's samples
+ * were thrown away for being out of range. SampleCount is how many samples the burst had, and SampleVariance is the
+ * variance of the in range ones in ADC codes squared, which shows how noisy the probe is. WasHeaterSwitching is true if
+ * the heater's SSR switched during the burst or just before it, so the reading may have picked up switching noise.
 */
 struct TempReadData
 {
 	TempReadingResult Result;
 	float Temp;
+	uint32_t TimestampMs;
+	uint16_t OutlierSamples;
+	uint16_t SampleCount;
+	float SampleVariance;
+	bool WasHeaterSwitching;
 };
 
 /**
  * @brief  Contains the logic for the Temperature Controller.
+ *
+ * Readings are taken continuously at a fixed rate, and every successful reading is added to a ring buffer. Each consumer
+ * copies out the latest reading or a window of recent ones at whatever rate suits it.
+ *
+ * Every fitted probe is sampled in the same burst, sharing the capacitor charging time, and each probe has its own
+ * calibration offset, filter, fault check and ring buffer. Only a fault on the outlet probe locks the readings out, as
+ * the other probes are just reported.
+ *
+ * Bursts are held back for a few milliseconds when the heater's SSR is about to switch, or has only just switched, so
+ * the samples are taken while the mains wiring is quiet.
 */
 class Temperature
 {
 public:
-	static void Init(uint32_t WaitTimeAfterReadingDoneMs);
+	static void Init();
 	static TempReadData Read();
+	static bool GetLatestReading(TemperatureProbe Probe, TempReadData* LatestReading);
+	static uint8_t GetRecentReadings(TemperatureProbe Probe, TempReadData* Readings, uint8_t MaxReadings);
+	static uint32_t GetReadingCount(TemperatureProbe Probe);
+	static TempReadingResult GetLatestResult(TemperatureProbe Probe);
 	static void SetFanPowerState(bool IsFanSwitchedOn);
-	static void SetPidReadyForNextTempReading();
+	static void SetHeaterSwitching(const HeaterControl::SwitchingData& SwitchingData);
+	static void SetCalibrationOffset(TemperatureProbe Probe, float OffsetDegreesC);
+	static void SetAdc(ThermistorAdc* Adc);
+	static uint16_t GetSamplesPerBurst();
+	static TempReadingResult ReduceBurstSamples(const ThermistorAdc::burstSamples& Samples, uint16_t SampleCount,
+	                                            uint32_t* AverageAdcCode, uint16_t* OutlierSamples, float* SampleVariance);
 
 private:
+	static bool debug_ReduceBurstSamples;
+	static bool debug_AdaptiveOversampling;
+	static bool debug_HeaterPhaseNoise;
+
 	enum TempReadingStage
 	{
 		Idle,
 		ChargingFilterCapacitor,
-		CollectingTempSample,
-		WaitingForNextTempSample,
-		WaitingForPIDController,
+		CollectingTempSamples,
+		WaitingForNextReading,
 		FaultLockOut
 	};
 
+	enum heaterPhases
+	{
+		HeaterOff,
+		HeaterOn,
+		HeaterSwitching,
+		HeaterPhaseCount
+	};
+
 	static bool isFanSwitchedOn;
-	static bool isPidControllerReadyForTempMeasurement;
-	static bool isMostRecentTemperatureReadingsArrayInitialised;
-	static int16_t numVoltageReadingsOutstanding;
 	static uint32_t startingMillisValue;
-	static uint32_t startingMicrosValue;
+	static uint32_t millisValueAtLastReadingStart;
 	static uint32_t targetWaitTimeMs;
-	static uint32_t targetWaitTimeUs;
-	static uint32_t waitTimeAfterReadingDoneMs;
-	static uint64_t thermoresistorReadingsAccumulatedSoFar;
+	static uint32_t totalOutlierSamples;
+	static uint32_t readingsWithOutliers;
+	static uint16_t samplesPerBurst;
+	static uint32_t microsValueAtBurstStart;
+	static uint32_t heaterSwitchCountAtBurstStart;
+	static HeaterControl::SwitchingData heaterSwitching;
+	static std::array<float, HeaterPhaseCount> heaterPhaseVarianceSums;
+	static std::array<uint16_t, HeaterPhaseCount> heaterPhaseReadingCounts;
 	static TempReadingStage currentStage;
-	static std::array<float, 3> mostRecentTemperatureReadings;
+	static const std::array<uint8_t, THERMISTOR_ADC_MAX_CHANNELS> probeAdcChannels;
+	static std::array<int32_t, TEMPERATURE_PROBE_COUNT> calibrationOffsetsCentiDegC;
+	static std::array<TempReadingResult, TEMPERATURE_PROBE_COUNT> latestResults;
+	static std::array<ReadingRingBuffer<TempReadData, 32>, TEMPERATURE_PROBE_COUNT> recentReadings;
+
+	// Filter stages applied to every reading, in order. Set TEMPERATURE_FILTER_STAGES in the build flags to trade noise
+	// against lag, e.g. -DTEMPERATURE_FILTER_STAGES="MedianFilter<5>, ExponentialMovingAverageFilter<16384>".
+#ifndef TEMPERATURE_FILTER_STAGES
+#define TEMPERATURE_FILTER_STAGES MovingAverageFilter<3>
+#endif
+	static std::array<FilterPipeline<TEMPERATURE_FILTER_STAGES>, TEMPERATURE_PROBE_COUNT> temperatureFilters;
+
+	// Build with TEMPERATURE_USE_CONTINUOUS_ADC defined to collect samples with the ADC's DMA driver instead of analogRead.
+#ifdef TEMPERATURE_USE_CONTINUOUS_ADC
+	static ContinuousThermistorAdc hardwareAdc;
+#else
+	static PolledThermistorAdc hardwareAdc;
+#endif
+	static ThermistorAdc* adc;
 
 	static void startChargingFilterCapacitor();
 	static void beginCollectingTempReadings();
 	static TempReadData collectTempReading();
-	static uint32_t getThermoresistorVoltageReading();
+	static TempReadData reduceProbeReading(TemperatureProbe Probe, uint32_t TimestampMs, bool WasHeaterSwitching);
+	static bool isBurstClearOfHeaterSwitching();
+	static bool wasHeaterSwitchingDuringBurst();
+	static void recordHeaterPhaseNoise(bool WasHeaterSwitching, float SampleVariance);
 	static TempReadingResult checkVoltageReadingForFaults(uint32_t VoltageBitmask);
-	static bool checkIfAllVoltageReadingsDone(uint32_t VoltageBitmask);
-	static float convertThermoresistorVoltagesToTemperature();
+	static void recordOutliers(TemperatureProbe Probe, uint16_t OutlierSamples);
+	static void adaptSamplesPerBurst(float SampleVariance);
+	static int32_t convertAdcCodeToCentiDegreesC(TemperatureProbe Probe, uint32_t AverageAdcCode);
 	static bool hasEnoughMillisecondsElapsed();
-	static bool hasEnoughMicrosecondsElapsed();
 	static void lockoutAfterThermoresistorFault();
+
+	static void enableDebugTriggers();
+
+	static_assert((TEMPERATURE_PROBE_COUNT >= 1) && (TEMPERATURE_PROBE_COUNT <= THERMISTOR_ADC_MAX_CHANNELS),
+	              "TEMPERATURE_PROBE_COUNT must be between 1 and the number of channels the ADC can scan.");
 };
 
 
@@ -0,0 +1,218 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_TEMPERATUREFILTERS_H
+#define ENGINEERING_PROJECT_TEMPERATUREFILTERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+// Filter coefficients are passed as Q16 fixed point template parameters, so 65536 means 1.0.
+#define FILTER_COEFFICIENT_FRACTIONAL_BITS  16
+#define FILTER_COEFFICIENT_ONE              (1 << FILTER_COEFFICIENT_FRACTIONAL_BITS)
+
+
+/**
+ * @brief  Averages the most recent samples. A running sum is kept, so the cost doesn't grow with the window size.
+ *
+ * @tparam WindowSize  The number of samples averaged.
+*/
+template <uint8_t WindowSize>
+class MovingAverageFilter
+{
+	static_assert(WindowSize > 0, "A moving average needs at least one sample.");
+
+public:
+	int32_t Apply(const int32_t Sample)
+	{
+		if (!isPrimed)
+		{
+			window.fill(Sample);
+			runningSum = Sample * static_cast<int32_t>(WindowSize);
+			isPrimed = true;
+		}
+
+		runningSum += Sample - window[oldestIndex];
+		window[oldestIndex] = Sample;
+		oldestIndex = (oldestIndex + 1 < WindowSize) ? (oldestIndex + 1) : 0;
+		return runningSum / static_cast<int32_t>(WindowSize);
+	}
+
+private:
+	std::array<int32_t, WindowSize> window = {};
+	int32_t runningSum = 0;
+	uint8_t oldestIndex = 0;
+	bool isPrimed = false;
+};
+
+/**
+ * @brief  Exponential moving average. Each output moves a fixed fraction of the way towards the latest sample.
+ *
+ * @tparam AlphaQ16  The fraction moved each sample, in Q16. Smaller values filter more noise but lag further behind.
+*/
+template <int32_t AlphaQ16>
+class ExponentialMovingAverageFilter
+{
+	static_assert((AlphaQ16 > 0) && (AlphaQ16 <= FILTER_COEFFICIENT_ONE), "Alpha must be above 0 and no more than 1.");
+
+public:
+	int32_t Apply(const int32_t Sample)
+	{
+		const int64_t sampleQ16 = static_cast<int64_t>(Sample) << FILTER_COEFFICIENT_FRACTIONAL_BITS;
+		if (!isPrimed)
+		{
+			stateQ16 = sampleQ16;
+			isPrimed = true;
+		}
+
+		stateQ16 += ((sampleQ16 - stateQ16) * AlphaQ16) >> FILTER_COEFFICIENT_FRACTIONAL_BITS;
+		return static_cast<int32_t>(stateQ16 >> FILTER_COEFFICIENT_FRACTIONAL_BITS);
+	}
+
+private:
+	int64_t stateQ16 = 0;
+	bool isPrimed = false;
+};
+
+/**
+ * @brief  Outputs the median of the most recent samples, which throws away single sample spikes entirely.
+ *
+ * A sorted copy of the window is kept up to date by moving one sample out and one in, instead of sorting every time.
+ *
+ * @tparam WindowSize  The number of samples the median is taken from. Must be odd.
+*/
+template <uint8_t WindowSize>
+class MedianFilter
+{
+	static_assert((WindowSize % 2) == 1, "A median filter needs an odd window size.");
+
+public:
+	int32_t Apply(const int32_t Sample)
+	{
+		if (!isPrimed)
+		{
+			window.fill(Sample);
+			sortedWindow.fill(Sample);
+			isPrimed = true;
+		}
+
+		// Overwrite the oldest sample's slot in the sorted copy, then slide the new sample into place.
+		uint8_t sortedIndex = 0;
+		while (sortedWindow[sortedIndex] != window[oldestIndex])
+		{
+			sortedIndex++;
+		}
+		while ((sortedIndex > 0) && (sortedWindow[sortedIndex - 1] > Sample))
+		{
+			sortedWindow[sortedIndex] = sortedWindow[sortedIndex - 1];
+			sortedIndex--;
+		}
+		while ((sortedIndex + 1 < WindowSize) && (sortedWindow[sortedIndex + 1] < Sample))
+		{
+			sortedWindow[sortedIndex] = sortedWindow[sortedIndex + 1];
+			sortedIndex++;
+		}
+		sortedWindow[sortedIndex] = Sample;
+
+		window[oldestIndex] = Sample;
+		oldestIndex = (oldestIndex + 1 < WindowSize) ? (oldestIndex + 1) : 0;
+		return sortedWindow[WindowSize / 2];
+	}
+
+private:
+	std::array<int32_t, WindowSize> window = {};
+	std::array<int32_t, WindowSize> sortedWindow = {};
+	uint8_t oldestIndex = 0;
+	bool isPrimed = false;
+};
+
+/**
+ * @brief  General first order IIR filter: y[n] = b0 * x[n] + b1 * x[n-1] - a1 * y[n-1].
+ *
+ * For a low pass filter with unity gain at DC, the coefficients must satisfy b0 + b1 - a1 = 1.
+ *
+ * @tparam B0Q16  Coefficient applied to the latest sample, in Q16.
+ * @tparam B1Q16  Coefficient applied to the previous sample, in Q16.
+ * @tparam A1Q16  Coefficient applied to the previous output, in Q16.
+*/
+template <int32_t B0Q16, int32_t B1Q16, int32_t A1Q16>
+class FirstOrderIIRFilter
+{
+	static_assert((A1Q16 > -FILTER_COEFFICIENT_ONE) && (A1Q16 < FILTER_COEFFICIENT_ONE), "The filter is only stable when |a1| < 1.");
+
+public:
+	int32_t Apply(const int32_t Sample)
+	{
+		if (!isPrimed)
+		{
+			previousSample = Sample;
+			previousOutputQ16 = static_cast<int64_t>(Sample) << FILTER_COEFFICIENT_FRACTIONAL_BITS;
+			isPrimed = true;
+		}
+
+		previousOutputQ16 = (static_cast<int64_t>(B0Q16) * Sample) + (static_cast<int64_t>(B1Q16) * previousSample)
+		                    - ((previousOutputQ16 * A1Q16) >> FILTER_COEFFICIENT_FRACTIONAL_BITS);
+		previousSample = Sample;
+		return static_cast<int32_t>(previousOutputQ16 >> FILTER_COEFFICIENT_FRACTIONAL_BITS);
+	}
+
+private:
+	int64_t previousOutputQ16 = 0;
+	int32_t previousSample = 0;
+	bool isPrimed = false;
+};
+
+/**
+ * @brief  Passes each sample through a fixed chain of filter stages, in the order they are listed.
+ *
+ * The stages are stored by value, so the whole pipeline has a fixed size and never allocates.
+ *
+ * @tparam Stages  The filter stages. Each needs an int32_t Apply(int32_t) function.
+*/
+template <typename... Stages>
+class FilterPipeline
+{
+public:
+	int32_t Apply(const int32_t Sample)
+	{
+		return applyStages(Sample, std::index_sequence_for<Stages...>());
+	}
+
+	/**
+	 * @brief   Gets one of the stages, so it can be run on its own.
+	 *
+	 * @tparam  Index  The stage's position in the pipeline.
+	 *
+	 * @return  The stage.
+	*/
+	template <size_t Index>
+	auto& GetStage()
+	{
+		return std::get<Index>(stages);
+	}
+
+	static constexpr size_t StageCount = sizeof...(Stages);
+
+private:
+	std::tuple<Stages...> stages;
+
+	template <size_t... Indices>
+	int32_t applyStages(int32_t Sample, std::index_sequence<Indices...>)
+	{
+		((Sample = std::get<Indices>(stages).Apply(Sample)), ...);
+		return Sample;
+	}
+};
+
+
+#endif //ENGINEERING_PROJECT_TEMPERATUREFILTERS_H
@@ -0,0 +1,166 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_THERMISTORADC_H
+#define ENGINEERING_PROJECT_THERMISTORADC_H
+
+#include <array>
+#include <cstdint>
+
+#define THERMISTOR_ADC_SAMPLES_PER_BURST    200     // The longest burst. SetBurstLength can make them shorter.
+#define THERMISTOR_ADC_SAMPLE_PERIOD_US     100
+#define THERMISTOR_ADC_MAX_CHANNELS         3
+
+
+/**
+ * @brief  Interface for the ADC that measures the thermistor's voltage.
+ *
+ * Samples are collected in bursts. Once a burst has been started, IsBurstComplete must be polled until it returns true,
+ * after which the samples can be read out of the burst buffer. This keeps the Temperature class's reduction code
+ * independent of how the samples were actually collected.
+ *
+ * Several thermistors can be measured in the same burst. Their channels are scanned interleaved, so every channel gets a
+ * full burst of samples spread over the same window, and each channel's samples are kept in their own buffer.
+*/
+class ThermistorAdc
+{
+public:
+	typedef std::array<uint16_t, THERMISTOR_ADC_SAMPLES_PER_BURST> burstSamples;
+
+	virtual ~ThermistorAdc() = default;
+
+	/**
+	 * @brief                Sets which ADC1 channels are scanned in each burst. Must be called before Init.
+	 *
+	 * @param  AdcChannels   The channels to scan, in the order their buffers are numbered. On the ESP32-C3 each matches
+	 *                       its GPIO number.
+	 * @param  ChannelCount  The number of channels. Limited to THERMISTOR_ADC_MAX_CHANNELS.
+	*/
+	void SetChannels(const uint8_t* AdcChannels, uint8_t ChannelCount)
+	{
+		channelCount = (ChannelCount < THERMISTOR_ADC_MAX_CHANNELS) ? ChannelCount : THERMISTOR_ADC_MAX_CHANNELS;
+		for (uint8_t i = 0; i < channelCount; ++i)
+		{
+			adcChannels[i] = AdcChannels[i];
+		}
+		resetSamplesCollected();
+	}
+
+	/**
+	 * @brief                Sets how many samples each channel collects per burst. Takes effect from the next burst.
+	 *
+	 * @param  BurstLength   The number of samples per channel. Limited to between 1 and THERMISTOR_ADC_SAMPLES_PER_BURST.
+	*/
+	void SetBurstLength(const uint16_t BurstLength)
+	{
+		if (BurstLength < 1)
+		{
+			burstLength = 1;
+		}
+		else
+		{
+			burstLength = (BurstLength < THERMISTOR_ADC_SAMPLES_PER_BURST) ? BurstLength : THERMISTOR_ADC_SAMPLES_PER_BURST;
+		}
+	}
+
+	/**
+	 * @brief   Gets how many samples each channel collects per burst.
+	 *
+	 * @return  The number of samples per channel, which is how many of each burst buffer's samples are valid.
+	*/
+	uint16_t GetBurstLength() const
+	{
+		return burstLength;
+	}
+
+	/**
+	 * @brief                Estimates how long a burst takes to collect, from starting it to the last sample.
+	 *
+	 * @param  BurstLength   The number of samples per channel the burst will collect.
+	 *
+	 * @return               The expected duration in microseconds. By default this assumes every channel is sampled once
+	 *                       per THERMISTOR_ADC_SAMPLE_PERIOD_US, as the hardware paces the samples.
+	*/
+	virtual uint32_t GetExpectedBurstDurationUs(const uint16_t BurstLength) const
+	{
+		return static_cast<uint32_t>(BurstLength) * THERMISTOR_ADC_SAMPLE_PERIOD_US;
+	}
+
+	/**
+	 * @brief  Sets up the ADC hardware. Must be called once before the first burst.
+	*/
+	virtual void Init() = 0;
+
+	/**
+	 * @brief  Starts collecting a new burst of samples. Any samples from the previous burst are discarded.
+	*/
+	virtual void StartBurst() = 0;
+
+	/**
+	 * @brief   Collects any samples that are ready, and checks if the burst is finished.
+	 *
+	 * @return  True once every sample in the burst has been collected. False otherwise.
+	*/
+	virtual bool IsBurstComplete() = 0;
+
+	/**
+	 * @brief  Stops collecting samples, without waiting for the burst to finish.
+	*/
+	virtual void StopBurst() = 0;
+
+	/**
+	 * @brief                Gets the samples one channel collected in the last burst. Only valid once IsBurstComplete
+	 *                       has returned true.
+	 *
+	 * @param  ChannelIndex  The channel's position in the list given to SetChannels.
+	 *
+	 * @return               The channel's raw 12 bit ADC samples, in the order they were taken. Only the first
+	 *                       GetBurstLength samples are from the last burst.
+	*/
+	const burstSamples& GetBurstSamples(const uint8_t ChannelIndex) const
+	{
+		return samples[ChannelIndex];
+	}
+
+protected:
+	std::array<uint8_t, THERMISTOR_ADC_MAX_CHANNELS> adcChannels = {};
+	uint8_t channelCount = 1;
+	uint16_t burstLength = THERMISTOR_ADC_SAMPLES_PER_BURST;
+	std::array<burstSamples, THERMISTOR_ADC_MAX_CHANNELS> samples = {};
+	std::array<uint16_t, THERMISTOR_ADC_MAX_CHANNELS> samplesCollected = {};
+
+	/**
+	 * @brief  Empties every channel's burst buffer.
+	*/
+	void resetSamplesCollected()
+	{
+		samplesCollected.fill(0);
+	}
+
+	/**
+	 * @brief   Checks if every channel has collected a full burst.
+	 *
+	 * @return  True if every channel's burst buffer is full. False otherwise.
+	*/
+	bool isEveryChannelComplete() const
+	{
+		for (uint8_t i = 0; i < channelCount; ++i)
+		{
+			if (samplesCollected[i] < burstLength)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+
+#endif //ENGINEERING_PROJECT_THERMISTORADC_H
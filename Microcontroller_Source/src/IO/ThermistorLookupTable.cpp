@@ -0,0 +1,115 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "ThermistorLookupTable.h"
+
+
+#define INTERPOLATION_BITS      (THERMISTOR_TABLE_STEP_BITS + THERMISTOR_ADC_CODE_FRACTIONAL_BITS)
+#define INTERPOLATION_MASK      ((1u << INTERPOLATION_BITS) - 1)
+
+// The interpolated temperature must stay this close to the Beta equation across the unit's set point range.
+#define INTERPOLATION_CHECK_MIN_TEMPERATURE_C   (-20.0)
+#define INTERPOLATION_CHECK_MAX_TEMPERATURE_C   40.0
+#define MAX_INTERPOLATION_ERROR_C               0.085
+
+
+const std::array<int16_t, THERMISTOR_TABLE_ENTRIES> ThermistorLookupTable::table = ThermistorLookupTable::GenerateTable();
+
+
+/**
+ * @brief           Interpolates between the two table entries either side of an ADC reading.
+ *
+ * @param  Table    The lookup table to use.
+ * @param  AdcCode  The ADC reading, with THERMISTOR_ADC_CODE_FRACTIONAL_BITS fractional bits.
+ *
+ * @return          The temperature in hundredths of a °C.
+*/
+constexpr int32_t interpolateCentiDegreesC(const std::array<int16_t, THERMISTOR_TABLE_ENTRIES>& Table, const uint32_t AdcCode)
+{
+	const uint32_t index = AdcCode >> INTERPOLATION_BITS;
+	if (index >= (Table.size() - 1))
+	{
+		return Table.back();
+	}
+
+	const int32_t lowerEntry = Table[index];
+	const int32_t upperEntry = Table[index + 1];
+	const int32_t distanceIntoStep = static_cast<int32_t>(AdcCode & INTERPOLATION_MASK);
+	return lowerEntry + (((upperEntry - lowerEntry) * distanceIntoStep) >> INTERPOLATION_BITS);
+}
+
+/**
+ * @brief   Checks that the table only ever increases, so interpolating between neighbouring entries is valid.
+ *
+ * @return  True if every entry is at least as large as the one before it. False otherwise.
+*/
+constexpr bool isTableMonotonic()
+{
+	constexpr std::array<int16_t, THERMISTOR_TABLE_ENTRIES> generatedTable = ThermistorLookupTable::GenerateTable();
+	for (uint32_t i = 1; i < generatedTable.size(); ++i)
+	{
+		if (generatedTable[i] < generatedTable[i - 1])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+static_assert(isTableMonotonic(), "The thermistor lookup table must increase with the ADC code.");
+
+/**
+ * @brief   Checks every ADC code that falls between INTERPOLATION_CHECK_MIN_TEMPERATURE_C and
+ *          INTERPOLATION_CHECK_MAX_TEMPERATURE_C, fractional bits included, against the Beta equation.
+ *
+ * @return  True if the interpolation is always within MAX_INTERPOLATION_ERROR_C. False otherwise.
+*/
+constexpr bool isInterpolationErrorWithinBound()
+{
+	constexpr std::array<int16_t, THERMISTOR_TABLE_ENTRIES> generatedTable = ThermistorLookupTable::GenerateTable();
+	constexpr uint32_t adcCodesPerWholeCode = 1u << THERMISTOR_ADC_CODE_FRACTIONAL_BITS;
+	for (uint32_t adcCode = 0; adcCode < (THERMISTOR_TABLE_ADC_CODES * adcCodesPerWholeCode); ++adcCode)
+	{
+		const double exactTemperatureC = ThermistorLookupTable::CalculateTemperatureC(static_cast<double>(adcCode) / adcCodesPerWholeCode);
+		if (exactTemperatureC < INTERPOLATION_CHECK_MIN_TEMPERATURE_C)
+		{
+			continue;
+		}
+		if (exactTemperatureC > INTERPOLATION_CHECK_MAX_TEMPERATURE_C)
+		{
+			break;      // The curve only rises from here.
+		}
+
+		const double errorC = (interpolateCentiDegreesC(generatedTable, adcCode) / 100.0) - exactTemperatureC;
+		if ((errorC > MAX_INTERPOLATION_ERROR_C) || (errorC < -MAX_INTERPOLATION_ERROR_C))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+static_assert(isInterpolationErrorWithinBound(), "The thermistor lookup table's interpolation error is too large between -20 °C and 40 °C.");
+static_assert((ThermistorLookupTable::CalculateTemperatureC(170.0) > -0.1) && (ThermistorLookupTable::CalculateTemperatureC(170.0) < 0.1),
+              "The thermistor curve should agree with the old calibration at 0 °C.");
+static_assert((ThermistorLookupTable::CalculateTemperatureC(350.0) > 19.9) && (ThermistorLookupTable::CalculateTemperatureC(350.0) < 20.1),
+              "The thermistor curve should agree with the old calibration at 20 °C.");
+
+
+/**
+ * @brief           Converts an ADC reading into a temperature by interpolating between the two nearest table entries.
+ *
+ * @param  AdcCode  The ADC reading, with THERMISTOR_ADC_CODE_FRACTIONAL_BITS fractional bits.
+ *
+ * @return          The temperature in hundredths of a °C.
+*/
+int32_t ThermistorLookupTable::ConvertToCentiDegreesC(const uint32_t AdcCode)
+{
+	return interpolateCentiDegreesC(table, AdcCode);
+}
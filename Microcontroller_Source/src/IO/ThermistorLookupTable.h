@@ -0,0 +1,141 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_THERMISTORLOOKUPTABLE_H
+#define ENGINEERING_PROJECT_THERMISTORLOOKUPTABLE_H
+
+#include <array>
+#include <cstdint>
+
+// Beta model of the NTC thermistor.
+#define THERMISTOR_BETA                         3950.0
+#define THERMISTOR_NOMINAL_RESISTANCE_OHMS      10000.0
+#define THERMISTOR_NOMINAL_TEMPERATURE_K        298.15
+
+// The thermistor is on the high side of a divider. The divider's ratio is then scaled and offset on its way to the ADC.
+// The scale and offset were fitted so the table agrees with the old straight line calibration at 0 °C and 20 °C.
+#define THERMISTOR_DIVIDER_RESISTANCE_OHMS      10000.0
+#define THERMISTOR_ADC_CODE_AT_ZERO_RATIO       (-22.0)
+#define THERMISTOR_ADC_CODES_PER_RATIO          839.0
+
+#define THERMISTOR_TABLE_MIN_TEMPERATURE_C      (-40.0)
+#define THERMISTOR_TABLE_MAX_TEMPERATURE_C      150.0
+#define THERMISTOR_TABLE_ADC_CODES              4096
+#define THERMISTOR_TABLE_STEP_BITS              4       // One entry every 16 ADC codes.
+#define THERMISTOR_TABLE_ENTRIES                ((THERMISTOR_TABLE_ADC_CODES >> THERMISTOR_TABLE_STEP_BITS) + 1)
+
+// ADC codes passed to the table carry this many fractional bits, so averaged readings keep their resolution.
+#define THERMISTOR_ADC_CODE_FRACTIONAL_BITS     4
+
+
+/**
+ * @brief  Converts thermistor ADC readings into temperatures, using a lookup table generated at compile time.
+ *
+ * The table holds the temperature in hundredths of a °C for every 16th ADC code, and readings between entries are
+ * linearly interpolated with integer maths. Across -20 °C to 40 °C the interpolation stays within 0.085 °C of the Beta
+ * equation, which is checked at compile time.
+*/
+class ThermistorLookupTable
+{
+public:
+	static int32_t ConvertToCentiDegreesC(uint32_t AdcCode);
+
+	/**
+	 * @brief            Calculates a temperature from the Beta equation. This is what the lookup table is built from.
+	 *
+	 * @param  AdcCode   The ADC code, without any fractional bits.
+	 *
+	 * @return           The temperature in °C, clamped to the table's range.
+	*/
+	static constexpr double CalculateTemperatureC(const double AdcCode)
+	{
+		const double dividerRatio = (AdcCode - THERMISTOR_ADC_CODE_AT_ZERO_RATIO) / THERMISTOR_ADC_CODES_PER_RATIO;
+		if (dividerRatio <= 0.0)
+		{
+			return THERMISTOR_TABLE_MIN_TEMPERATURE_C;
+		}
+		if (dividerRatio >= 1.0)
+		{
+			return THERMISTOR_TABLE_MAX_TEMPERATURE_C;
+		}
+
+		const double thermistorResistance = THERMISTOR_DIVIDER_RESISTANCE_OHMS * (1.0 - dividerRatio) / dividerRatio;
+		const double inverseTemperatureK = (1.0 / THERMISTOR_NOMINAL_TEMPERATURE_K)
+		                                   + (naturalLog(thermistorResistance / THERMISTOR_NOMINAL_RESISTANCE_OHMS) / THERMISTOR_BETA);
+		const double temperatureC = (1.0 / inverseTemperatureK) - 273.15;
+
+		if (temperatureC < THERMISTOR_TABLE_MIN_TEMPERATURE_C)
+		{
+			return THERMISTOR_TABLE_MIN_TEMPERATURE_C;
+		}
+		if (temperatureC > THERMISTOR_TABLE_MAX_TEMPERATURE_C)
+		{
+			return THERMISTOR_TABLE_MAX_TEMPERATURE_C;
+		}
+		return temperatureC;
+	}
+
+	/**
+	 * @brief   Builds the lookup table from the Beta equation.
+	 *
+	 * @return  The temperature at every 16th ADC code, in hundredths of a °C.
+	*/
+	static constexpr std::array<int16_t, THERMISTOR_TABLE_ENTRIES> GenerateTable()
+	{
+		std::array<int16_t, THERMISTOR_TABLE_ENTRIES> generatedTable = {};
+		for (uint32_t i = 0; i < generatedTable.size(); ++i)
+		{
+			const double centiDegreesC = CalculateTemperatureC(static_cast<double>(i << THERMISTOR_TABLE_STEP_BITS)) * 100.0;
+			generatedTable[i] = static_cast<int16_t>(centiDegreesC + ((centiDegreesC >= 0.0) ? 0.5 : -0.5));
+		}
+		return generatedTable;
+	}
+
+private:
+	static const std::array<int16_t, THERMISTOR_TABLE_ENTRIES> table;
+
+	/**
+	 * @brief     Calculates the natural log. std::log can't be used in a constant expression.
+	 *
+	 * @param  X  The value to take the log of. Must be greater than zero.
+	 *
+	 * @return    The natural log of X.
+	*/
+	static constexpr double naturalLog(double X)
+	{
+		// Split X into m * 2^k with m in [1, 2), where the atanh series for ln(m) converges quickly.
+		int32_t powerOfTwo = 0;
+		while (X >= 2.0)
+		{
+			X /= 2.0;
+			++powerOfTwo;
+		}
+		while (X < 1.0)
+		{
+			X *= 2.0;
+			--powerOfTwo;
+		}
+
+		const double z = (X - 1.0) / (X + 1.0);
+		const double zSquared = z * z;
+		double zPower = z;
+		double atanhSum = 0.0;
+		for (int32_t n = 1; n < 40; n += 2)
+		{
+			atanhSum += zPower / n;
+			zPower *= zSquared;
+		}
+
+		return (powerOfTwo * 0.69314718055994530942) + (2.0 * atanhSum);
+	}
+};
+
+
+#endif //ENGINEERING_PROJECT_THERMISTORLOOKUPTABLE_H
@@ -0,0 +1,52 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_GAINSCHEDULEDATA_H
+#define ENGINEERING_PROJECT_GAINSCHEDULEDATA_H
+
+#include <array>
+#include <cstdint>
+
+// The most breakpoints a gain schedule can hold. Can be overridden with -DMAX_GAIN_SCHEDULE_BREAKPOINTS=<n>.
+#ifndef MAX_GAIN_SCHEDULE_BREAKPOINTS
+#define MAX_GAIN_SCHEDULE_BREAKPOINTS 8
+#endif
+
+/**
+ * @brief  Enum containing the temperatures a gain schedule can be looked up with.
+*/
+enum GainScheduleKeys
+{
+	ScheduleOnSetPoint,
+	ScheduleOnMeasuredTemperature
+};
+
+/**
+ * @brief  Struct containing the gains to use at a given temperature.
+*/
+struct GainScheduleBreakpoint
+{
+	float TemperatureDegCent;
+	float ProportionalGain;
+	float IntegralGain;
+	float DerivativeGain;
+};
+
+/**
+ * @brief  Struct containing the data for a gain schedule. Breakpoints must be in ascending order of temperature.
+*/
+struct GainScheduleInitData
+{
+	GainScheduleKeys Key;
+	uint8_t BreakpointCount;
+	std::array<GainScheduleBreakpoint, MAX_GAIN_SCHEDULE_BREAKPOINTS> Breakpoints;
+};
+
+#endif //ENGINEERING_PROJECT_GAINSCHEDULEDATA_H
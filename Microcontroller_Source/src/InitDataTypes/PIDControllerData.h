@@ -27,7 +27,11 @@ enum PIDSettings
 	DerivativeGain,
 	DerivativeTermMaxValue,
 	DerivativeTermMinValue,
-	OutputMaxValue
+	OutputMaxValue,
+	FeedforwardGain,
+	AmbientTemperature,
+
+	PIDSettingsCount    // Not a setting. Must stay last.
 };
 
 /**
@@ -45,6 +49,8 @@ struct PIDControllerInitData
 	float DerivativeTermMaxValue;
 	float DerivativeTermMinValue;
 	float OutputMaxValue;
+	float FeedforwardGain;
+	float AmbientTemperatureDegCent;
 };
 
 /**
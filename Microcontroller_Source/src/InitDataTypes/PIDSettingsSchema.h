@@ -0,0 +1,119 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_PIDSETTINGSSCHEMA_H
+#define ENGINEERING_PROJECT_PIDSETTINGSSCHEMA_H
+
+#include <array>
+#include <cstdint>
+
+#include "InitDataTypes/PIDControllerData.h"
+
+/**
+ * @brief  Enum containing the types a PID Controller setting can have.
+*/
+enum PIDSettingTypes
+{
+	FloatSetting,
+	IntSetting
+};
+
+/**
+ * @brief  Struct describing a single PID Controller setting.
+ *
+ * The SpinBox range is in the SpinBox's own units, so float settings are scaled by their decimal position.
+ * Settings without a row description aren't shown in the config screens.
+*/
+struct PIDSettingSchema
+{
+	PIDSettings Setting;
+	PIDSettingTypes Type;
+	const char* Name;
+	const char* RowDescription;
+	int32_t SpinboxRangeMin;
+	int32_t SpinboxRangeMax;
+	uint32_t SpinboxDecimalPosition;
+	float DefaultValue;
+	float PIDControllerInitData::* FloatInitData;
+	int32_t PIDControllerInitData::* IntInitData;
+};
+
+// Every PID Controller setting, in the same order as the PIDSettings enum.
+constexpr std::array<PIDSettingSchema, PIDSettingsCount> pidSettingsSchema = {{
+		{TemperatureSetPoint,    FloatSetting, "TemperatureSetPoint",    nullptr,                   0,      0,     0, 22.0,  &PIDControllerInitData::TemperatureSetPointDegCent, nullptr},
+		{LoopTimeStep,           IntSetting,   "LoopTimeStep",           "Loop Time\nStep (ms):",   1,      10000, 0, 500,   nullptr, &PIDControllerInitData::LoopTimeStepMs},
+		{ProportionalGain,       FloatSetting, "ProportionalGain",       "Proportion.\nGain:",      0,      10000, 2, 2.5,   &PIDControllerInitData::ProportionalGain, nullptr},
+		{IntegralGain,           FloatSetting, "IntegralGain",           "Integral\nGain:",         0,      10000, 2, 2.0,   &PIDControllerInitData::IntegralGain, nullptr},
+		{IntegralWindupLimitMax, FloatSetting, "IntegralWindupLimitMax", "Int. Wind.\nLimit Max:",  -10000, 10000, 3, 4.0,   &PIDControllerInitData::IntegralWindupLimitMax, nullptr},
+		{IntegralWindupLimitMin, FloatSetting, "IntegralWindupLimitMin", "Int. Wind.\nLimit Min:",  -10000, 10000, 3, -0.5,  &PIDControllerInitData::IntegralWindupLimitMin, nullptr},
+		{DerivativeGain,         FloatSetting, "DerivativeGain",         "Derivative\nGain:",       0,      10000, 2, 0.1,   &PIDControllerInitData::DerivativeGain, nullptr},
+		{DerivativeTermMaxValue, FloatSetting, "DerivativeTermMaxValue", "Deri. Term.\nLimit Max:", -10000, 10000, 3, 0.5,   &PIDControllerInitData::DerivativeTermMaxValue, nullptr},
+		{DerivativeTermMinValue, FloatSetting, "DerivativeTermMinValue", "Deri. Term\nLimit Min:",  -10000, 10000, 3, -10.0, &PIDControllerInitData::DerivativeTermMinValue, nullptr},
+		{OutputMaxValue,         FloatSetting, "OutputMaxValue",         "Output\nMax:",            0,      10000, 3, 100.0, &PIDControllerInitData::OutputMaxValue, nullptr},
+		{FeedforwardGain,        FloatSetting, "FeedforwardGain",        "Feedfwd.\nGain:",         0,      10000, 2, 0.0,   &PIDControllerInitData::FeedforwardGain, nullptr},
+		{AmbientTemperature,     FloatSetting, "AmbientTemperature",     "Ambient\nTemp.:",         -2000,  6000,  3, 20.0,  &PIDControllerInitData::AmbientTemperatureDegCent, nullptr}
+}};
+
+/**
+ * @brief   Checks that the schema is in enum order, and that every setting is linked to an init data field of its type.
+ *
+ * @return  True if the schema is valid. False otherwise.
+*/
+constexpr bool IsPIDSettingsSchemaValid()
+{
+	for (uint32_t i = 0; i < pidSettingsSchema.size(); ++i)
+	{
+		const PIDSettingSchema& schema = pidSettingsSchema[i];
+		const bool hasFloatInitData = (schema.FloatInitData != nullptr);
+		const bool hasIntInitData = (schema.IntInitData != nullptr);
+		if ((schema.Setting != i) || (hasFloatInitData == hasIntInitData) || (hasFloatInitData != (schema.Type == FloatSetting)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+static_assert(IsPIDSettingsSchemaValid(), "The PID settings schema must list every setting once, in enum order.");
+
+/**
+ * @brief           Looks up the schema for a setting.
+ *
+ * @param  Setting  The setting to look up.
+ *
+ * @return          The setting's schema.
+*/
+constexpr const PIDSettingSchema& GetPIDSettingSchema(const PIDSettings Setting)
+{
+	return pidSettingsSchema[Setting];
+}
+
+/**
+ * @brief   Builds the PID Controller's init data from the default value of every setting.
+ *
+ * @return  The default init data.
+*/
+constexpr PIDControllerInitData GetDefaultPIDControllerInitData()
+{
+	PIDControllerInitData initData = {};
+	for (const PIDSettingSchema& schema : pidSettingsSchema)
+	{
+		if (schema.Type == FloatSetting)
+		{
+			initData.*schema.FloatInitData = schema.DefaultValue;
+		}
+		else
+		{
+			initData.*schema.IntInitData = static_cast<int32_t>(schema.DefaultValue);
+		}
+	}
+	return initData;
+}
+
+#endif //ENGINEERING_PROJECT_PIDSETTINGSSCHEMA_H
@@ -0,0 +1,44 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_PROFILEDATA_H
+#define ENGINEERING_PROJECT_PROFILEDATA_H
+
+#include <cstdint>
+
+// The most steps a single set point profile can hold. Can be overridden with -DMAX_PROFILE_STEPS=<n>.
+#ifndef MAX_PROFILE_STEPS
+#define MAX_PROFILE_STEPS 32
+#endif
+
+/**
+ * @brief  Enum containing the commands a set point profile step can perform.
+*/
+enum ProfileCommands : uint8_t
+{
+	ProfileRamp,        // Moves the set point to Value (in 0.1°C) at Parameter (in 0.1°C/min). A rate of 0 jumps straight there.
+	ProfileSoak,        // Holds the set point for Value minutes.
+	ProfileRepeat,      // Jumps back to step Parameter, Value more times.
+	ProfileEnd          // Finishes the profile, leaving the set point where it is.
+};
+
+/**
+ * @brief  Struct containing a single set point profile step, packed into 4 bytes so that programs can be kept in flash.
+*/
+struct ProfileStep
+{
+	ProfileCommands Command;
+	uint8_t Parameter;
+	int16_t Value;
+};
+
+static_assert(sizeof(ProfileStep) == 4, "Profile steps should stay 4 bytes long.");
+
+#endif //ENGINEERING_PROJECT_PROFILEDATA_H
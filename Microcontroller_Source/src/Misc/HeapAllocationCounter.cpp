@@ -0,0 +1,132 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "HeapAllocationCounter.h"
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+#define REPORT_PERIOD_MS    (10 * 1000)
+
+
+std::atomic<uint32_t> allocationCount = {0};
+
+uint32_t HeapAllocationCounter::countAtStartOfLoop = 0;
+uint32_t HeapAllocationCounter::loopsMeasured = 0;
+uint32_t HeapAllocationCounter::loopsThatAllocated = 0;
+uint32_t HeapAllocationCounter::allocationsInLoops = 0;
+uint32_t HeapAllocationCounter::millisValueAtLastReport = 0;
+
+
+#ifdef COUNT_HEAP_ALLOCATIONS
+void* operator new(const std::size_t Size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	void* allocation = std::malloc((Size == 0) ? 1 : Size);
+	if (!allocation)
+	{
+		throw std::bad_alloc();
+	}
+	return allocation;
+}
+
+void* operator new[](const std::size_t Size)
+{
+	return operator new(Size);
+}
+
+void* operator new(const std::size_t Size, const std::nothrow_t&) noexcept
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc((Size == 0) ? 1 : Size);
+}
+
+void* operator new[](const std::size_t Size, const std::nothrow_t& NoThrow) noexcept
+{
+	return operator new(Size, NoThrow);
+}
+
+void operator delete(void* Allocation) noexcept
+{
+	std::free(Allocation);
+}
+
+void operator delete[](void* Allocation) noexcept
+{
+	std::free(Allocation);
+}
+
+void operator delete(void* Allocation, std::size_t) noexcept
+{
+	std::free(Allocation);
+}
+
+void operator delete[](void* Allocation, std::size_t) noexcept
+{
+	std::free(Allocation);
+}
+#endif
+
+
+/**
+ * @brief   Gets the number of heap allocations made since boot.
+ *
+ * @return  The number of allocations. Always 0 unless COUNT_HEAP_ALLOCATIONS is defined.
+*/
+uint32_t HeapAllocationCounter::GetCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief  Must be called at the very start of the main loop.
+*/
+void HeapAllocationCounter::StartOfLoop()
+{
+	countAtStartOfLoop = GetCount();
+}
+
+/**
+ * @brief  Must be called at the very end of the main loop. Periodically reports how many loops allocated.
+*/
+void HeapAllocationCounter::EndOfLoop()
+{
+	const uint32_t allocationsThisLoop = GetCount() - countAtStartOfLoop;
+	loopsMeasured++;
+	if (allocationsThisLoop > 0)
+	{
+		loopsThatAllocated++;
+		allocationsInLoops += allocationsThisLoop;
+	}
+
+	if ((millis() - millisValueAtLastReport) < REPORT_PERIOD_MS)
+	{
+		return;
+	}
+
+	// Building the report allocates, so it happens after this loop's count has been taken.
+	std::string reportMsg = Utils::StringFormat(
+			"Heap allocations: %u of %u loops allocated, %u allocations in total",
+			loopsThatAllocated, loopsMeasured, allocationsInLoops
+	);
+	SerialHandler::SafeWriteLn(reportMsg, true);
+
+	loopsMeasured = 0;
+	loopsThatAllocated = 0;
+	allocationsInLoops = 0;
+	millisValueAtLastReport = millis();
+}
@@ -0,0 +1,38 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_HEAPALLOCATIONCOUNTER_H
+#define ENGINEERING_PROJECT_HEAPALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * @brief  Checks that the main loop runs without allocating anything on the heap.
+ *
+ * When built with COUNT_HEAP_ALLOCATIONS defined, the global operator new is replaced with one that counts every call.
+ * The count is sampled at the start and end of each main loop, and any loop that allocated is reported to the Serial port.
+ * LVGL uses its own memory pool, so its allocations aren't counted.
+*/
+class HeapAllocationCounter
+{
+public:
+	static uint32_t GetCount();
+	static void StartOfLoop();
+	static void EndOfLoop();
+
+private:
+	static uint32_t countAtStartOfLoop;
+	static uint32_t loopsMeasured;
+	static uint32_t loopsThatAllocated;
+	static uint32_t allocationsInLoops;
+	static uint32_t millisValueAtLastReport;
+};
+
+#endif //ENGINEERING_PROJECT_HEAPALLOCATIONCOUNTER_H
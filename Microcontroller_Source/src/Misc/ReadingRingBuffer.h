@@ -0,0 +1,111 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_READINGRINGBUFFER_H
+#define ENGINEERING_PROJECT_READINGRINGBUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief  A fixed capacity ring buffer of readings, with one producer and any number of readers.
+ *
+ * Unlike a mailbox, readers don't remove anything. The producer always overwrites the oldest reading, and each reader
+ * copies out the latest reading or a window of recent ones whenever it wants them. A reader that gets lapped by the
+ * producer partway through a copy simply copies again, so neither side ever waits on a lock.
+ *
+ * @tparam  Reading   The type of reading held in the buffer.
+ * @tparam  Capacity  The number of slots in the buffer. Up to Capacity - 1 readings can be copied out at once, as the
+ *                    producer may be partway through overwriting the oldest slot.
+*/
+template <typename Reading, uint8_t Capacity>
+class ReadingRingBuffer
+{
+	static_assert(Capacity >= 2, "A reading ring buffer needs at least two slots.");
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "The ring buffer's write count must be lock free.");
+
+public:
+	/**
+	 * @brief              Adds a reading, overwriting the oldest one if the buffer is full. Must only be called by the producer.
+	 *
+	 * @param  NewReading  The reading to add.
+	*/
+	void Push(const Reading& NewReading)
+	{
+		const uint32_t currentWriteCount = writeCount.load(std::memory_order_relaxed);
+		slots[currentWriteCount % Capacity] = NewReading;
+		writeCount.store(currentWriteCount + 1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief   Gets the number of readings that have ever been pushed. Readers can use this to tell if there is a new one.
+	 *
+	 * @return  The number of readings pushed since the buffer was created.
+	*/
+	uint32_t GetWriteCount() const
+	{
+		return writeCount.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief                 Copies out the most recent reading.
+	 *
+	 * @param  LatestReading  Set to the most recent reading, if there is one.
+	 *
+	 * @return                True if a reading was copied. False if nothing has been pushed yet.
+	*/
+	bool GetLatest(Reading* LatestReading) const
+	{
+		return GetWindow(LatestReading, 1) == 1;
+	}
+
+	/**
+	 * @brief                Copies out the most recent readings, oldest first.
+	 *
+	 * @param  Readings      Array the readings are copied into. Must have room for MaxReadings.
+	 * @param  MaxReadings   The most readings to copy. Limited to one less than the buffer's capacity.
+	 *
+	 * @return               The number of readings copied. Fewer than MaxReadings if not enough have been pushed yet.
+	*/
+	uint8_t GetWindow(Reading* Readings, uint8_t MaxReadings) const
+	{
+		if (MaxReadings >= Capacity)
+		{
+			MaxReadings = Capacity - 1;
+		}
+
+		while (true)
+		{
+			const uint32_t writeCountBeforeCopy = writeCount.load(std::memory_order_acquire);
+			const uint8_t readingsToCopy = (writeCountBeforeCopy < MaxReadings) ? writeCountBeforeCopy : MaxReadings;
+			const uint32_t oldestWriteIndex = writeCountBeforeCopy - readingsToCopy;
+			for (uint8_t i = 0; i < readingsToCopy; ++i)
+			{
+				Readings[i] = slots[(oldestWriteIndex + i) % Capacity];
+			}
+
+			// The oldest slot copied only starts being overwritten once the producer has come all the way back around to it.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const uint32_t writeCountAfterCopy = writeCount.load(std::memory_order_relaxed);
+			if ((writeCountAfterCopy - oldestWriteIndex) < Capacity)
+			{
+				return readingsToCopy;
+			}
+		}
+	}
+
+private:
+	std::array<Reading, Capacity> slots = {};
+	std::atomic<uint32_t> writeCount = {0};
+};
+
+
+#endif //ENGINEERING_PROJECT_READINGRINGBUFFER_H
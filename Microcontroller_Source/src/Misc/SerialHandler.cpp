@@ -123,6 +123,25 @@ std::string SerialHandler::ReadAllDataAsString()
 	return result;
 }
 
+/**
+ * @brief               Write a line of text to the buffer.
+ *
+ * @param  TextOut      The text to add.
+ * @param  ShouldWrite  True if the data should actually be added. False otherwise.
+ *
+ * @note                Text literals go through here, so that they're only copied into a string (which may allocate)
+ *                      when they are actually going to be written.
+*/
+void SerialHandler::SafeWriteLn(const char* TextOut, const bool ShouldWrite)
+{
+	if (!ShouldWrite || BufferOverflowHappened)
+	{
+		return;
+	}
+
+	SafeWriteLn(std::string(TextOut), true);
+}
+
 /**
  * @brief               Write a line of text to the buffer.
  *
@@ -38,6 +38,7 @@ public:
 	static std::string ReadAllDataAsString();
 	static void SetState(bool Enable);
 	static void SafeWriteLn(const std::string& TextOut, bool ShouldWrite);
+	static void SafeWriteLn(const char* TextOut, bool ShouldWrite);
 	static void TryWriteBufferToSerial();
 
 private:
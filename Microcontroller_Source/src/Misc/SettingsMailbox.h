@@ -0,0 +1,98 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_SETTINGSMAILBOX_H
+#define ENGINEERING_PROJECT_SETTINGSMAILBOX_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "InitDataTypes/PIDControllerData.h"
+
+/**
+ * @brief  A fixed capacity ring buffer of settings packets, with one producer and one consumer.
+ *
+ * The storage is allocated statically, so pushing and popping packets never touches the heap.
+ * One slot is always left empty so that a full mailbox can be told apart from an empty one.
+ *
+ * @tparam  Packet    The type of packet held in the mailbox.
+ * @tparam  Capacity  The number of slots in the mailbox. Up to Capacity - 1 packets can be waiting at once.
+*/
+template <typename Packet, uint8_t Capacity>
+class SettingsMailbox
+{
+	static_assert(Capacity >= 2, "A settings mailbox needs at least two slots.");
+
+public:
+	/**
+	 * @brief             Adds a packet to the mailbox. Must only be called by the producer.
+	 *
+	 * @param  NewPacket  The packet to add.
+	 *
+	 * @return            True if the packet was added. False if the mailbox was full.
+	*/
+	bool Push(const Packet& NewPacket)
+	{
+		const uint8_t currentHead = head.load(std::memory_order_relaxed);
+		const uint8_t nextHead = nextSlot(currentHead);
+		if (nextHead == tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		slots[currentHead] = NewPacket;
+		head.store(nextHead, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief                Takes the oldest packet out of the mailbox. Must only be called by the consumer.
+	 *
+	 * @param  OldestPacket  Set to the oldest packet, if there was one.
+	 *
+	 * @return               True if a packet was taken. False if the mailbox was empty.
+	*/
+	bool Pop(Packet* OldestPacket)
+	{
+		const uint8_t currentTail = tail.load(std::memory_order_relaxed);
+		if (currentTail == head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		*OldestPacket = slots[currentTail];
+		tail.store(nextSlot(currentTail), std::memory_order_release);
+		return true;
+	}
+
+private:
+	std::array<Packet, Capacity> slots = {};
+	std::atomic<uint8_t> head = {0};
+	std::atomic<uint8_t> tail = {0};
+
+	static constexpr uint8_t nextSlot(const uint8_t Slot)
+	{
+		return (Slot + 1 == Capacity) ? 0 : Slot + 1;
+	}
+};
+
+/**
+ * @brief  The mailboxes that carry changed PID Controller settings from the Config screens to the main loop.
+*/
+class SettingsMailboxes
+{
+public:
+	static SettingsMailbox<PIDFloatDataPacket, 16> FloatSettings;
+	static SettingsMailbox<PIDIntDataPacket, 4> IntSettings;
+};
+
+
+#endif //ENGINEERING_PROJECT_SETTINGSMAILBOX_H
@@ -0,0 +1,204 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "UsageMeter.h"
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <tuple>
+
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+// How often the lifetime counters are written to flash. Can be overridden with -DUSAGE_METER_SAVE_INTERVAL_S=<n>.
+#ifndef USAGE_METER_SAVE_INTERVAL_S
+#define USAGE_METER_SAVE_INTERVAL_S     (15 * 60)
+#endif
+
+#define TELEMETRY_INTERVAL_MS           (60 * 1000)
+#define PREFERENCES_NAMESPACE           "usage"
+#define PREFERENCES_COUNTERS_KEY        "counters"
+#define COUNTERS_LAYOUT_VERSION         1           // Must be changed whenever persistedCounters is.
+#define JOULES_PER_WH                   3600.0f
+#define MS_PER_HOUR                     3600000.0f
+
+
+Preferences usageMeterPreferences;
+
+bool UsageMeter::debug_saveCounters = false;
+bool UsageMeter::debug_writeTelemetry = false;
+
+bool UsageMeter::isFanRunning = false;
+bool UsageMeter::haveCountersChangedSinceSave = false;
+uint32_t UsageMeter::lastSsrSwitchCount = 0;
+uint32_t UsageMeter::millisValueAtLastUpdate = 0;
+uint32_t UsageMeter::millisValueAtLastSave = 0;
+uint32_t UsageMeter::millisValueAtLastTelemetry = 0;
+uint64_t UsageMeter::sessionHeaterEnergyJoules = 0;
+UsageMeter::persistedCounters UsageMeter::lifetimeCounters = {COUNTERS_LAYOUT_VERSION, 0, 0, 0};
+
+
+/**
+ * @brief  Initialises the Usage Meter, and loads the lifetime counters from flash.
+*/
+void UsageMeter::Init()
+{
+	enableDebugTriggers();
+
+	loadCounters();
+
+	millisValueAtLastUpdate = millis();
+	millisValueAtLastSave = millisValueAtLastUpdate;
+	millisValueAtLastTelemetry = millisValueAtLastUpdate;
+}
+
+/**
+ * @brief                      Adds anything the heater and fan have done since the last call to the counters, and saves
+ *                             or reports them when due. Must be called every loop.
+ *
+ * @param  HeaterEnergyJoules  The energy the heater has delivered since boot.
+ * @param  SsrSwitchCount      The number of times the heater's SSR has switched since boot.
+*/
+void UsageMeter::Update(const uint64_t HeaterEnergyJoules, const uint32_t SsrSwitchCount)
+{
+	const uint32_t millisValueNow = millis();
+	const uint32_t millisSinceLastUpdate = millisValueNow - millisValueAtLastUpdate;
+	millisValueAtLastUpdate = millisValueNow;
+
+	// The Heater Controller's counts start from zero on boot, so its energy count is also this session's.
+	const uint64_t newHeaterEnergyJoules = HeaterEnergyJoules - sessionHeaterEnergyJoules;
+	const uint32_t newSsrSwitches = SsrSwitchCount - lastSsrSwitchCount;
+	sessionHeaterEnergyJoules = HeaterEnergyJoules;
+	lastSsrSwitchCount = SsrSwitchCount;
+
+	lifetimeCounters.HeaterEnergyJoules += newHeaterEnergyJoules;
+	lifetimeCounters.SsrSwitchCount += newSsrSwitches;
+	if (isFanRunning)
+	{
+		lifetimeCounters.FanRunMs += millisSinceLastUpdate;
+	}
+
+	if ((newHeaterEnergyJoules > 0) || (newSsrSwitches > 0) || isFanRunning)
+	{
+		haveCountersChangedSinceSave = true;
+	}
+
+	// An idle unit has nothing new to save, so it doesn't write to the flash at all.
+	if (haveCountersChangedSinceSave && ((millisValueNow - millisValueAtLastSave) >= (USAGE_METER_SAVE_INTERVAL_S * 1000)))
+	{
+		saveCounters();
+	}
+
+	// Off by default, as the lines would be interleaved with the PID Controller's graph output.
+	if (debug_writeTelemetry && ((millisValueNow - millisValueAtLastTelemetry) >= TELEMETRY_INTERVAL_MS))
+	{
+		writeTelemetry();
+	}
+}
+
+/**
+ * @brief                Tells the Usage Meter whether the fan is running, so it knows whether to count its run time.
+ *
+ * @param  IsFanRunning  True if the fan is spinning. False otherwise.
+*/
+void UsageMeter::SetFanIsRunning(const bool IsFanRunning)
+{
+	isFanRunning = IsFanRunning;
+}
+
+/**
+ * @brief    Gets the counters in the units they're displayed in.
+ *
+ * @returns  The session and lifetime counters.
+*/
+UsageMeter::UsageData UsageMeter::GetUsage()
+{
+	UsageData usageData = {};
+	usageData.SessionHeaterEnergyWh = static_cast<float>(sessionHeaterEnergyJoules) / JOULES_PER_WH;
+	usageData.LifetimeHeaterEnergyKWh = static_cast<float>(lifetimeCounters.HeaterEnergyJoules) / (JOULES_PER_WH * 1000.0f);
+	usageData.LifetimeSsrSwitchCount = lifetimeCounters.SsrSwitchCount;
+	usageData.LifetimeFanRunHours = static_cast<float>(lifetimeCounters.FanRunMs) / MS_PER_HOUR;
+	return usageData;
+}
+
+/**
+ * @brief  Loads the lifetime counters from flash. They start from zero if none were saved, or if they were saved by
+ *         firmware which laid them out differently.
+*/
+void UsageMeter::loadCounters()
+{
+	if (!usageMeterPreferences.begin(PREFERENCES_NAMESPACE, false))
+	{
+		SerialHandler::SafeWriteLn("Usage Meter: Couldn't open the flash's NVS partition. The lifetime counters won't be kept.", true);
+		return;
+	}
+
+	persistedCounters savedCounters = {};
+	if (usageMeterPreferences.getBytesLength(PREFERENCES_COUNTERS_KEY) != sizeof(savedCounters))
+	{
+		return;
+	}
+
+	std::ignore = usageMeterPreferences.getBytes(PREFERENCES_COUNTERS_KEY, &savedCounters, sizeof(savedCounters));
+	if (savedCounters.LayoutVersion == COUNTERS_LAYOUT_VERSION)
+	{
+		lifetimeCounters = savedCounters;
+	}
+}
+
+/**
+ * @brief  Writes the lifetime counters to flash, as a single blob so it only takes one write.
+*/
+void UsageMeter::saveCounters()
+{
+	millisValueAtLastSave = millis();
+	haveCountersChangedSinceSave = false;
+
+	const size_t bytesSaved = usageMeterPreferences.putBytes(PREFERENCES_COUNTERS_KEY, &lifetimeCounters, sizeof(lifetimeCounters));
+	if (bytesSaved != sizeof(lifetimeCounters))
+	{
+		SerialHandler::SafeWriteLn("Usage Meter: Couldn't save the lifetime counters to flash.", true);
+		return;
+	}
+
+	if (debug_saveCounters)
+	{
+		SerialHandler::SafeWriteLn("Usage Meter: Lifetime counters saved to flash.", true);
+	}
+}
+
+/**
+ * @brief  Writes the counters to the Serial port, in the same key:value format as the PID Controller's graph output.
+*/
+void UsageMeter::writeTelemetry()
+{
+	millisValueAtLastTelemetry = millis();
+
+	const UsageData usageData = GetUsage();
+	std::string telemetryMsg = Utils::StringFormat(
+			"SessionHeaterWh:%0.2f,LifetimeHeaterKWh:%0.3f,LifetimeSsrSwitches:%llu,LifetimeFanRunHours:%0.2f,",
+			usageData.SessionHeaterEnergyWh, usageData.LifetimeHeaterEnergyKWh,
+			static_cast<unsigned long long>(usageData.LifetimeSsrSwitchCount), usageData.LifetimeFanRunHours
+	);
+	SerialHandler::SafeWriteLn(telemetryMsg, true);
+}
+
+/**
+ * @brief  Used to instruct given functions to use their debug code.
+ *
+ * @note   Uncomment the booleans that represent the functions you want to debug.
+*/
+void UsageMeter::enableDebugTriggers()
+{
+//	debug_saveCounters = true;
+//	debug_writeTelemetry = true;
+}
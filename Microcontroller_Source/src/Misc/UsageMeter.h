@@ -0,0 +1,69 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_USAGEMETER_H
+#define ENGINEERING_PROJECT_USAGEMETER_H
+
+#include <cstdint>
+
+/**
+ * @brief  Keeps count of how much energy the heater has delivered, how many times its SSR has switched, and how long the
+ *         fan has run for, both for this session and over the unit's lifetime.
+ *
+ * The lifetime counters are kept in the flash's NVS partition as a single blob. To save wearing the flash, they are only
+ * written every USAGE_METER_SAVE_INTERVAL_S, and only if something has changed since the last write. Anything counted
+ * since then is lost if the power is cut. With debug_writeTelemetry enabled, the counters are also written to the Serial
+ * port every minute.
+*/
+class UsageMeter
+{
+public:
+	struct UsageData
+	{
+		float SessionHeaterEnergyWh;
+		float LifetimeHeaterEnergyKWh;
+		uint64_t LifetimeSsrSwitchCount;
+		float LifetimeFanRunHours;
+	};
+
+	static void Init();
+	static void Update(uint64_t HeaterEnergyJoules, uint32_t SsrSwitchCount);
+	static void SetFanIsRunning(bool IsFanRunning);
+	static UsageData GetUsage();
+
+private:
+	struct persistedCounters
+	{
+		uint32_t LayoutVersion;
+		uint64_t HeaterEnergyJoules;
+		uint64_t SsrSwitchCount;
+		uint64_t FanRunMs;
+	};
+
+	static bool debug_saveCounters;
+	static bool debug_writeTelemetry;
+
+	static bool isFanRunning;
+	static bool haveCountersChangedSinceSave;
+	static uint32_t lastSsrSwitchCount;
+	static uint32_t millisValueAtLastUpdate;
+	static uint32_t millisValueAtLastSave;
+	static uint32_t millisValueAtLastTelemetry;
+	static uint64_t sessionHeaterEnergyJoules;
+	static persistedCounters lifetimeCounters;
+
+	static void loadCounters();
+	static void saveCounters();
+	static void writeTelemetry();
+
+	static void enableDebugTriggers();
+};
+
+#endif //ENGINEERING_PROJECT_USAGEMETER_H
@@ -0,0 +1,284 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "ClosedLoopBenchmark.h"
+
+#include <Arduino.h>
+#include <array>
+#include <cmath>
+#include <tuple>
+
+#include "Control/PIDController.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+#include "Simulation/ThermalPlant.h"
+
+
+#define SIMULATION_TIME_STEP_MS     100
+#define SETTLING_BAND_DEG_CENT      0.5f
+#define CPU_CYCLES_PER_MICROSECOND  160
+#define MINUTES_TO_MS(minutes)      ((minutes) * 60 * 1000)
+#define SECONDS_TO_MS(seconds)      ((seconds) * 1000)
+#define MULTI_ZONE_LOOPS_TO_MEASURE 200
+#define SIMULATED_FAN_FULL_SPEED_RPM    3000
+
+
+const std::array<ClosedLoopBenchmark::scenario, ClosedLoopBenchmark::ScenarioCount> ClosedLoopBenchmark::scenarios = {{
+		{"Cold start", 10.0, 10.0, 0, 22.0, MINUTES_TO_MS(30), NoDisturbance, 0, 0},
+		{"Set point step", 10.0, 22.0, MINUTES_TO_MS(30), 30.0, MINUTES_TO_MS(30), NoDisturbance, 0, 0},
+		{"Fan stall", 10.0, 22.0, MINUTES_TO_MS(30), 22.0, MINUTES_TO_MS(15), FanStallDisturbance, SECONDS_TO_MS(60), SECONDS_TO_MS(60)},
+		{"Sensor dropout", 10.0, 22.0, MINUTES_TO_MS(30), 22.0, MINUTES_TO_MS(15), SensorDropoutDisturbance, SECONDS_TO_MS(60), SECONDS_TO_MS(45)}
+}};
+uint32_t ClosedLoopBenchmark::simulatedMillis = 0;
+MultiZonePIDController ClosedLoopBenchmark::multiZonePidController;
+
+
+/**
+ * @brief              Runs every scenario in turn and writes their results to the Serial port.
+ *
+ * @param  ConfigData  The PID Controller settings to evaluate.
+ *
+ * @note               The PID Controller is left paused and locked out afterwards, so it needs to be initialised again.
+*/
+void ClosedLoopBenchmark::RunAllScenarios(const PIDControllerInitData ConfigData)
+{
+	SerialHandler::SafeWriteLn("Running closed loop benchmark.", true);
+	PIDController::SetTimeSource(getSimulatedMillis);
+
+	for (const scenario& currentScenario : scenarios)
+	{
+		const ScenarioResults results = runScenario(currentScenario, ConfigData);
+		reportResults(currentScenario, results);
+	}
+
+	measureMultiZoneScaling(ConfigData);
+
+	PIDController::SetControlLoopIsEnabled(false);
+	PIDController::ActivateTemperatureLockout();
+	PIDController::Update();
+	PIDController::SetTimeSource(nullptr);
+}
+
+/**
+ * @brief              Simulates one of the scenarios on its own, and writes its results to the Serial port.
+ *
+ * @param  Scenario    The scenario to simulate.
+ * @param  ConfigData  The PID Controller settings to evaluate.
+ *
+ * @return             The scenario's results. Only the time after the warm up period is measured.
+ *
+ * @note               The PID Controller is left running, so it needs to be initialised again.
+*/
+ClosedLoopBenchmark::ScenarioResults ClosedLoopBenchmark::RunScenario(const Scenarios Scenario, const PIDControllerInitData ConfigData)
+{
+	PIDController::SetTimeSource(getSimulatedMillis);
+	const ScenarioResults results = runScenario(scenarios[Scenario], ConfigData);
+	PIDController::SetTimeSource(nullptr);
+
+	reportResults(scenarios[Scenario], results);
+	return results;
+}
+
+/**
+ * @brief              Simulates a single scenario.
+ *
+ * @param  Scenario    The scenario to simulate.
+ * @param  ConfigData  The PID Controller settings to evaluate.
+ *
+ * @return             The scenario's results. Only the time after the warm up period is measured.
+*/
+ClosedLoopBenchmark::ScenarioResults ClosedLoopBenchmark::runScenario(const scenario& Scenario, PIDControllerInitData ConfigData)
+{
+	ScenarioResults results = {};
+	simulatedMillis = 0;
+	ThermalPlant::Init(Scenario.AmbientTemperatureDegCent);
+
+	ConfigData.TemperatureSetPointDegCent = Scenario.WarmUpSetPointDegCent;
+	PIDController::Init(ConfigData);
+	PIDController::SetControlLoopIsEnabled(false);
+	PIDController::Update();        // Clears anything left over from the previous scenario.
+	PIDController::SetControlLoopIsEnabled(true);
+
+	const uint32_t totalDurationMs = Scenario.WarmUpDurationMs + Scenario.DurationMs;
+	const uint32_t disturbanceStartMs = Scenario.WarmUpDurationMs + Scenario.DisturbanceStartMs;
+	const uint32_t disturbanceEndMs = disturbanceStartMs + Scenario.DisturbanceDurationMs;
+	uint32_t millisValueAtLastTimeOutsideBand = Scenario.WarmUpDurationMs;
+	bool hasSetPointBeenApplied = (Scenario.WarmUpDurationMs == 0);
+	if (hasSetPointBeenApplied)
+	{
+		std::ignore = PIDController::ChangeTemperatureSetPoint(Scenario.SetPointDegCent - PIDController::GetTemperatureSetPoint());
+	}
+
+	while (simulatedMillis < totalDurationMs)
+	{
+		simulatedMillis += SIMULATION_TIME_STEP_MS;
+		const bool isBeingMeasured = (simulatedMillis > Scenario.WarmUpDurationMs);
+		const bool isDisturbanceActive = (simulatedMillis > disturbanceStartMs) && (simulatedMillis <= disturbanceEndMs);
+
+		if (isBeingMeasured && !hasSetPointBeenApplied)
+		{
+			std::ignore = PIDController::ChangeTemperatureSetPoint(Scenario.SetPointDegCent - PIDController::GetTemperatureSetPoint());
+			hasSetPointBeenApplied = true;
+		}
+
+		// The Temperature class samples in the background, so a fresh reading is available every simulation step.
+		const bool isSensorDroppedOut = isDisturbanceActive && (Scenario.Disturbance == SensorDropoutDisturbance);
+		if (!isSensorDroppedOut)
+		{
+			PIDController::SetCurrentTemperature(ThermalPlant::GetSensorTemperature(), simulatedMillis);
+		}
+
+		const uint32_t cycleCountBeforeUpdate = ESP.getCycleCount();
+		PIDController::Update();
+		const uint32_t cyclesTaken = ESP.getCycleCount() - cycleCountBeforeUpdate;
+
+		// Like main.cpp, the PID Controller's duty cycle drives both the fan and heater.
+		const float dutyCycle = PIDController::GetCurrentDutyCyclePercent();
+		const bool isFanStalled = isDisturbanceActive && (Scenario.Disturbance == FanStallDisturbance);
+		ThermalPlant::SetFanStalled(isFanStalled);
+		ThermalPlant::Step(static_cast<float>(SIMULATION_TIME_STEP_MS) / 1000, dutyCycle, dutyCycle);
+		PIDController::SetCurrentFanRpm(isFanStalled ? 0 : static_cast<uint32_t>(dutyCycle / 100 * SIMULATED_FAN_FULL_SPEED_RPM));
+
+		if (!isBeingMeasured)
+		{
+			std::ignore = PIDController::HasNewLoopRunSinceLastCheck();
+			continue;
+		}
+
+		if (PIDController::HasNewLoopRunSinceLastCheck())
+		{
+			results.LoopsRun++;
+			results.LoopCyclesTotal += cyclesTaken;
+			if (cyclesTaken > results.LoopCyclesMax)
+			{
+				results.LoopCyclesMax = cyclesTaken;
+			}
+		}
+
+		const float error = ThermalPlant::GetAirTemperature() - Scenario.SetPointDegCent;
+		const float absoluteError = std::fabs(error);
+		const float timeStepSeconds = static_cast<float>(SIMULATION_TIME_STEP_MS) / 1000;
+		const float secondsSinceMeasurementStarted = static_cast<float>(simulatedMillis - Scenario.WarmUpDurationMs) / 1000;
+
+		results.IntegratedAbsoluteError += absoluteError * timeStepSeconds;
+		results.IntegratedTimeWeightedAbsoluteError += secondsSinceMeasurementStarted * absoluteError * timeStepSeconds;
+		if (error > results.OvershootDegCent)
+		{
+			results.OvershootDegCent = error;
+		}
+		if (absoluteError > SETTLING_BAND_DEG_CENT)
+		{
+			millisValueAtLastTimeOutsideBand = simulatedMillis;
+		}
+	}
+
+	// If the temperature was still outside the band at the end, it never settled.
+	results.SettlingTimeSeconds = (millisValueAtLastTimeOutsideBand == totalDurationMs) ? -1.0f :
+	                              static_cast<float>(millisValueAtLastTimeOutsideBand - Scenario.WarmUpDurationMs) / 1000;
+	return results;
+}
+
+/**
+ * @brief            Writes a scenario's results to the Serial port.
+ *
+ * @param  Scenario  The scenario that was simulated.
+ * @param  Results   The scenario's results.
+*/
+void ClosedLoopBenchmark::reportResults(const scenario& Scenario, const ScenarioResults& Results)
+{
+	std::string controlQualityMsg = Utils::StringFormat(
+			"%s: settling time: %0.1fs, overshoot: %0.2f°C, IAE: %0.1f, ITAE: %0.0f",
+			Scenario.Name, Results.SettlingTimeSeconds, Results.OvershootDegCent,
+			Results.IntegratedAbsoluteError, Results.IntegratedTimeWeightedAbsoluteError
+	);
+	SerialHandler::SafeWriteLn(controlQualityMsg, true);
+
+	if (Results.LoopsRun == 0)
+	{
+		return;
+	}
+
+	const float averageLoopNs = static_cast<float>(Results.LoopCyclesTotal) / Results.LoopsRun * 1000 / CPU_CYCLES_PER_MICROSECOND;
+	const float maxLoopNs = static_cast<float>(Results.LoopCyclesMax) * 1000 / CPU_CYCLES_PER_MICROSECOND;
+	std::string cpuCostMsg = Utils::StringFormat(
+			"%s: %u loops, Update took %0.0fns on average and %0.0fns at most",
+			Scenario.Name, Results.LoopsRun, averageLoopNs, maxLoopNs
+	);
+	SerialHandler::SafeWriteLn(cpuCostMsg, true);
+}
+
+/**
+ * @brief              Measures how long the Multi-Zone PID Controller takes per zone, for every zone count it supports,
+ *                     and writes the results to the Serial port.
+ *
+ * @param  ConfigData  The settings given to every zone.
+*/
+void ClosedLoopBenchmark::measureMultiZoneScaling(const PIDControllerInitData ConfigData)
+{
+	for (uint8_t zoneCount = 1; zoneCount <= MAX_PID_ZONES; ++zoneCount)
+	{
+		const float averageLoopNs = MeasureMultiZoneUpdateNs(zoneCount, ConfigData);
+		std::string multiZoneMsg = Utils::StringFormat(
+				"Multi-zone, %u zones: Update took %0.0fns per loop, %0.0fns per zone",
+				zoneCount, averageLoopNs, averageLoopNs / zoneCount
+		);
+		SerialHandler::SafeWriteLn(multiZoneMsg, true);
+	}
+}
+
+/**
+ * @brief              Measures how long the Multi-Zone PID Controller's Update takes with a given number of zones.
+ *
+ * @param  ZoneCount   The number of zones to run, up to MAX_PID_ZONES.
+ * @param  ConfigData  The settings given to every zone.
+ *
+ * @return             The average time each Update took, in nanoseconds.
+*/
+float ClosedLoopBenchmark::MeasureMultiZoneUpdateNs(const uint8_t ZoneCount, const PIDControllerInitData ConfigData)
+{
+	multiZonePidController.SetTimeSource(getSimulatedMillis);
+	simulatedMillis = 0;
+	multiZonePidController.Init(ZoneCount, ConfigData.LoopTimeStepMs);
+	for (uint8_t zone = 0; zone < ZoneCount; ++zone)
+	{
+		multiZonePidController.ConfigureZone(zone, ConfigData);
+		multiZonePidController.SetZoneIsEnabled(zone, true);
+	}
+
+	uint64_t cyclesTotal = 0;
+	for (uint32_t loop = 0; loop < MULTI_ZONE_LOOPS_TO_MEASURE; ++loop)
+	{
+		simulatedMillis += ConfigData.LoopTimeStepMs;
+
+		// Give every zone a different error, so that none of them sit in the dead band.
+		for (uint8_t zone = 0; zone < ZoneCount; ++zone)
+		{
+			multiZonePidController.SetCurrentTemperature(zone, ConfigData.TemperatureSetPointDegCent - 1.0f - (0.5f * zone) + (0.01f * (loop % 10)));
+		}
+
+		const uint32_t cycleCountBeforeUpdate = ESP.getCycleCount();
+		std::ignore = multiZonePidController.Update();
+		cyclesTotal += ESP.getCycleCount() - cycleCountBeforeUpdate;
+	}
+
+	multiZonePidController.SetTimeSource(nullptr);
+	return static_cast<float>(cyclesTotal) / MULTI_ZONE_LOOPS_TO_MEASURE * 1000 / CPU_CYCLES_PER_MICROSECOND;
+}
+
+/**
+ * @brief   Used as the PID Controller's time source while scenarios are running.
+ *
+ * @return  The simulated number of milliseconds since the scenario started.
+*/
+uint32_t ClosedLoopBenchmark::getSimulatedMillis()
+{
+	return simulatedMillis;
+}
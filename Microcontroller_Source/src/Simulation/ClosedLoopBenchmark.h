@@ -0,0 +1,88 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_CLOSED_LOOP_BENCHMARK_H
+#define ENGINEERING_PROJECT_CLOSED_LOOP_BENCHMARK_H
+
+#include <array>
+#include <cstdint>
+
+#include "Control/MultiZonePIDController.h"
+#include "InitDataTypes/PIDControllerData.h"
+
+/**
+ * @brief  Runs the PID Controller against the Thermal Plant model, and reports how well and how quickly it controls it.
+ *
+ * Time is simulated, so a scenario covering half an hour finishes in well under a second. Each scenario reports its
+ * settling time, overshoot, IAE and ITAE, plus how long the PID Controller's Update function took to execute.
+ * Afterwards, the Multi-Zone PID Controller's cost per zone is measured for every zone count it supports.
+ *
+ * Add -DPID_CLOSED_LOOP_BENCHMARK to the build flags to run the scenarios once on boot, before the normal firmware starts.
+ * The native tests run the same scenarios on the host, and check their results against fixed limits.
+*/
+class ClosedLoopBenchmark
+{
+public:
+	enum Scenarios : uint8_t
+	{
+		ColdStart,
+		SetPointStep,
+		FanStall,
+		SensorDropout,
+		ScenarioCount
+	};
+
+	struct ScenarioResults
+	{
+		float SettlingTimeSeconds;
+		float OvershootDegCent;
+		float IntegratedAbsoluteError;
+		float IntegratedTimeWeightedAbsoluteError;
+		uint32_t LoopsRun;
+		uint64_t LoopCyclesTotal;
+		uint32_t LoopCyclesMax;
+	};
+
+	static void RunAllScenarios(PIDControllerInitData ConfigData);
+	static ScenarioResults RunScenario(Scenarios Scenario, PIDControllerInitData ConfigData);
+	static float MeasureMultiZoneUpdateNs(uint8_t ZoneCount, PIDControllerInitData ConfigData);
+
+private:
+	enum disturbances
+	{
+		NoDisturbance,
+		FanStallDisturbance,
+		SensorDropoutDisturbance
+	};
+
+	struct scenario
+	{
+		const char* Name;
+		float AmbientTemperatureDegCent;
+		float WarmUpSetPointDegCent;
+		uint32_t WarmUpDurationMs;
+		float SetPointDegCent;
+		uint32_t DurationMs;
+		disturbances Disturbance;
+		uint32_t DisturbanceStartMs;
+		uint32_t DisturbanceDurationMs;
+	};
+
+	static const std::array<scenario, ScenarioCount> scenarios;
+	static uint32_t simulatedMillis;
+	static MultiZonePIDController multiZonePidController;
+
+	static ScenarioResults runScenario(const scenario& Scenario, PIDControllerInitData ConfigData);
+	static void reportResults(const scenario& Scenario, const ScenarioResults& Results);
+	static void measureMultiZoneScaling(PIDControllerInitData ConfigData);
+	static uint32_t getSimulatedMillis();
+};
+
+#endif //ENGINEERING_PROJECT_CLOSED_LOOP_BENCHMARK_H
@@ -0,0 +1,198 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "EstimatorBenchmark.h"
+
+#include <cmath>
+
+#include "Control/TemperatureEstimator.h"
+#include "IO/Temperature.h"
+#include "IO/TemperatureFilters.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+#include "Simulation/ThermalPlant.h"
+
+
+#define AMBIENT_TEMPERATURE_DEG_CENT    10.0f
+#define SIMULATED_DURATION_MS           (90 * 60 * 1000)
+#define WARM_UP_DURATION_MS             (60 * 1000)         // Errors aren't counted until everything has had time to start up.
+#define POWER_PROFILE_PERIOD_MS         (20 * 60 * 1000)
+#define SENSOR_NOISE_DEG_CENT           0.05f
+#define SIMULATED_FAN_FULL_SPEED_RPM    3000
+
+
+uint32_t EstimatorBenchmark::noiseSeed = 1;
+
+
+/**
+ * @brief  Runs the power profile through the Thermal Plant, and writes how well each method tracked it to the Serial port.
+*/
+void EstimatorBenchmark::Run()
+{
+	SerialHandler::SafeWriteLn("Running temperature estimator benchmark.", true);
+
+	const Results results = Measure();
+	reportErrors("Raw readings", results.RawReadings);
+	reportErrors("3 sample moving average", results.MovingAverage);
+	reportErrors("Estimator", results.Estimator);
+}
+
+/**
+ * @brief   Runs the power profile through the Thermal Plant, and measures how well each method tracked it.
+ *
+ * @return  Each method's errors against the true air temperature.
+*/
+EstimatorBenchmark::Results EstimatorBenchmark::Measure()
+{
+	ThermalPlant::Init(AMBIENT_TEMPERATURE_DEG_CENT);
+	TemperatureEstimator::Init(AMBIENT_TEMPERATURE_DEG_CENT);
+	FilterPipeline<MovingAverageFilter<3>> movingAverage;
+	noiseSeed = 1;
+
+	errorTotals rawTotals = {};
+	errorTotals movingAverageTotals = {};
+	errorTotals estimatorTotals = {};
+	uint32_t samplesMeasured = 0;
+	uint32_t heatingSamplesMeasured = 0;
+
+	for (uint32_t simulatedMillis = 0; simulatedMillis < SIMULATED_DURATION_MS; simulatedMillis += TEMPERATURE_READING_INTERVAL_MS)
+	{
+		// Like main.cpp, the heater's power level drives both the fan and heater.
+		const float powerLevel = getHeaterPowerLevel(simulatedMillis);
+		ThermalPlant::Step(static_cast<float>(TEMPERATURE_READING_INTERVAL_MS) / 1000, powerLevel, powerLevel);
+		TemperatureEstimator::SetHeaterPowerLevel(powerLevel);
+		TemperatureEstimator::SetFanRpm(static_cast<uint32_t>(powerLevel / 100 * SIMULATED_FAN_FULL_SPEED_RPM));
+
+		const float reading = ThermalPlant::GetSensorTemperature() + getSensorNoise();
+		const float movingAverageOutput = static_cast<float>(movingAverage.Apply(static_cast<int32_t>(std::lround(reading * 100)))) * 0.01f;
+		TemperatureEstimator::AddReading(reading, simulatedMillis);
+
+		if (simulatedMillis < WARM_UP_DURATION_MS)
+		{
+			rawTotals.PreviousOutput = reading;
+			movingAverageTotals.PreviousOutput = movingAverageOutput;
+			estimatorTotals.PreviousOutput = TemperatureEstimator::GetTemperature();
+			continue;
+		}
+
+		const float airTemperature = ThermalPlant::GetAirTemperature();
+		const bool isHeatingAtFullPower = (powerLevel >= 100.0f);
+		addError(&rawTotals, reading, airTemperature, isHeatingAtFullPower);
+		addError(&movingAverageTotals, movingAverageOutput, airTemperature, isHeatingAtFullPower);
+		addError(&estimatorTotals, TemperatureEstimator::GetTemperature(), airTemperature, isHeatingAtFullPower);
+		samplesMeasured++;
+		heatingSamplesMeasured += isHeatingAtFullPower ? 1 : 0;
+	}
+
+	Results results = {};
+	results.RawReadings = summariseErrors(rawTotals, samplesMeasured, heatingSamplesMeasured);
+	results.MovingAverage = summariseErrors(movingAverageTotals, samplesMeasured, heatingSamplesMeasured);
+	results.Estimator = summariseErrors(estimatorTotals, samplesMeasured, heatingSamplesMeasured);
+	return results;
+}
+
+/**
+ * @brief                   Gets the power level the profile asks for. Each period is 10 minutes at full power then 10
+ *                          minutes at 20%, except that the heater is off for the third period's second half.
+ *
+ * @param  SimulatedMillis  The simulated time since the start of the profile.
+ *
+ * @return                  The heater's power level, from 0 to 100.
+*/
+float EstimatorBenchmark::getHeaterPowerLevel(const uint32_t SimulatedMillis)
+{
+	const uint32_t period = SimulatedMillis / POWER_PROFILE_PERIOD_MS;
+	const bool isFirstHalfOfPeriod = ((SimulatedMillis % POWER_PROFILE_PERIOD_MS) < (POWER_PROFILE_PERIOD_MS / 2));
+	if (isFirstHalfOfPeriod)
+	{
+		return 100.0f;
+	}
+
+	return (period == 2) ? 0.0f : 20.0f;
+}
+
+/**
+ * @brief   Generates repeatable noise for the sensor readings, roughly normally distributed.
+ *
+ * @return  The noise to add to a reading, in °C.
+*/
+float EstimatorBenchmark::getSensorNoise()
+{
+	// The sum of 12 uniform values from -0.5 to 0.5 has a standard deviation of 1.
+	float noise = 0.0f;
+	for (uint8_t i = 0; i < 12; ++i)
+	{
+		noiseSeed = (noiseSeed * 1664525) + 1013904223;
+		noise += (static_cast<float>(noiseSeed >> 8) / (1 << 24)) - 0.5f;
+	}
+	return noise * SENSOR_NOISE_DEG_CENT;
+}
+
+/**
+ * @brief                        Adds one output's error to a method's totals.
+ *
+ * @param  Totals                The method's totals.
+ * @param  Output                The method's output.
+ * @param  AirTemperature        The Thermal Plant's true air temperature.
+ * @param  IsHeatingAtFullPower  True if the profile has the heater at full power.
+*/
+void EstimatorBenchmark::addError(errorTotals* Totals, const float Output, const float AirTemperature, const bool IsHeatingAtFullPower)
+{
+	const float error = Output - AirTemperature;
+	const float step = Output - Totals->PreviousOutput;
+	Totals->PreviousOutput = Output;
+
+	Totals->SquaredErrorSum += error * error;
+	Totals->SquaredStepSum += step * step;
+	if (std::fabs(error) > Totals->WorstError)
+	{
+		Totals->WorstError = std::fabs(error);
+	}
+	if (IsHeatingAtFullPower)
+	{
+		Totals->HeatingErrorSum += error;
+	}
+}
+
+/**
+ * @brief                          Turns a method's totals into its errors.
+ *
+ * @param  Totals                  The method's totals.
+ * @param  SamplesMeasured         The number of outputs that were measured.
+ * @param  HeatingSamplesMeasured  The number of those outputs where the heater was at full power.
+ *
+ * @return                         The method's RMS, worst and average heating errors, and its RMS step.
+*/
+EstimatorBenchmark::MethodErrors EstimatorBenchmark::summariseErrors(const errorTotals& Totals, const uint32_t SamplesMeasured,
+                                                                     const uint32_t HeatingSamplesMeasured)
+{
+	MethodErrors errors = {};
+	errors.RmsError = static_cast<float>(std::sqrt(Totals.SquaredErrorSum / SamplesMeasured));
+	errors.WorstError = Totals.WorstError;
+	errors.AverageHeatingError = static_cast<float>(Totals.HeatingErrorSum / HeatingSamplesMeasured);
+	errors.RmsStep = static_cast<float>(std::sqrt(Totals.SquaredStepSum / SamplesMeasured));
+	return errors;
+}
+
+/**
+ * @brief          Writes a method's results to the Serial port.
+ *
+ * @param  Name    The method's name.
+ * @param  Errors  The method's errors.
+*/
+void EstimatorBenchmark::reportErrors(const char* Name, const MethodErrors& Errors)
+{
+	std::string errorsMsg = Utils::StringFormat(
+			"%s: RMS error %0.3f°C, worst error %0.3f°C, average error while heating %0.3f°C, RMS step %0.4f°C",
+			Name, Errors.RmsError, Errors.WorstError, Errors.AverageHeatingError, Errors.RmsStep
+	);
+	SerialHandler::SafeWriteLn(errorsMsg, true);
+}
@@ -0,0 +1,67 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_ESTIMATOR_BENCHMARK_H
+#define ENGINEERING_PROJECT_ESTIMATOR_BENCHMARK_H
+
+#include <cstdint>
+
+/**
+ * @brief  Compares the Temperature Estimator against the raw thermistor readings and the default filter pipeline, by how
+ *         closely each one tracks the Thermal Plant's air temperature.
+ *
+ * The plant is driven through a fixed power profile with noise added to its sensor readings. For each method, the RMS and
+ * worst error against the true air temperature is reported, along with the average error while heating at full power,
+ * which is mostly lag, and the RMS change between consecutive outputs, which is mostly noise.
+ *
+ * Add -DTEMPERATURE_ESTIMATOR_BENCHMARK to the build flags to run it once on boot, before the normal firmware starts.
+ * The native tests run the same comparison on the host.
+*/
+class EstimatorBenchmark
+{
+public:
+	struct MethodErrors
+	{
+		float RmsError;
+		float WorstError;
+		float AverageHeatingError;
+		float RmsStep;
+	};
+
+	struct Results
+	{
+		MethodErrors RawReadings;
+		MethodErrors MovingAverage;
+		MethodErrors Estimator;
+	};
+
+	static void Run();
+	static Results Measure();
+
+private:
+	struct errorTotals
+	{
+		double SquaredErrorSum;
+		float WorstError;
+		double HeatingErrorSum;
+		double SquaredStepSum;
+		float PreviousOutput;
+	};
+
+	static uint32_t noiseSeed;
+
+	static float getHeaterPowerLevel(uint32_t SimulatedMillis);
+	static float getSensorNoise();
+	static void addError(errorTotals* Totals, float Output, float AirTemperature, bool IsHeatingAtFullPower);
+	static MethodErrors summariseErrors(const errorTotals& Totals, uint32_t SamplesMeasured, uint32_t HeatingSamplesMeasured);
+	static void reportErrors(const char* Name, const MethodErrors& Errors);
+};
+
+#endif //ENGINEERING_PROJECT_ESTIMATOR_BENCHMARK_H
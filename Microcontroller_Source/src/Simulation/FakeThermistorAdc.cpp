@@ -0,0 +1,74 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include "FakeThermistorAdc.h"
+
+
+/**
+ * @brief  Does nothing, as there's no hardware to set up.
+*/
+void FakeThermistorAdc::Init()
+{
+}
+
+/**
+ * @brief  Starts a new burst. The samples are handed over the next time the burst is polled.
+*/
+void FakeThermistorAdc::StartBurst()
+{
+	resetSamplesCollected();
+}
+
+/**
+ * @brief   Copies the samples set with SetBurstSamples into every channel's burst buffer.
+ *
+ * @return  Always true, as the whole burst is collected at once.
+*/
+bool FakeThermistorAdc::IsBurstComplete()
+{
+	for (uint8_t i = 0; i < channelCount; ++i)
+	{
+		samples[i] = nextBurstSamples;
+		samplesCollected[i] = burstLength;
+	}
+	return true;
+}
+
+/**
+ * @brief  Throws away the burst in progress.
+*/
+void FakeThermistorAdc::StopBurst()
+{
+	resetSamplesCollected();
+}
+
+/**
+ * @brief                Gets how long a burst takes to collect.
+ *
+ * @param  BurstLength   Unused, as every burst is handed over at once.
+ *
+ * @return               Always 0.
+*/
+uint32_t FakeThermistorAdc::GetExpectedBurstDurationUs([[maybe_unused]] const uint16_t BurstLength) const
+{
+	return 0;
+}
+
+/**
+ * @brief           Sets the samples every channel will collect in the following bursts.
+ *
+ * @param  Samples  The raw 12 bit ADC samples. Only the first GetBurstLength of them are used.
+*/
+void FakeThermistorAdc::SetBurstSamples(const burstSamples& Samples)
+{
+	nextBurstSamples = Samples;
+}
@@ -0,0 +1,39 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_FAKE_THERMISTOR_ADC_H
+#define ENGINEERING_PROJECT_FAKE_THERMISTOR_ADC_H
+
+#include <cstdint>
+
+#include "IO/ThermistorAdc.h"
+
+/**
+ * @brief  Stands in for the thermistor's ADC, and hands back a burst of samples set beforehand instead of reading any pins.
+ *
+ * Every channel gets the same samples, and the burst is complete the first time it's polled. This lets the Temperature
+ * class's reduction code be run against known bursts.
+*/
+class FakeThermistorAdc final : public ThermistorAdc
+{
+public:
+	void Init() final;
+	void StartBurst() final;
+	bool IsBurstComplete() final;
+	void StopBurst() final;
+	uint32_t GetExpectedBurstDurationUs(uint16_t BurstLength) const final;
+	void SetBurstSamples(const burstSamples& Samples);
+
+private:
+	burstSamples nextBurstSamples = {};
+};
+
+
+#endif //ENGINEERING_PROJECT_FAKE_THERMISTOR_ADC_H
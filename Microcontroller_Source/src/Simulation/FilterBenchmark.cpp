@@ -0,0 +1,104 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "FilterBenchmark.h"
+
+#include <Arduino.h>
+#include <cstdlib>
+
+#include "IO/Temperature.h"
+#include "IO/TemperatureFilters.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+#define SAMPLES_TO_MEASURE          1000
+#define CPU_CYCLES_PER_MICROSECOND  160
+#define TRUE_TEMPERATURE_CENTI_DEG  2200
+#define NOISE_AMPLITUDE_CENTI_DEG   20
+#define SPIKE_INTERVAL_SAMPLES      50
+#define SPIKE_SIZE_CENTI_DEG        500
+
+
+/**
+ * @brief  Measures every filter stage on its own, then the Temperature class's configured pipeline, and writes the
+ *         results to the Serial port.
+*/
+void FilterBenchmark::RunAllFilters()
+{
+	SerialHandler::SafeWriteLn("Running temperature filter benchmark.", true);
+
+	measureFilter<MovingAverageFilter<3>>("Moving average, 3 samples");
+	measureFilter<MovingAverageFilter<16>>("Moving average, 16 samples");
+	measureFilter<ExponentialMovingAverageFilter<FILTER_COEFFICIENT_ONE / 4>>("EMA, alpha 0.25");
+	measureFilter<MedianFilter<3>>("Median, 3 samples");
+	measureFilter<MedianFilter<7>>("Median, 7 samples");
+	measureFilter<FirstOrderIIRFilter<FILTER_COEFFICIENT_ONE / 10, FILTER_COEFFICIENT_ONE / 10, -(FILTER_COEFFICIENT_ONE * 8 / 10)>>("First order IIR");
+	measureFilter<FilterPipeline<TEMPERATURE_FILTER_STAGES>>("Configured pipeline");
+}
+
+/**
+ * @brief               Generates a repeatable test signal: a constant temperature with noise, and an occasional spike.
+ *
+ * @param  SampleIndex  The sample's position in the signal.
+ *
+ * @return              The sample, in hundredths of a °C.
+*/
+int32_t FilterBenchmark::getNoisySample(const uint32_t SampleIndex)
+{
+	const int32_t noise = static_cast<int32_t>((SampleIndex * 37) % (2 * NOISE_AMPLITUDE_CENTI_DEG + 1)) - NOISE_AMPLITUDE_CENTI_DEG;
+	const int32_t spike = ((SampleIndex % SPIKE_INTERVAL_SAMPLES) == (SPIKE_INTERVAL_SAMPLES - 1)) ? SPIKE_SIZE_CENTI_DEG : 0;
+	return TRUE_TEMPERATURE_CENTI_DEG + noise + spike;
+}
+
+/**
+ * @brief        Runs the test signal through a filter, and reports its cost per sample and how far its output was off.
+ *
+ * @tparam       Filter  The filter to measure. Each filter starts from its default state.
+ * @param  Name  The filter's name, for the report.
+*/
+template <typename Filter>
+void FilterBenchmark::measureFilter(const char* Name)
+{
+	Filter filter;
+	uint64_t cyclesTotal = 0;
+	uint32_t cyclesMax = 0;
+	int32_t worstErrorCentiDeg = 0;
+
+	for (uint32_t i = 0; i < SAMPLES_TO_MEASURE; ++i)
+	{
+		const int32_t sample = getNoisySample(i);
+
+		const uint32_t cycleCountBeforeApply = ESP.getCycleCount();
+		const int32_t output = filter.Apply(sample);
+		const uint32_t cyclesTaken = ESP.getCycleCount() - cycleCountBeforeApply;
+
+		cyclesTotal += cyclesTaken;
+		if (cyclesTaken > cyclesMax)
+		{
+			cyclesMax = cyclesTaken;
+		}
+
+		const int32_t errorCentiDeg = std::abs(output - TRUE_TEMPERATURE_CENTI_DEG);
+		if (errorCentiDeg > worstErrorCentiDeg)
+		{
+			worstErrorCentiDeg = errorCentiDeg;
+		}
+	}
+
+	const float averageNs = static_cast<float>(cyclesTotal) / SAMPLES_TO_MEASURE * 1000 / CPU_CYCLES_PER_MICROSECOND;
+	const float maxNs = static_cast<float>(cyclesMax) * 1000 / CPU_CYCLES_PER_MICROSECOND;
+	std::string filterMsg = Utils::StringFormat(
+			"%s: %0.0fns average, %0.0fns max per sample. Worst error %0.2f°C",
+			Name, averageNs, maxNs, worstErrorCentiDeg * 0.01f
+	);
+	SerialHandler::SafeWriteLn(filterMsg, true);
+}
@@ -0,0 +1,36 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_FILTER_BENCHMARK_H
+#define ENGINEERING_PROJECT_FILTER_BENCHMARK_H
+
+#include <cstdint>
+
+/**
+ * @brief  Measures the CPU cost of each temperature filter stage, and of the pipeline the Temperature class is built with.
+ *
+ * Every filter is fed the same noisy, spiky signal, and the average and worst case cost per sample is reported along
+ * with how far the output ended up from the signal's true value.
+ *
+ * Add -DTEMPERATURE_FILTER_BENCHMARK to the build flags to run it once on boot, before the normal firmware starts.
+*/
+class FilterBenchmark
+{
+public:
+	static void RunAllFilters();
+
+private:
+	static int32_t getNoisySample(uint32_t SampleIndex);
+
+	template <typename Filter>
+	static void measureFilter(const char* Name);
+};
+
+#endif //ENGINEERING_PROJECT_FILTER_BENCHMARK_H
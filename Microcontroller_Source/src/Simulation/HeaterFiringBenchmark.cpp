@@ -0,0 +1,331 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "HeaterFiringBenchmark.h"
+
+#include <Arduino.h>
+#include <cmath>
+
+#include "IO/HeaterControl.h"
+#include "IO/MainsTimebase.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+
+
+#define SIMULATION_START_US                 1000000
+#define BLOCK_FIRING_WINDOW_PERIOD_IN_US    ((1000000 / HEATER_MAINS_FREQUENCY_HZ) * HEATER_MAINS_FREQUENCY_HZ * 2)
+#define HALF_CYCLES_PER_WINDOW              (HEATER_MAINS_FREQUENCY_HZ * 4)
+#define SIMULATED_MAINS_FREQUENCY_ERROR_PPM 2000    // 50.1 Hz on a 50 Hz supply.
+#define DETECTOR_JITTER_US                  20
+#define MIN_LOOP_PERIOD_US                  1000
+#define MAX_LOOP_PERIOD_US                  24000   // Gives edges about as late as the polled Heater Controller measures.
+#define MAX_TIMER_INTERRUPT_LATENCY_US      10
+
+
+uint32_t HeaterFiringBenchmark::randomSeed = 1;
+uint32_t HeaterFiringBenchmark::microsValueAtNextLoop = 0;
+uint64_t HeaterFiringBenchmark::microsValueAtFirstZeroCrossingQ16 = 0;
+uint64_t HeaterFiringBenchmark::halfCyclePeriodQ16 = 0;
+uint16_t HeaterFiringBenchmark::controlEdgeCount = 0;
+std::array<HeaterFiringBenchmark::controlEdge, (2 * HeaterFiringBenchmark::totalWindows) + 4> HeaterFiringBenchmark::controlEdges = {};
+std::array<uint32_t, HeaterFiringBenchmark::totalWindows + 1> HeaterFiringBenchmark::microsValueAtWindowStarts = {};
+
+
+/**
+ * @brief  Runs both firing schemes, polled and timed, at a range of power levels, and writes the energy error per window
+ *         to the Serial port.
+*/
+void HeaterFiringBenchmark::Run()
+{
+	struct firingSchemeVariant
+	{
+		const char* Name;
+		FiringSchemes FiringScheme;
+		bool IsPolled;
+	};
+
+	const std::array<firingSchemeVariant, 4> firingSchemeVariants = {{
+			{"Block firing, polled", BlockFiring, true},
+			{"Block firing, hardware timer", BlockFiring, false},
+			{"Mains synchronous, polled", MainsSynchronousFiring, true},
+			{"Mains synchronous, hardware timer", MainsSynchronousFiring, false}
+	}};
+	const std::array<float, 6> powerLevelsPercent = {{2.5f, 12.7f, 33.3f, 50.0f, 67.9f, 88.4f}};
+
+	std::string startMsg = Utils::StringFormat(
+			"Running heater firing benchmark on a %u Hz supply running %u ppm fast.",
+			HEATER_MAINS_FREQUENCY_HZ, SIMULATED_MAINS_FREQUENCY_ERROR_PPM
+	);
+	SerialHandler::SafeWriteLn(startMsg, true);
+
+	for (const firingSchemeVariant& variant : firingSchemeVariants)
+	{
+		float squaredRmsErrorSum = 0.0f;
+		float worstErrorPercent = 0.0f;
+		for (const float powerLevelPercent : powerLevelsPercent)
+		{
+			const WindowErrors errors = RunScenario(variant.FiringScheme, variant.IsPolled, powerLevelPercent);
+			reportErrors(variant.Name, powerLevelPercent, errors);
+			squaredRmsErrorSum += errors.RmsErrorPercent * errors.RmsErrorPercent;
+			worstErrorPercent = std::fmax(worstErrorPercent, errors.WorstErrorPercent);
+		}
+
+		std::string summaryMsg = Utils::StringFormat(
+				"%s: over all power levels, RMS error: %0.3f%%, worst: %0.3f%%",
+				variant.Name, std::sqrt(squaredRmsErrorSum / powerLevelsPercent.size()), worstErrorPercent
+		);
+		SerialHandler::SafeWriteLn(summaryMsg, true);
+	}
+}
+
+/**
+ * @brief                     Simulates a firing scheme at a single power level.
+ *
+ * @param  FiringScheme       The firing scheme to simulate.
+ * @param  IsPolled           True if the edges are switched from the main loop. False if a hardware timer switches them.
+ * @param  PowerLevelPercent  The power level the heater is set to.
+ *
+ * @returns                   The energy errors over the measured windows.
+*/
+HeaterFiringBenchmark::WindowErrors HeaterFiringBenchmark::RunScenario(const FiringSchemes FiringScheme, const bool IsPolled, const float PowerLevelPercent)
+{
+	// Every scenario sees the same mains phase and loop lengths, so only the firing scheme differs between them.
+	randomSeed = 1;
+	microsValueAtNextLoop = SIMULATION_START_US;
+	controlEdgeCount = 0;
+	halfCyclePeriodQ16 = ((static_cast<uint64_t>(1000000) << 16) * 1000000) /
+	                     (static_cast<uint64_t>(2 * HEATER_MAINS_FREQUENCY_HZ) * (1000000 + SIMULATED_MAINS_FREQUENCY_ERROR_PPM));
+	microsValueAtFirstZeroCrossingQ16 = static_cast<uint64_t>(SIMULATION_START_US + getRandomUs(halfCyclePeriodQ16 >> 16)) << 16;
+
+	if (FiringScheme == MainsSynchronousFiring)
+	{
+		scheduleMainsSynchronousFiring(IsPolled, PowerLevelPercent);
+	}
+	else
+	{
+		scheduleBlockFiring(IsPolled, PowerLevelPercent);
+	}
+	return measureWindowErrors(PowerLevelPercent);
+}
+
+/**
+ * @brief                     Works out the control edges the Heater Controller makes by default. The power level is
+ *                            rounded down to a whole percent, and the SSR is on for that share of each 2 second window,
+ *                            which starts whenever the controller did and runs from the microcontroller's clock.
+ *
+ * @param  IsPolled           True if the edges are switched from the main loop. False if a hardware timer switches them.
+ * @param  PowerLevelPercent  The power level the heater is set to.
+*/
+void HeaterFiringBenchmark::scheduleBlockFiring(const bool IsPolled, const float PowerLevelPercent)
+{
+	const uint32_t onTimeUs = static_cast<uint32_t>(PowerLevelPercent) * (BLOCK_FIRING_WINDOW_PERIOD_IN_US / 100);
+
+	for (uint8_t window = 0; window <= totalWindows; ++window)
+	{
+		const uint32_t microsValueAtWindowStart = SIMULATION_START_US + (window * BLOCK_FIRING_WINDOW_PERIOD_IN_US);
+		microsValueAtWindowStarts[window] = microsValueAtWindowStart;
+		if ((window == totalWindows) || (onTimeUs == 0))
+		{
+			continue;
+		}
+
+		addControlEdge(getMicrosValueWhenRun(microsValueAtWindowStart, IsPolled), true);
+		addControlEdge(getMicrosValueWhenRun(microsValueAtWindowStart + onTimeUs, IsPolled), false);
+	}
+}
+
+/**
+ * @brief                     Works out the control edges the Heater Controller makes with HEATER_MAINS_SYNCHRONOUS
+ *                            defined. A Mains Timebase follows the detector, and each switching step starts
+ *                            HEATER_ZERO_CROSS_LEAD_US before the zero crossing it predicts. A block of half cycles at
+ *                            the start of each window is on, up to the power level rounded to the nearest half cycle.
+ *                            An odd sized block starts a half cycle later in every other window.
+ *
+ * @param  IsPolled           True if the edges are switched from the main loop. False if a hardware timer switches them.
+ * @param  PowerLevelPercent  The power level the heater is set to.
+*/
+void HeaterFiringBenchmark::scheduleMainsSynchronousFiring(const bool IsPolled, const float PowerLevelPercent)
+{
+	MainsTimebase mainsTimebase;
+	mainsTimebase.Init(HEATER_MAINS_FREQUENCY_HZ, SIMULATION_START_US);
+	const uint16_t onHalfCyclesPerWindow = static_cast<uint16_t>(std::lround(PowerLevelPercent * HALF_CYCLES_PER_WINDOW / 100));
+
+	uint32_t zeroCrossingIndex = 0;
+	uint32_t microsValueAtNextDetection = getZeroCrossing(zeroCrossingIndex) + getRandomUs(2 * DETECTOR_JITTER_US) - DETECTOR_JITTER_US;
+	uint16_t halfCycleInWindow = 0;
+	uint8_t window = 0;
+	bool isSsrOn = false;
+
+	while (window <= totalWindows)
+	{
+		const uint32_t microsValueDue = mainsTimebase.GetMicrosValueAtNextZeroCrossing() - HEATER_ZERO_CROSS_LEAD_US;
+		const uint32_t microsValueWhenRun = getMicrosValueWhenRun(microsValueDue, IsPolled);
+
+		// The detector's interrupt runs whenever a crossing is seen, whether or not the steps are being run late.
+		if (static_cast<int32_t>(microsValueAtNextDetection - microsValueWhenRun) < 0)
+		{
+			mainsTimebase.RecordZeroCrossing(microsValueAtNextDetection);
+			zeroCrossingIndex++;
+			microsValueAtNextDetection = getZeroCrossing(zeroCrossingIndex) + getRandomUs(2 * DETECTOR_JITTER_US) - DETECTOR_JITTER_US;
+			continue;
+		}
+
+		if (halfCycleInWindow == 0)
+		{
+			microsValueAtWindowStarts[window] = microsValueDue;
+			window++;
+		}
+
+		const bool isOddWindow = (((window - 1) % 2) != 0);
+		const uint16_t firstOnHalfCycle = (isOddWindow && ((onHalfCyclesPerWindow % 2) != 0)) ? 1 : 0;
+		const bool isSsrOnThisHalfCycle = (halfCycleInWindow >= firstOnHalfCycle) && (halfCycleInWindow < (firstOnHalfCycle + onHalfCyclesPerWindow));
+		if (isSsrOnThisHalfCycle != isSsrOn)
+		{
+			addControlEdge(microsValueWhenRun, isSsrOnThisHalfCycle);
+			isSsrOn = isSsrOnThisHalfCycle;
+		}
+
+		mainsTimebase.AdvanceHalfCycle();
+		halfCycleInWindow = (halfCycleInWindow + 1) % HALF_CYCLES_PER_WINDOW;
+	}
+}
+
+/**
+ * @brief                     Passes the control edges through a zero crossing SSR, which conducts for a whole half cycle
+ *                            whenever its control input is on as the half cycle starts, and compares the energy delivered
+ *                            in each measured window against the energy requested.
+ *
+ * @param  PowerLevelPercent  The power level the heater is set to.
+ *
+ * @returns                   The energy errors, as percentages of the energy a window at full power would deliver.
+*/
+HeaterFiringBenchmark::WindowErrors HeaterFiringBenchmark::measureWindowErrors(const float PowerLevelPercent)
+{
+	WindowErrors errors = {};
+	float squaredErrorSum = 0.0f;
+	uint16_t edgeIndex = 0;
+	uint32_t zeroCrossingIndex = 0;
+	bool isSsrConducting = false;
+
+	while (getZeroCrossing(zeroCrossingIndex) < microsValueAtWindowStarts[warmUpWindows])
+	{
+		zeroCrossingIndex++;
+	}
+
+	for (uint8_t window = warmUpWindows; window < totalWindows; ++window)
+	{
+		uint32_t conductingTimeUs = 0;
+		while (getZeroCrossing(zeroCrossingIndex) < microsValueAtWindowStarts[window + 1])
+		{
+			const uint32_t microsValueAtZeroCrossing = getZeroCrossing(zeroCrossingIndex);
+			while ((edgeIndex < controlEdgeCount) && (controlEdges[edgeIndex].MicrosValue <= microsValueAtZeroCrossing))
+			{
+				isSsrConducting = controlEdges[edgeIndex].IsSsrOn;
+				edgeIndex++;
+			}
+
+			zeroCrossingIndex++;
+			if (isSsrConducting)
+			{
+				conductingTimeUs += getZeroCrossing(zeroCrossingIndex) - microsValueAtZeroCrossing;
+			}
+		}
+
+		const float windowPeriodUs = static_cast<float>(microsValueAtWindowStarts[window + 1] - microsValueAtWindowStarts[window]);
+		const float errorPercent = (static_cast<float>(conductingTimeUs) / windowPeriodUs * 100) - PowerLevelPercent;
+		errors.MeanErrorPercent += errorPercent / measuredWindows;
+		squaredErrorSum += errorPercent * errorPercent;
+		errors.WorstErrorPercent = std::fmax(errors.WorstErrorPercent, std::fabs(errorPercent));
+	}
+
+	errors.RmsErrorPercent = std::sqrt(squaredErrorSum / measuredWindows);
+	return errors;
+}
+
+/**
+ * @brief                     Writes a scenario's energy errors to the Serial port.
+ *
+ * @param  Name               The firing scheme's name.
+ * @param  PowerLevelPercent  The power level the heater was set to.
+ * @param  Errors             The scenario's energy errors.
+*/
+void HeaterFiringBenchmark::reportErrors(const char* Name, const float PowerLevelPercent, const WindowErrors& Errors)
+{
+	std::string errorsMsg = Utils::StringFormat(
+			"%s at %0.1f%%: energy error per window, mean: %+0.3f%%, RMS: %0.3f%%, worst: %0.3f%%",
+			Name, PowerLevelPercent, Errors.MeanErrorPercent, Errors.RmsErrorPercent, Errors.WorstErrorPercent
+	);
+	SerialHandler::SafeWriteLn(errorsMsg, true);
+}
+
+/**
+ * @brief               Adds a control edge to the end of the list, unless it is full.
+ *
+ * @param  MicrosValue  When the SSR's control input switches.
+ * @param  IsSsrOn      Whether it switches on or off.
+*/
+void HeaterFiringBenchmark::addControlEdge(const uint32_t MicrosValue, const bool IsSsrOn)
+{
+	if (controlEdgeCount >= controlEdges.size())
+	{
+		return;
+	}
+	controlEdges[controlEdgeCount] = {MicrosValue, IsSsrOn};
+	controlEdgeCount++;
+}
+
+/**
+ * @brief                  Works out when an edge that is due actually happens. A hardware timer's interrupt runs almost
+ *                         straight away. A polled edge waits for the next main loop, which are of random length.
+ *
+ * @param  MicrosValueDue  When the edge is due.
+ * @param  IsPolled        True if the edge is switched from the main loop. False if a hardware timer switches it.
+ *
+ * @returns                When the edge happens.
+*/
+uint32_t HeaterFiringBenchmark::getMicrosValueWhenRun(const uint32_t MicrosValueDue, const bool IsPolled)
+{
+	if (!IsPolled)
+	{
+		return MicrosValueDue + getRandomUs(MAX_TIMER_INTERRUPT_LATENCY_US);
+	}
+
+	while (static_cast<int32_t>(microsValueAtNextLoop - MicrosValueDue) < 0)
+	{
+		microsValueAtNextLoop += MIN_LOOP_PERIOD_US + getRandomUs(MAX_LOOP_PERIOD_US - MIN_LOOP_PERIOD_US);
+	}
+	return microsValueAtNextLoop;
+}
+
+/**
+ * @brief                     Gets when the simulated mains crosses zero.
+ *
+ * @param  ZeroCrossingIndex  Which zero crossing to get, counting from the first one in the simulation.
+ *
+ * @returns                   The value of micros() at the zero crossing.
+*/
+uint32_t HeaterFiringBenchmark::getZeroCrossing(const uint32_t ZeroCrossingIndex)
+{
+	return static_cast<uint32_t>((microsValueAtFirstZeroCrossingQ16 + (ZeroCrossingIndex * halfCyclePeriodQ16)) >> 16);
+}
+
+/**
+ * @brief         Gets a pseudo random number of microseconds, from a linear congruential generator.
+ *
+ * @param  MaxUs  The largest number that can be returned.
+ *
+ * @returns       A number between 0 and MaxUs.
+*/
+uint32_t HeaterFiringBenchmark::getRandomUs(const uint32_t MaxUs)
+{
+	randomSeed = (randomSeed * 1664525) + 1013904223;
+	return (randomSeed >> 8) % (MaxUs + 1);
+}
@@ -0,0 +1,78 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_HEATER_FIRING_BENCHMARK_H
+#define ENGINEERING_PROJECT_HEATER_FIRING_BENCHMARK_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief  Compares how much energy the heater delivers in each window with block firing, which is what the Heater
+ *         Controller does by default, and with mains synchronous firing.
+ *
+ * The mains supply is simulated slightly off its nominal frequency, with a zero crossing detector that jitters. Each
+ * firing scheme's control edges are fed to a zero crossing SSR, which only turns on or off as the mains crosses zero.
+ * Both schemes are run with their edges polled from a main loop of varying length, and switched by a hardware timer. For
+ * each power level, the mean, RMS and worst difference between the energy delivered and the energy requested in a
+ * window is reported, as a percentage of the energy a window at full power would deliver.
+ *
+ * The SSR is never switched, so this is safe to run with the element connected. Add -DHEATER_FIRING_BENCHMARK to the
+ * build flags to run it once on boot, before the normal firmware starts. The native tests run it on the host too.
+*/
+class HeaterFiringBenchmark
+{
+public:
+	enum FiringSchemes
+	{
+		BlockFiring,
+		MainsSynchronousFiring
+	};
+
+	struct WindowErrors
+	{
+		float MeanErrorPercent;
+		float RmsErrorPercent;
+		float WorstErrorPercent;
+	};
+
+	static void Run();
+	static WindowErrors RunScenario(FiringSchemes FiringScheme, bool IsPolled, float PowerLevelPercent);
+
+private:
+	struct controlEdge
+	{
+		uint32_t MicrosValue;
+		bool IsSsrOn;
+	};
+
+	static constexpr uint8_t warmUpWindows = 2;
+	static constexpr uint8_t measuredWindows = 30;
+	static constexpr uint8_t totalWindows = warmUpWindows + measuredWindows;
+
+	static uint32_t randomSeed;
+	static uint32_t microsValueAtNextLoop;
+	static uint64_t microsValueAtFirstZeroCrossingQ16;
+	static uint64_t halfCyclePeriodQ16;
+	static uint16_t controlEdgeCount;
+	static std::array<controlEdge, (2 * totalWindows) + 4> controlEdges;
+	static std::array<uint32_t, totalWindows + 1> microsValueAtWindowStarts;
+
+	static void scheduleBlockFiring(bool IsPolled, float PowerLevelPercent);
+	static void scheduleMainsSynchronousFiring(bool IsPolled, float PowerLevelPercent);
+	static WindowErrors measureWindowErrors(float PowerLevelPercent);
+	static void reportErrors(const char* Name, float PowerLevelPercent, const WindowErrors& Errors);
+	static void addControlEdge(uint32_t MicrosValue, bool IsSsrOn);
+	static uint32_t getMicrosValueWhenRun(uint32_t MicrosValueDue, bool IsPolled);
+	static uint32_t getZeroCrossing(uint32_t ZeroCrossingIndex);
+	static uint32_t getRandomUs(uint32_t MaxUs);
+};
+
+#endif //ENGINEERING_PROJECT_HEATER_FIRING_BENCHMARK_H
@@ -0,0 +1,100 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+#include "ThermalPlant.h"
+
+#include <cmath>
+
+
+#define HEATER_MAX_POWER_W                          250.0f
+#define ELEMENT_HEAT_CAPACITY_J_PER_K               150.0f
+#define AIR_HEAT_CAPACITY_J_PER_K                   5000.0f     // Includes the enclosure that the air is heating.
+#define ELEMENT_TO_AIR_CONDUCTANCE_STILL_W_PER_K    1.0f
+#define ELEMENT_TO_AIR_CONDUCTANCE_AT_FULL_FAN_W_PER_K  6.0f
+#define AIR_TO_AMBIENT_CONDUCTANCE_W_PER_K          8.0f
+#define SENSOR_TIME_CONSTANT_S                      5.0f
+
+
+bool ThermalPlant::isFanStalled = false;
+float ThermalPlant::ambientTemperatureDegCent = 0.0;
+float ThermalPlant::elementTemperatureDegCent = 0.0;
+float ThermalPlant::airTemperatureDegCent = 0.0;
+float ThermalPlant::sensorTemperatureDegCent = 0.0;
+
+
+/**
+ * @brief                             Resets the model so that everything is at the ambient temperature.
+ *
+ * @param  AmbientTemperatureDegCent  The temperature of the model's surroundings in °C.
+*/
+void ThermalPlant::Init(const float AmbientTemperatureDegCent)
+{
+	isFanStalled = false;
+	ambientTemperatureDegCent = AmbientTemperatureDegCent;
+	elementTemperatureDegCent = AmbientTemperatureDegCent;
+	airTemperatureDegCent = AmbientTemperatureDegCent;
+	sensorTemperatureDegCent = AmbientTemperatureDegCent;
+}
+
+/**
+ * @brief                    Advances the model by one time step.
+ *
+ * @param  TimeStepSeconds   How much time the step covers. Should be well under a second for the Euler integration to stay accurate.
+ * @param  HeaterPowerLevel  The heater's power level as a percentage between 0 and 100.
+ * @param  FanDutyCycle      The fan's duty cycle as a percentage between 0 and 100.
+*/
+void ThermalPlant::Step(const float TimeStepSeconds, const float HeaterPowerLevel, const float FanDutyCycle)
+{
+	const bool isFanSpinning = !isFanStalled && (FanDutyCycle > 0);
+
+	// Heater Control only switches the SSR on for whole percentages, and only while the fan is spinning.
+	const float heaterPowerW = isFanSpinning ? (std::floor(HeaterPowerLevel) / 100 * HEATER_MAX_POWER_W) : 0.0f;
+	const float airflowFraction = isFanSpinning ? (FanDutyCycle / 100) : 0.0f;
+	const float elementToAirConductance = ELEMENT_TO_AIR_CONDUCTANCE_STILL_W_PER_K +
+	                                      (airflowFraction * (ELEMENT_TO_AIR_CONDUCTANCE_AT_FULL_FAN_W_PER_K - ELEMENT_TO_AIR_CONDUCTANCE_STILL_W_PER_K));
+
+	const float elementToAirPowerW = elementToAirConductance * (elementTemperatureDegCent - airTemperatureDegCent);
+	const float airToAmbientPowerW = AIR_TO_AMBIENT_CONDUCTANCE_W_PER_K * (airTemperatureDegCent - ambientTemperatureDegCent);
+
+	elementTemperatureDegCent += (heaterPowerW - elementToAirPowerW) / ELEMENT_HEAT_CAPACITY_J_PER_K * TimeStepSeconds;
+	airTemperatureDegCent += (elementToAirPowerW - airToAmbientPowerW) / AIR_HEAT_CAPACITY_J_PER_K * TimeStepSeconds;
+	sensorTemperatureDegCent += (airTemperatureDegCent - sensorTemperatureDegCent) * (TimeStepSeconds / SENSOR_TIME_CONSTANT_S);
+}
+
+/**
+ * @brief             Simulates the fan's rotor being stuck.
+ *
+ * @param  IsStalled  True if the fan should stop spinning regardless of its duty cycle. False otherwise.
+*/
+void ThermalPlant::SetFanStalled(const bool IsStalled)
+{
+	isFanStalled = IsStalled;
+}
+
+/**
+ * @brief   Gets the actual temperature of the air.
+ *
+ * @return  The air temperature in °C.
+*/
+float ThermalPlant::GetAirTemperature()
+{
+	return airTemperatureDegCent;
+}
+
+/**
+ * @brief   Gets the temperature the thermistor is currently reporting.
+ *
+ * @return  The sensor's temperature in °C.
+*/
+float ThermalPlant::GetSensorTemperature()
+{
+	return sensorTemperatureDegCent;
+}
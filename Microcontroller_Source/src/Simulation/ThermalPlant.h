@@ -0,0 +1,38 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+#ifndef ENGINEERING_PROJECT_THERMAL_PLANT_H
+#define ENGINEERING_PROJECT_THERMAL_PLANT_H
+
+/**
+ * @brief  A lumped parameter model of the heating element, the air it heats and the fan's airflow.
+ *
+ * The element and the air are each treated as a single heat capacity. The fan's airflow increases how well heat moves
+ * from the element to the air, and the air loses heat to its surroundings. The thermistor is modelled as a first order lag
+ * on the air temperature. Like the real hardware, the heater only receives power while the fan is spinning.
+*/
+class ThermalPlant
+{
+public:
+	static void Init(float AmbientTemperatureDegCent);
+	static void Step(float TimeStepSeconds, float HeaterPowerLevel, float FanDutyCycle);
+	static void SetFanStalled(bool IsStalled);
+	static float GetAirTemperature();
+	static float GetSensorTemperature();
+
+private:
+	static bool isFanStalled;
+	static float ambientTemperatureDegCent;
+	static float elementTemperatureDegCent;
+	static float airTemperatureDegCent;
+	static float sensorTemperatureDegCent;
+};
+
+#endif //ENGINEERING_PROJECT_THERMAL_PLANT_H
@@ -12,17 +12,41 @@
 #include "main.h"
 
 #include <Arduino.h>
+#include <array>
+#include <cmath>
+#include <tuple>
 
+#include "InitDataTypes/GainScheduleData.h"
 #include "InitDataTypes/PIDControllerData.h"
+#include "InitDataTypes/PIDSettingsSchema.h"
+#include "Control/AutoTuner.h"
+#include "Control/GainScheduler.h"
 #include "Control/PIDController.h"
+#include "Control/PowerBudget.h"
+#include "Control/ProfileEngine.h"
+#include "Control/TemperatureEstimator.h"
 #include "Display/Display.h"
 #include "Display/Screens/StatusAkaMain.h"
 #include "IO/FanControl.h"
 #include "IO/HeaterControl.h"
 #include "IO/Temperature.h"
+#include "Misc/HeapAllocationCounter.h"
 #include "Misc/SerialHandler.h"
+#include "Misc/SettingsMailbox.h"
+#include "Misc/UsageMeter.h"
 #include "Misc/Usb.h"
 #include "Misc/Utils.h"
+#include "Simulation/ClosedLoopBenchmark.h"
+#include "Simulation/EstimatorBenchmark.h"
+#include "Simulation/FilterBenchmark.h"
+#include "Simulation/HeaterFiringBenchmark.h"
+
+
+#define DISPLAYED_TEMPERATURE_INTERVAL_MS   500
+#define DISPLAYED_TEMPERATURE_READINGS      10      // The display shows the average of this many recent readings.
+
+
+uint32_t Main::millisValueAtLastDisplayedTemperature = 0;
 
 
 /**
@@ -56,17 +80,25 @@ void loop()
 	}
 }
 
-// TODO: Move this data into a flash read/write class.
-float pidControllerTemperatureSetPointDegCent = 22.0;
-int32_t pidControllerLoopTimeStepMs = 500;
-float pidControllerProportionalGain = 2.5;
-float pidControllerIntegralGain = 2.0;
-float pidControllerIntegralWindupLimitMax = 4.0;
-float pidControllerIntegralWindupLimitMin = -0.5;
-float pidControllerDerivativeGain = 0.1;
-float pidControllerDerivativeTermMaxValue = 0.5;
-float pidControllerDerivativeTermMinValue = -10.0;
-float pidControllerOutputMaxValue = 100.0;
+// Set the breakpoint count to 2 or more to take the gains from this table instead of the settings schema's defaults.
+GainScheduleKeys gainScheduleKey = ScheduleOnSetPoint;
+uint8_t gainScheduleBreakpointCount = 0;
+std::array<GainScheduleBreakpoint, MAX_GAIN_SCHEDULE_BREAKPOINTS> gainScheduleBreakpoints = {{
+		{-20.0, 4.0, 3.0, 0.1},
+		{10.0, 2.5, 2.0, 0.1},
+		{40.0, 2.0, 1.5, 0.1}
+}};
+
+// The set point profile started by the Run profile button. Warms up gently, then cycles between two temperatures.
+constexpr std::array<ProfileStep, 7> setPointProfileSteps = {{
+		ProfileEngine::Ramp(25.0, 0.5),
+		ProfileEngine::Soak(30),
+		ProfileEngine::Ramp(30.0, 0.5),
+		ProfileEngine::Soak(60),
+		ProfileEngine::Ramp(25.0, 0.5),
+		ProfileEngine::Repeat(1, 2),
+		ProfileEngine::End()
+}};
 
 
 /**
@@ -77,23 +109,37 @@ void Main::TrySetup()
 	Usb::Init();
 	SerialHandler::Init(Usb::IsUsbPluggedIn());
 
+	// TODO: Load the settings from a flash read/write class instead of using the defaults every time.
+	constexpr PIDControllerInitData pIDControllerInitData = GetDefaultPIDControllerInitData();
+
 	FanControl::Init();
 	HeaterControl::Init();
-	Temperature::Init(pidControllerLoopTimeStepMs);
-
-	const PIDControllerInitData pIDControllerInitData = {
-			pidControllerTemperatureSetPointDegCent,
-			pidControllerLoopTimeStepMs,
-			pidControllerProportionalGain,
-			pidControllerIntegralGain,
-			pidControllerIntegralWindupLimitMax,
-			pidControllerIntegralWindupLimitMin,
-			pidControllerDerivativeGain,
-			pidControllerDerivativeTermMaxValue,
-			pidControllerDerivativeTermMinValue,
-			pidControllerOutputMaxValue
-	};
+	PowerBudget::Init();
+	Temperature::Init();
+	UsageMeter::Init();
+
+	GainScheduler::Init({gainScheduleKey, gainScheduleBreakpointCount, gainScheduleBreakpoints});
+
+#ifdef PID_CLOSED_LOOP_BENCHMARK
+	ClosedLoopBenchmark::RunAllScenarios(pIDControllerInitData);
+#endif
+
+#ifdef TEMPERATURE_FILTER_BENCHMARK
+	FilterBenchmark::RunAllFilters();
+#endif
+
+#ifdef TEMPERATURE_ESTIMATOR_BENCHMARK
+	EstimatorBenchmark::Run();
+#endif
+
+#ifdef HEATER_FIRING_BENCHMARK
+	HeaterFiringBenchmark::Run();
+#endif
+
 	PIDController::Init(pIDControllerInitData);
+	TemperatureEstimator::Init(pIDControllerInitData.AmbientTemperatureDegCent);
+	AutoTuner::Init(AutoTuner::TyreusLuybenPID);
+	ProfileEngine::Init();
 	const float targetTemperature = PIDController::GetTemperatureSetPoint();
 
 	Display::Init(targetTemperature, pIDControllerInitData);
@@ -104,20 +150,21 @@ void Main::TrySetup()
 */
 void Main::TryLoop()
 {
+#ifdef COUNT_HEAP_ALLOCATIONS
+	HeapAllocationCounter::StartOfLoop();
+#endif
+
 //	SerialHandler::SetState(Usb::IsUsbPluggedIn());
 
 	const bool isUnitSwitchedOff = StatusAkaMain::IsOnOffButtonInOffState();
-	PIDController::SetControlLoopIsEnabled(!isUnitSwitchedOff);
-
-	std::vector<PIDFloatDataPacket> changedFloatSettings = {};
-	Display::GetAllChangedFloatSettings(&changedFloatSettings);
-	PIDController::ChangeFloatSettings(&changedFloatSettings);
+	autoTuning(isUnitSwitchedOff);
+	PIDController::SetControlLoopIsEnabled(!isUnitSwitchedOff && !AutoTuner::IsActive());
 
-	std::vector<PIDIntDataPacket> changedIntSettings = {};
-	Display::GetAllChangedIntSettings(&changedIntSettings);
-	PIDController::ChangeIntSettings(&changedIntSettings);
+	Display::PostChangedSettings();
+	changedSettings();
 
 	temperatureReading();
+	displayedTemperature();
 
 	const float desiredTemperatureChange = StatusAkaMain::GetTargetTemperatureChangeDesiredByUser();
 	if ((desiredTemperatureChange >= 0.2) || (desiredTemperatureChange <= -0.2))
@@ -125,57 +172,188 @@ void Main::TryLoop()
 //		std::string desiredTemperatureMsg = Utils::StringFormat("Target Temp change desired: %0.1f", desiredTemperatureChange);
 //		SerialHandler::SafeWriteLn(desiredTemperatureMsg, true);
 
+		// The user taking over the set point ends any running profile.
+		ProfileEngine::Stop();
 		const float newTargetTemperature = PIDController::ChangeTemperatureSetPoint(desiredTemperatureChange);
 		StatusAkaMain::SetCurrentTargetTemperature(newTargetTemperature);
 	}
 
+	setPointProfile();
+
 	PIDController::Update();
 
 	StatusAkaMain::SetPiControllerStatusIndicator(PIDController::IsLoopActive());
 
-	const float currentPiControllerDutyCycle = PIDController::GetCurrentDutyCyclePercent();
+	const float currentPiControllerDutyCycle = AutoTuner::IsActive() ? AutoTuner::GetHeaterPowerLevel() : PIDController::GetCurrentDutyCyclePercent();
 
 	FanControl::SetFanDutyCycle(currentPiControllerDutyCycle);
 	FanControl::UpdateSlowdownState();
 	fanSpeedUpdates();
 
-	HeaterControl::SetHeaterPowerLevel(currentPiControllerDutyCycle);
+	// The fan is set first, so the heater is given whatever is left of the power budget.
+	PowerBudget::Update(currentPiControllerDutyCycle, FanControl::GetFanCurrentDutyCycle());
+	powerBudgetStatus();
+
+	// The controllers are told the limit too, so they work with the power the heater can actually be given.
+	PIDController::SetOutputLimitPercent(PowerBudget::GetHeaterPowerLimit());
+	AutoTuner::SetOutputLimitPercent(PowerBudget::GetHeaterPowerLimit());
+
+	HeaterControl::SetHeaterPowerLevel(PowerBudget::GetHeaterPowerLevel());
 	HeaterControl::UpdatePwmState();
+	const HeaterControl::SwitchingData heaterSwitchingData = HeaterControl::GetSwitchingData();
+	Temperature::SetHeaterSwitching(heaterSwitchingData);
+	TemperatureEstimator::SetHeaterPowerLevel(HeaterControl::GetCurrentPowerLevel());
 	StatusAkaMain::SetCurrentDutyCycles(FanControl::GetFanCurrentDutyCycle(), HeaterControl::GetCurrentPowerLevel());
 
+	UsageMeter::Update(HeaterControl::GetEnergyDeliveredJoules(), heaterSwitchingData.SwitchCount);
+	StatusAkaMain::SetUsage(UsageMeter::GetUsage());
+
 	Display::Update();
 
 	SerialHandler::TryWriteBufferToSerial();
+
+#ifdef COUNT_HEAP_ALLOCATIONS
+	HeapAllocationCounter::EndOfLoop();
+#endif
 }
 
 /**
- * @brief  Gets a temperature reading from the Temperature class, and passes that data to the PID Controller and Display Manager.
+ * @brief  Passes any settings the user has changed in the config screens to the PID Controller.
 */
-void Main::temperatureReading()
+void Main::changedSettings()
+{
+	PIDFloatDataPacket changedFloatSetting = {};
+	while (SettingsMailboxes::FloatSettings.Pop(&changedFloatSetting))
+	{
+		PIDController::ChangeFloatSetting(changedFloatSetting);
+		if (changedFloatSetting.Setting == AmbientTemperature)
+		{
+			TemperatureEstimator::SetAmbientTemperature(changedFloatSetting.Value);
+		}
+	}
+
+	PIDIntDataPacket changedIntSetting = {};
+	while (SettingsMailboxes::IntSettings.Pop(&changedIntSetting))
+	{
+		PIDController::ChangeIntSetting(changedIntSetting);
+	}
+}
+
+/**
+ * @brief                     Starts or stops the Auto Tuner as requested, and passes any gains it calculated to the Display Manager.
+ *
+ * @param  IsUnitSwitchedOff  True if the user has switched the unit off, which also stops any tuning run.
+*/
+void Main::autoTuning(const bool IsUnitSwitchedOff)
+{
+	const bool isAutoTuneRequested = Display::HasAutoTuneBeenRequested();
+	if (IsUnitSwitchedOff)
+	{
+		AutoTuner::Stop();
+	}
+	else if (isAutoTuneRequested && !AutoTuner::IsActive())
+	{
+		AutoTuner::Start(PIDController::GetTemperatureSetPoint(), PIDController::GetOutputMaxValue());
+	}
+
+	AutoTuner::Update();
+
+	std::array<PIDFloatDataPacket, 3> tunedSettings = {};
+	if (AutoTuner::GetNewlyTunedSettings(&tunedSettings))
+	{
+		for (const PIDFloatDataPacket& tunedSetting : tunedSettings)
+		{
+			Display::SetFloatSetting(tunedSetting);
+		}
+	}
+
+	if (AutoTuner::IsActive())
+	{
+		StatusAkaMain::RemoveErrorCondition(StatusAkaMain::AutoTuneFailed);
+		StatusAkaMain::AddErrorCondition(StatusAkaMain::AutoTuneInProgress);
+	}
+	else
+	{
+		StatusAkaMain::RemoveErrorCondition(StatusAkaMain::AutoTuneInProgress);
+		if (AutoTuner::GetState() == AutoTuner::Failed)
+		{
+			StatusAkaMain::AddErrorCondition(StatusAkaMain::AutoTuneFailed);
+		}
+		else
+		{
+			StatusAkaMain::RemoveErrorCondition(StatusAkaMain::AutoTuneFailed);
+		}
+	}
+}
+
+/**
+ * @brief  Starts the set point profile if requested, and passes the set point it wants to the PID Controller.
+*/
+void Main::setPointProfile()
 {
-	if (PIDController::HasNewLoopRunSinceLastCheck())
+	if (AutoTuner::IsActive())
+	{
+		ProfileEngine::Stop();
+	}
+	else if (Display::HasProfileRunBeenRequested())
+	{
+		std::ignore = ProfileEngine::Start(setPointProfileSteps.data(), setPointProfileSteps.size(), PIDController::GetTemperatureSetPoint());
+	}
+
+	// Checked before updating, so that the final set point is still applied on the loop the profile finishes.
+	const bool wasProfileRunning = ProfileEngine::IsRunning();
+
+	// The profile's clock only runs while the PID Controller is heating to it.
+	ProfileEngine::Update(!PIDController::IsLoopActive());
+
+	if (wasProfileRunning)
 	{
-		Temperature::SetPidReadyForNextTempReading();
+		const float setPointChange = ProfileEngine::GetSetPoint() - PIDController::GetTemperatureSetPoint();
+		if (std::fabs(setPointChange) >= 0.01)
+		{
+			const float newTargetTemperature = PIDController::ChangeTemperatureSetPoint(setPointChange);
+			StatusAkaMain::SetCurrentTargetTemperature(newTargetTemperature);
+		}
 	}
 
+	StatusAkaMain::SetProfileStatus(ProfileEngine::IsRunning(), ProfileEngine::GetCurrentStep(), ProfileEngine::GetStepCount(),
+	                                ProfileEngine::GetStepSecondsRemaining());
+}
+
+/**
+ * @brief  Keeps the Temperature class's background readings going, and passes each new reading to the Temperature
+ *         Estimator, PID Controller and Auto Tuner. The PID Controller decides for itself which readings it runs a loop on.
+ *
+ * With PID_USE_TEMPERATURE_ESTIMATOR defined, the PID Controller is given the estimated air temperature instead of the
+ * raw reading.
+*/
+void Main::temperatureReading()
+{
 	const TempReadData tempResult = Temperature::Read();
 	switch (tempResult.Result)
 	{
 		case TempReadSuccessfully:
-			PIDController::SetCurrentTemperature(tempResult.Temp);
-			StatusAkaMain::SetCurrentTemperature(tempResult.Temp);
+			TemperatureEstimator::AddReading(tempResult.Temp, tempResult.TimestampMs);
+#ifdef PID_USE_TEMPERATURE_ESTIMATOR
+			PIDController::SetCurrentTemperature(TemperatureEstimator::GetTemperature(), tempResult.TimestampMs);
+#else
+			PIDController::SetCurrentTemperature(tempResult.Temp, tempResult.TimestampMs);
+#endif
+			AutoTuner::SetCurrentTemperature(tempResult.Temp);
 			StatusAkaMain::RemoveErrorCondition(StatusAkaMain::ErrorMessages::ThermoResistorShortCircuit);
 			StatusAkaMain::RemoveErrorCondition(StatusAkaMain::ErrorMessages::ThermoResistorUnplugged);
 			break;
 
 		case ProbeShortCircuit:
 			PIDController::ActivateTemperatureLockout();
+			AutoTuner::Stop();
 			StatusAkaMain::RemoveErrorCondition(StatusAkaMain::ErrorMessages::ThermoResistorUnplugged);
 			StatusAkaMain::AddErrorCondition(StatusAkaMain::ErrorMessages::ThermoResistorShortCircuit);
 			break;
 
 		case ProbeUnplugged:
 			PIDController::ActivateTemperatureLockout();
+			AutoTuner::Stop();
 			StatusAkaMain::RemoveErrorCondition(StatusAkaMain::ErrorMessages::ThermoResistorShortCircuit);
 			StatusAkaMain::AddErrorCondition(StatusAkaMain::ErrorMessages::ThermoResistorUnplugged);
 			break;
@@ -185,6 +363,47 @@ void Main::temperatureReading()
 	}
 }
 
+/**
+ * @brief  Passes the average of the most recent readings to the Display Manager, at the display's own pace.
+*/
+void Main::displayedTemperature()
+{
+	if ((millis() - millisValueAtLastDisplayedTemperature) < DISPLAYED_TEMPERATURE_INTERVAL_MS)
+	{
+		return;
+	}
+	millisValueAtLastDisplayedTemperature = millis();
+
+	std::array<TempReadData, DISPLAYED_TEMPERATURE_READINGS> recentReadings = {};
+	const uint8_t readingsCopied = Temperature::GetRecentReadings(OutletProbe, recentReadings.data(), recentReadings.size());
+	if (readingsCopied == 0)
+	{
+		return;
+	}
+
+	float temperatureSum = 0.0;
+	for (uint8_t i = 0; i < readingsCopied; ++i)
+	{
+		temperatureSum += recentReadings[i].Temp;
+	}
+	StatusAkaMain::SetCurrentTemperature(temperatureSum / readingsCopied);
+}
+
+/**
+ * @brief  Shows on the main screen whether the heater is being derated to stay within the power budget.
+*/
+void Main::powerBudgetStatus()
+{
+	if (PowerBudget::IsHeaterLimited())
+	{
+		StatusAkaMain::AddErrorCondition(StatusAkaMain::HeaterPowerLimited);
+	}
+	else
+	{
+		StatusAkaMain::RemoveErrorCondition(StatusAkaMain::HeaterPowerLimited);
+	}
+}
+
 /**
  * @brief  Gets the fan's speed from the Fan Control class, and passes that data to the classes which use that info.
 */
@@ -198,6 +417,9 @@ void Main::fanSpeedUpdates()
 
 	Temperature::SetFanPowerState(fanRpmData.IsFanSwitchedOn);
 	HeaterControl::SetFanIsRunning(fanRpmData.IsFanSpinning);
+	UsageMeter::SetFanIsRunning(fanRpmData.IsFanSpinning);
+	PIDController::SetCurrentFanRpm(fanRpmData.IsFanSpinning ? fanRpmData.Rpm : 0);
+	TemperatureEstimator::SetFanRpm(fanRpmData.IsFanSpinning ? fanRpmData.Rpm : 0);
 	StatusAkaMain::SetCurrentFanRpm(fanRpmData.IsFanSwitchedOn, fanRpmData.Rpm);
 
 	if (fanRpmData.IsFanSpinning || !fanRpmData.IsFanSwitchedOn)
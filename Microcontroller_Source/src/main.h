@@ -11,6 +11,8 @@
 #ifndef ENGINEERING_PROJECT_MAIN_H
 #define ENGINEERING_PROJECT_MAIN_H
 
+#include <cstdint>
+
 /**
  * @brief  Holds the code that interfaces with the rest of the classes.
 */
@@ -21,7 +23,14 @@ public:
 	static void TryLoop();
 
 private:
+	static uint32_t millisValueAtLastDisplayedTemperature;
+
+	static void changedSettings();
+	static void autoTuning(bool IsUnitSwitchedOff);
+	static void setPointProfile();
 	static void temperatureReading();
+	static void displayedTemperature();
+	static void powerBudgetStatus();
 	static void fanSpeedUpdates();
 };
 
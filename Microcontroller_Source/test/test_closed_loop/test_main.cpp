@@ -0,0 +1,114 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include <cstdint>
+#include <unity.h>
+
+#include "Control/MultiZonePIDController.h"
+#include "InitDataTypes/PIDSettingsSchema.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+#include "Simulation/ClosedLoopBenchmark.h"
+
+
+/**
+ * @brief  The limits each scenario's results are checked against. They are the default settings' results with about 5%
+ *         headroom, so a change that makes the control noticeably worse fails here.
+ *
+ * The default settings' integral windup limit holds the output to about a fifth of full power against the Thermal
+ * Plant model, so none of the scenarios settle inside their window yet. The limits catch regressions, and should be
+ * tightened when the defaults are retuned.
+*/
+struct scenarioLimits
+{
+	ClosedLoopBenchmark::Scenarios Scenario;
+	float MaxOvershootDegCent;
+	float MaxIntegratedAbsoluteError;
+};
+
+
+static constexpr scenarioLimits scenarioLimitsList[] = {
+		{ClosedLoopBenchmark::ColdStart,     0.5f, 14000.0f},
+		{ClosedLoopBenchmark::SetPointStep,  0.5f, 21500.0f},
+		{ClosedLoopBenchmark::FanStall,      0.5f, 6000.0f},
+		{ClosedLoopBenchmark::SensorDropout, 0.5f, 5900.0f}
+};
+
+
+/**
+ * @brief          Runs a scenario with the default PID settings and checks its results against its limits.
+ *
+ * @param  Limits  The scenario to run and its limits.
+*/
+static void checkScenario(const scenarioLimits& Limits)
+{
+	const ClosedLoopBenchmark::ScenarioResults results = ClosedLoopBenchmark::RunScenario(Limits.Scenario, GetDefaultPIDControllerInitData());
+
+	TEST_ASSERT_GREATER_THAN(0, results.LoopsRun);
+	TEST_ASSERT_LESS_THAN_FLOAT(Limits.MaxOvershootDegCent, results.OvershootDegCent);
+	TEST_ASSERT_LESS_THAN_FLOAT(Limits.MaxIntegratedAbsoluteError, results.IntegratedAbsoluteError);
+}
+
+void test_cold_start()
+{
+	checkScenario(scenarioLimitsList[ClosedLoopBenchmark::ColdStart]);
+}
+
+void test_set_point_step()
+{
+	checkScenario(scenarioLimitsList[ClosedLoopBenchmark::SetPointStep]);
+}
+
+void test_fan_stall()
+{
+	checkScenario(scenarioLimitsList[ClosedLoopBenchmark::FanStall]);
+}
+
+void test_sensor_dropout()
+{
+	checkScenario(scenarioLimitsList[ClosedLoopBenchmark::SensorDropout]);
+}
+
+/**
+ * @brief  Reports the Multi-Zone PID Controller's cost per zone for every zone count. The times are the host's, so they
+ *         are only compared against each other: a zone shouldn't get dearer as more are added.
+*/
+void test_multi_zone_scaling()
+{
+	const float singleZoneNs = ClosedLoopBenchmark::MeasureMultiZoneUpdateNs(1, GetDefaultPIDControllerInitData());
+	for (uint8_t zoneCount = 1; zoneCount <= MAX_PID_ZONES; ++zoneCount)
+	{
+		const float updateNs = ClosedLoopBenchmark::MeasureMultiZoneUpdateNs(zoneCount, GetDefaultPIDControllerInitData());
+		SerialHandler::SafeWriteLn(Utils::StringFormat("Multi-zone (host), %u zones: %0.0fns per loop, %0.0fns per zone",
+		                                               zoneCount, updateNs, updateNs / zoneCount), true);
+		TEST_ASSERT_LESS_THAN_FLOAT(3.0f * singleZoneNs, updateNs / zoneCount);
+	}
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_cold_start);
+	RUN_TEST(test_set_point_step);
+	RUN_TEST(test_fan_stall);
+	RUN_TEST(test_sensor_dropout);
+	RUN_TEST(test_multi_zone_scaling);
+	return UNITY_END();
+}
@@ -0,0 +1,76 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include <cmath>
+#include <cstdint>
+#include <unity.h>
+
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+#include "Simulation/EstimatorBenchmark.h"
+
+
+static EstimatorBenchmark::Results results;
+
+
+/**
+ * @brief  The Temperature Estimator tracks the true air temperature more closely than either the raw readings or the
+ *         moving average does.
+*/
+void test_estimator_tracks_air_better_than_filters()
+{
+	TEST_ASSERT_LESS_THAN_FLOAT(results.RawReadings.RmsError, results.Estimator.RmsError);
+	TEST_ASSERT_LESS_THAN_FLOAT(results.MovingAverage.RmsError, results.Estimator.RmsError);
+}
+
+/**
+ * @brief  The Estimator's output is smoother than the raw readings, so it isn't just passing the sensor noise through.
+*/
+void test_estimator_is_smoother_than_raw_readings()
+{
+	TEST_ASSERT_LESS_THAN_FLOAT(results.RawReadings.RmsStep, results.Estimator.RmsStep);
+}
+
+/**
+ * @brief  While heating at full power, the Estimator lags the air less than the raw readings do, as it models the
+ *         probe's lag.
+*/
+void test_estimator_lags_less_while_heating()
+{
+	TEST_ASSERT_LESS_THAN_FLOAT(std::fabs(results.RawReadings.AverageHeatingError), std::fabs(results.Estimator.AverageHeatingError));
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+int main()
+{
+	results = EstimatorBenchmark::Measure();
+	const EstimatorBenchmark::MethodErrors* methods[] = {&results.RawReadings, &results.MovingAverage, &results.Estimator};
+	const char* names[] = {"Raw readings", "3 sample moving average", "Estimator"};
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		SerialHandler::SafeWriteLn(Utils::StringFormat("%s: RMS error %0.3f°C, average error while heating %0.3f°C, RMS step %0.4f°C",
+		                                               names[i], methods[i]->RmsError, methods[i]->AverageHeatingError, methods[i]->RmsStep), true);
+	}
+
+	UNITY_BEGIN();
+	RUN_TEST(test_estimator_tracks_air_better_than_filters);
+	RUN_TEST(test_estimator_is_smoother_than_raw_readings);
+	RUN_TEST(test_estimator_lags_less_while_heating);
+	return UNITY_END();
+}
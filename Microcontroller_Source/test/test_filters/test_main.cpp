@@ -0,0 +1,166 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include <cstdint>
+#include <tuple>
+#include <unity.h>
+
+#include "IO/TemperatureFilters.h"
+
+
+#define STEADY_CENTI_DEG    2200
+#define STEP_CENTI_DEG      3000
+#define SPIKE_CENTI_DEG     500
+
+// b0 + b1 - a1 is exactly 1 in Q16, so the DC gain is exactly 1.
+typedef FirstOrderIIRFilter<FILTER_COEFFICIENT_ONE / 8, FILTER_COEFFICIENT_ONE / 8, -(FILTER_COEFFICIENT_ONE * 3 / 4)> lowPassIIRFilter;
+
+
+/**
+ * @brief   Feeds a filter a steady signal and checks that it comes straight out, from the first sample.
+ *
+ * @tparam  Filter  The filter to check.
+*/
+template <typename Filter>
+static void checkSteadySignalPassesThrough()
+{
+	Filter filter;
+	for (uint8_t sample = 0; sample < 50; ++sample)
+	{
+		TEST_ASSERT_EQUAL_INT32(STEADY_CENTI_DEG, filter.Apply(STEADY_CENTI_DEG));
+	}
+}
+
+/**
+ * @brief                   Feeds a filter a step and checks that its output reaches the new value within a number of
+ *                          samples, without overshooting it.
+ *
+ * @tparam                  Filter  The filter to check.
+ * @param  SettlingSamples  The number of samples the output may take to get within one hundredth of a degree.
+*/
+template <typename Filter>
+static void checkStepSettles(const uint32_t SettlingSamples)
+{
+	Filter filter;
+	std::ignore = filter.Apply(STEADY_CENTI_DEG);
+
+	int32_t output = 0;
+	for (uint32_t sample = 0; sample < SettlingSamples; ++sample)
+	{
+		output = filter.Apply(STEP_CENTI_DEG);
+		TEST_ASSERT_LESS_OR_EQUAL(STEP_CENTI_DEG, output);
+	}
+	TEST_ASSERT_INT_WITHIN(1, STEP_CENTI_DEG, output);
+}
+
+void test_steady_signal_passes_through()
+{
+	checkSteadySignalPassesThrough<MovingAverageFilter<3>>();
+	checkSteadySignalPassesThrough<MovingAverageFilter<16>>();
+	checkSteadySignalPassesThrough<ExponentialMovingAverageFilter<FILTER_COEFFICIENT_ONE / 4>>();
+	checkSteadySignalPassesThrough<MedianFilter<5>>();
+	checkSteadySignalPassesThrough<lowPassIIRFilter>();
+	checkSteadySignalPassesThrough<FilterPipeline<MedianFilter<3>, MovingAverageFilter<3>>>();
+}
+
+void test_step_settles()
+{
+	checkStepSettles<MovingAverageFilter<3>>(3);
+	checkStepSettles<MovingAverageFilter<16>>(16);
+	checkStepSettles<ExponentialMovingAverageFilter<FILTER_COEFFICIENT_ONE / 4>>(60);
+	checkStepSettles<MedianFilter<5>>(3);
+	checkStepSettles<lowPassIIRFilter>(60);
+	checkStepSettles<FilterPipeline<MedianFilter<3>, MovingAverageFilter<3>>>(5);
+}
+
+/**
+ * @brief  A moving average's output is the mean of exactly the last WindowSize samples.
+*/
+void test_moving_average_averages_window()
+{
+	MovingAverageFilter<4> filter;
+	std::ignore = filter.Apply(0);
+	std::ignore = filter.Apply(100);
+	std::ignore = filter.Apply(200);
+	std::ignore = filter.Apply(300);
+	TEST_ASSERT_EQUAL_INT32(250, filter.Apply(400));
+}
+
+/**
+ * @brief  A median filter throws away a single sample spike entirely, where a moving average only spreads it out.
+*/
+void test_median_rejects_single_spike()
+{
+	MedianFilter<3> medianFilter;
+	MovingAverageFilter<3> movingAverageFilter;
+	for (uint8_t sample = 0; sample < 10; ++sample)
+	{
+		const int32_t input = STEADY_CENTI_DEG + ((sample == 5) ? SPIKE_CENTI_DEG : 0);
+		TEST_ASSERT_EQUAL_INT32(STEADY_CENTI_DEG, medianFilter.Apply(input));
+		const int32_t movingAverageOutput = movingAverageFilter.Apply(input);
+		if (sample == 5)
+		{
+			TEST_ASSERT_GREATER_THAN(STEADY_CENTI_DEG, movingAverageOutput);
+		}
+	}
+}
+
+/**
+ * @brief  The median filter's sorted window stays correct as samples rise and fall through it.
+*/
+void test_median_tracks_changing_signal()
+{
+	MedianFilter<5> filter;
+	const int32_t samples[] = {10, 50, 30, 20, 40, 60, 0, 70, 35};
+	const int32_t expectedMedians[] = {10, 10, 10, 20, 30, 40, 30, 40, 40};
+	for (uint8_t i = 0; i < 9; ++i)
+	{
+		TEST_ASSERT_EQUAL_INT32(expectedMedians[i], filter.Apply(samples[i]));
+	}
+}
+
+/**
+ * @brief  Each stage of a pipeline can be run on its own, and the pipeline gives the same result as running them in turn.
+*/
+void test_pipeline_runs_stages_in_order()
+{
+	FilterPipeline<MedianFilter<3>, MovingAverageFilter<3>> pipeline;
+	MedianFilter<3> medianFilter;
+	MovingAverageFilter<3> movingAverageFilter;
+	TEST_ASSERT_EQUAL(2, (FilterPipeline<MedianFilter<3>, MovingAverageFilter<3>>::StageCount));
+
+	for (uint32_t sample = 0; sample < 100; ++sample)
+	{
+		const int32_t input = STEADY_CENTI_DEG + static_cast<int32_t>((sample * 37) % 41) - 20 + (((sample % 10) == 9) ? SPIKE_CENTI_DEG : 0);
+		TEST_ASSERT_EQUAL_INT32(movingAverageFilter.Apply(medianFilter.Apply(input)), pipeline.Apply(input));
+	}
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_steady_signal_passes_through);
+	RUN_TEST(test_step_settles);
+	RUN_TEST(test_moving_average_averages_window);
+	RUN_TEST(test_median_rejects_single_spike);
+	RUN_TEST(test_median_tracks_changing_signal);
+	RUN_TEST(test_pipeline_runs_stages_in_order);
+	return UNITY_END();
+}
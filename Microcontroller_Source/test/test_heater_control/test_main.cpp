@@ -0,0 +1,310 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include <Arduino.h>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <unity.h>
+
+#include "IO/HeaterControl.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+#include "NativeShims.h"
+#include "Simulation/HeaterFiringBenchmark.h"
+
+
+#define SSR_CONTROL_PIN             7
+#define WINDOW_PERIOD_US            2000000
+#define MAINS_CYCLE_PERIOD_US       (1000000 / HEATER_MAINS_FREQUENCY_HZ)
+
+
+/**
+ * @brief  Everything seen on the SSR's pin while a test runs.
+*/
+struct ssrTotals
+{
+	bool IsOn;
+	uint32_t MicrosValueAtLastEdge;
+	uint64_t OnTimeUs;
+	uint32_t RisingEdges;
+	uint32_t FallingEdges;
+	uint64_t RisingEdgeLatenessSumUs;
+	uint64_t FallingEdgeLatenessSumUs;
+	uint32_t WorstEdgeLatenessUs;
+	uint32_t OnTimeOfBlockUs;
+};
+
+
+static ssrTotals ssr;
+
+
+/**
+ * @brief         Records every edge on the SSR's pin, and how late it was against the block firing windows.
+ *
+ * @param  Pin    The pin written.
+ * @param  Value  The level it was written to.
+*/
+static void recordSsrEdge(const uint8_t Pin, const uint8_t Value)
+{
+	if ((Pin != SSR_CONTROL_PIN) || ((Value == HIGH) == ssr.IsOn))
+	{
+		return;
+	}
+
+	const uint32_t microsValueNow = micros();
+	if (ssr.IsOn)
+	{
+		ssr.OnTimeUs += microsValueNow - ssr.MicrosValueAtLastEdge;
+		ssr.FallingEdges++;
+	}
+	else
+	{
+		ssr.RisingEdges++;
+	}
+
+	// Block firing windows start every WINDOW_PERIOD_US from 0, and the SSR switches off OnTimeOfBlockUs into each one.
+	const uint32_t microsValueDue = (Value == HIGH) ? 0 : ssr.OnTimeOfBlockUs;
+	const uint32_t latenessUs = (microsValueNow - microsValueDue) % WINDOW_PERIOD_US;
+	((Value == HIGH) ? ssr.RisingEdgeLatenessSumUs : ssr.FallingEdgeLatenessSumUs) += latenessUs;
+	if (latenessUs > ssr.WorstEdgeLatenessUs)
+	{
+		ssr.WorstEdgeLatenessUs = latenessUs;
+	}
+
+	ssr.IsOn = (Value == HIGH);
+	ssr.MicrosValueAtLastEdge = microsValueNow;
+}
+
+/**
+ * @brief                      Starts the Heater Controller at a power level, with the SSR's edges being recorded.
+ *
+ * @param  PowerLevelPercent   The power level to set.
+*/
+static void startHeater(const float PowerLevelPercent)
+{
+	ssr = {};
+	ssr.OnTimeOfBlockUs = static_cast<uint32_t>(PowerLevelPercent) * (WINDOW_PERIOD_US / 100);
+	NativeShims::SetDigitalWriteHook(recordSsrEdge);
+	HeaterControl::Init();
+	HeaterControl::SetFanIsRunning(true);
+	HeaterControl::SetHeaterPowerLevel(PowerLevelPercent);
+}
+
+/**
+ * @brief                Polls the Heater Controller every millisecond for a while.
+ *
+ * @param  DurationUs    How long to run for.
+ *
+ * @return               The share of the time the SSR was on for, as a percentage.
+*/
+static float runEveryMillisecond(const uint32_t DurationUs)
+{
+	const uint32_t microsValueAtStart = micros();
+	const uint64_t onTimeAtStartUs = ssr.OnTimeUs;
+	while ((micros() - microsValueAtStart) < DurationUs)
+	{
+		NativeShims::AdvanceMicros(1000);
+		HeaterControl::UpdatePwmState();
+	}
+	return static_cast<float>(ssr.OnTimeUs - onTimeAtStartUs) * 100 / DurationUs;
+}
+
+#if !defined(HEATER_USE_CYCLE_DISTRIBUTION) && !defined(HEATER_MAINS_SYNCHRONOUS)
+/**
+ * @brief  With the main loop taking 2-5 ms, and stalling for 20-35 ms one pass in ten, the block firing edges stay on
+ *         their windows' grid instead of drifting later, and are only as late as the loop pass they fall in.
+*/
+void test_polled_edges_stay_on_window_grid()
+{
+	startHeater(37.0f);
+	std::srand(1);
+	for (uint32_t loop = 0; loop < 400000; ++loop)
+	{
+		const bool isStall = ((std::rand() % 10) == 0);
+		NativeShims::AdvanceMicros(isStall ? (20000 + (std::rand() % 15000)) : (2000 + (std::rand() % 3000)));
+		HeaterControl::UpdatePwmState();
+	}
+
+	const uint32_t edges = ssr.RisingEdges + ssr.FallingEdges;
+	const float averageLatenessMs = static_cast<float>(ssr.RisingEdgeLatenessSumUs + ssr.FallingEdgeLatenessSumUs) / edges / 1000;
+	SerialHandler::SafeWriteLn(Utils::StringFormat("Polled block firing: %u edges, %0.1fms late on average, %0.1fms at worst",
+	                                               edges, averageLatenessMs, static_cast<float>(ssr.WorstEdgeLatenessUs) / 1000), true);
+
+	TEST_ASSERT_GREATER_THAN(1000, edges);
+	TEST_ASSERT_LESS_THAN_FLOAT(10.0f, averageLatenessMs);
+	TEST_ASSERT_LESS_OR_EQUAL_UINT32(36000, ssr.WorstEdgeLatenessUs);
+}
+
+/**
+ * @brief  Polled every millisecond, block firing delivers the whole percent it was asked for.
+*/
+void test_block_firing_delivers_power_level()
+{
+	startHeater(37.4f);
+	TEST_ASSERT_FLOAT_WITHIN(0.1f, 37.0f, runEveryMillisecond(60 * WINDOW_PERIOD_US));
+}
+#endif
+
+#ifdef HEATER_USE_CYCLE_DISTRIBUTION
+/**
+ * @brief  The cycle distribution delivers the power level without rounding it to a whole percent, and spreads the on
+ *         cycles through the window instead of switching once on and once off.
+*/
+void test_cycle_distribution_delivers_exact_power_level()
+{
+	startHeater(37.4f);
+	std::ignore = runEveryMillisecond(WINDOW_PERIOD_US);
+	const uint32_t edgesAtStart = ssr.RisingEdges + ssr.FallingEdges;
+	const float deliveredPercent = runEveryMillisecond(300 * WINDOW_PERIOD_US);
+	const float edgesPerSecond = static_cast<float>(ssr.RisingEdges + ssr.FallingEdges - edgesAtStart) / (300 * WINDOW_PERIOD_US / 1000000);
+	SerialHandler::SafeWriteLn(Utils::StringFormat("Cycle distribution: %0.3f%% delivered, %0.1f edges per second",
+	                                               deliveredPercent, edgesPerSecond), true);
+
+	TEST_ASSERT_FLOAT_WITHIN(0.05f, 37.4f, deliveredPercent);
+	TEST_ASSERT_GREATER_THAN_FLOAT(30.0f, edgesPerSecond);
+}
+
+/**
+ * @brief  Both halves of a mains cycle are switched together, so the SSR is never on for less than a whole cycle.
+*/
+void test_cycle_distribution_switches_whole_cycles()
+{
+	startHeater(37.4f);
+	uint32_t shortestOnTimeUs = UINT32_MAX;
+	uint32_t microsValueAtRisingEdge = 0;
+	bool wasSsrOn = false;
+	for (uint32_t step = 0; step < 20 * WINDOW_PERIOD_US / 1000; ++step)
+	{
+		NativeShims::AdvanceMicros(1000);
+		HeaterControl::UpdatePwmState();
+		if (ssr.IsOn && !wasSsrOn)
+		{
+			microsValueAtRisingEdge = ssr.MicrosValueAtLastEdge;
+		}
+		else if (!ssr.IsOn && wasSsrOn && ((ssr.MicrosValueAtLastEdge - microsValueAtRisingEdge) < shortestOnTimeUs))
+		{
+			shortestOnTimeUs = ssr.MicrosValueAtLastEdge - microsValueAtRisingEdge;
+		}
+		wasSsrOn = ssr.IsOn;
+	}
+	TEST_ASSERT_GREATER_OR_EQUAL_UINT32(MAINS_CYCLE_PERIOD_US - 1000, shortestOnTimeUs);
+}
+#endif
+
+#ifdef HEATER_MAINS_SYNCHRONOUS
+/**
+ * @brief  The on time is rounded to the nearest half cycle, so every window delivers exactly that many half cycles.
+*/
+void test_mains_synchronous_rounds_to_half_cycles()
+{
+	startHeater(37.4f);
+	std::ignore = runEveryMillisecond(WINDOW_PERIOD_US);
+	const float deliveredPercent = runEveryMillisecond(60 * WINDOW_PERIOD_US);
+	SerialHandler::SafeWriteLn(Utils::StringFormat("Mains synchronous: %0.3f%% delivered", deliveredPercent), true);
+
+	// 37.4% of a window's 200 half cycles rounds to 75 of them.
+	TEST_ASSERT_FLOAT_WITHIN(0.2f, 37.5f, deliveredPercent);
+}
+
+/**
+ * @brief  With an odd number of half cycles per window, both polarities still get the same number of on half cycles, so
+ *         no DC flows through the element. Without a zero crossing detector, the timebase free runs from Init, so the
+ *         switching steps are HEATER_ZERO_CROSS_LEAD_US before every half cycle from then on, and a half cycle's
+ *         polarity is whether it is odd or even since Init.
+*/
+void test_mains_synchronous_has_no_dc_component()
+{
+	constexpr uint32_t halfCyclePeriodUs = MAINS_CYCLE_PERIOD_US / 2;
+	startHeater(37.4f);
+	const uint32_t microsValueAtFirstStep = halfCyclePeriodUs - HEATER_ZERO_CROSS_LEAD_US;
+
+	std::array<uint32_t, 2> onHalfCyclesByPolarity = {};
+	uint32_t microsValueAtRisingEdge = 0;
+	bool wasSsrOn = false;
+	for (uint32_t step = 0; step < 50 * WINDOW_PERIOD_US / 1000; ++step)
+	{
+		NativeShims::AdvanceMicros(1000);
+		HeaterControl::UpdatePwmState();
+		if (ssr.IsOn && !wasSsrOn)
+		{
+			microsValueAtRisingEdge = ssr.MicrosValueAtLastEdge;
+		}
+		else if (!ssr.IsOn && wasSsrOn)
+		{
+			// Edges are up to a millisecond late from the polling, so both ends are rounded to the nearest step.
+			const uint32_t firstHalfCycle = (microsValueAtRisingEdge - microsValueAtFirstStep + (halfCyclePeriodUs / 2)) / halfCyclePeriodUs;
+			const uint32_t endHalfCycle = (ssr.MicrosValueAtLastEdge - microsValueAtFirstStep + (halfCyclePeriodUs / 2)) / halfCyclePeriodUs;
+			for (uint32_t halfCycle = firstHalfCycle; halfCycle < endHalfCycle; ++halfCycle)
+			{
+				onHalfCyclesByPolarity[halfCycle % 2]++;
+			}
+		}
+		wasSsrOn = ssr.IsOn;
+	}
+
+	SerialHandler::SafeWriteLn(Utils::StringFormat("Mains synchronous: %u positive and %u negative half cycles on",
+	                                               onHalfCyclesByPolarity[0], onHalfCyclesByPolarity[1]), true);
+
+	// Without the balancing, each of the 50 windows would add one more half cycle to the same polarity.
+	TEST_ASSERT_GREATER_THAN(3000, onHalfCyclesByPolarity[0] + onHalfCyclesByPolarity[1]);
+	TEST_ASSERT_INT_WITHIN(1, onHalfCyclesByPolarity[0], onHalfCyclesByPolarity[1]);
+}
+#endif
+
+/**
+ * @brief  Reports the energy error per window for both firing schemes at a spread of power levels, and checks that
+ *         mains synchronous firing driven by the timer is never worse than block firing polled from the loop.
+*/
+void test_firing_schemes()
+{
+	const float powerLevels[] = {5.0f, 25.0f, 37.4f, 50.0f, 75.0f, 95.0f};
+	for (const float powerLevel : powerLevels)
+	{
+		const HeaterFiringBenchmark::WindowErrors blockPolled = HeaterFiringBenchmark::RunScenario(HeaterFiringBenchmark::BlockFiring, true, powerLevel);
+		const HeaterFiringBenchmark::WindowErrors mainsSyncTimer = HeaterFiringBenchmark::RunScenario(HeaterFiringBenchmark::MainsSynchronousFiring, false, powerLevel);
+		SerialHandler::SafeWriteLn(Utils::StringFormat("%0.1f%%: block polled worst %0.3f%%, mains synchronous timer worst %0.3f%%",
+		                                               powerLevel, blockPolled.WorstErrorPercent, mainsSyncTimer.WorstErrorPercent), true);
+
+		TEST_ASSERT_TRUE_MESSAGE(mainsSyncTimer.WorstErrorPercent <= blockPolled.WorstErrorPercent, "Mains synchronous firing was worse than block firing.");
+		TEST_ASSERT_LESS_THAN_FLOAT(0.5f, mainsSyncTimer.WorstErrorPercent);
+	}
+}
+
+void setUp()
+{
+	NativeShims::Reset();
+}
+
+void tearDown()
+{
+	NativeShims::SetDigitalWriteHook(nullptr);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+#if !defined(HEATER_USE_CYCLE_DISTRIBUTION) && !defined(HEATER_MAINS_SYNCHRONOUS)
+	RUN_TEST(test_polled_edges_stay_on_window_grid);
+	RUN_TEST(test_block_firing_delivers_power_level);
+#endif
+#ifdef HEATER_USE_CYCLE_DISTRIBUTION
+	RUN_TEST(test_cycle_distribution_delivers_exact_power_level);
+	RUN_TEST(test_cycle_distribution_switches_whole_cycles);
+#endif
+#ifdef HEATER_MAINS_SYNCHRONOUS
+	RUN_TEST(test_mains_synchronous_rounds_to_half_cycles);
+	RUN_TEST(test_mains_synchronous_has_no_dc_component);
+#endif
+	RUN_TEST(test_firing_schemes);
+	return UNITY_END();
+}
@@ -0,0 +1,317 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <tuple>
+#include <unity.h>
+
+#include "Control/FixedPoint.h"
+#include "Control/MultiZonePIDController.h"
+#include "Control/PIDController.h"
+#include "Control/PidEngine.h"
+#include "InitDataTypes/PIDSettingsSchema.h"
+#include "Misc/Utils.h"
+#include "Misc/SerialHandler.h"
+
+
+#define MAX_DUTY_CYCLE_DIFFERENCE_PERCENT   0.01f
+#define READING_INTERVAL_MS                 100
+#define MAX_READING_JITTER_MS               30
+#define LOOP_TICK_TOLERANCE_MS              (READING_INTERVAL_MS / 2)
+
+
+static uint32_t simulatedMillis = 0;
+
+
+static uint32_t getSimulatedMillis()
+{
+	return simulatedMillis;
+}
+
+/**
+ * @brief            Starts the PID Controller on the simulated clock, clearing anything left over from the previous test.
+ *
+ * @param  InitData  The settings to start it with.
+*/
+static void startPidController(const PIDControllerInitData& InitData)
+{
+	PIDController::SetTimeSource(getSimulatedMillis);
+	PIDController::Init(InitData);
+	PIDController::SetControlLoopIsEnabled(false);
+	PIDController::Update();
+	PIDController::SetControlLoopIsEnabled(true);
+}
+
+/**
+ * @brief   Builds the PID Engine's settings from the default PID settings, the same way the PID Controller does.
+ *
+ * @tparam  Scalar  The number type to build them in.
+*/
+template <typename Scalar>
+static PidEngineSettings<Scalar> getDefaultEngineSettings()
+{
+	constexpr PIDControllerInitData defaults = GetDefaultPIDControllerInitData();
+	const float loopTimeStepMinutes = static_cast<float>(defaults.LoopTimeStepMs) / 60000;
+
+	PidEngineSettings<Scalar> settings = {};
+	settings.ProportionalGain = Scalar(defaults.ProportionalGain);
+	settings.IntegralGainTimesLoopTimeStep = Scalar(defaults.IntegralGain * loopTimeStepMinutes);
+	settings.IntegralWindupLimitMax = Scalar(defaults.IntegralWindupLimitMax);
+	settings.IntegralWindupLimitMin = Scalar(defaults.IntegralWindupLimitMin);
+	settings.DerivativeGainDividedByLoopTimeStep = Scalar(defaults.DerivativeGain / loopTimeStepMinutes);
+	settings.DerivativeTermMaxValue = Scalar(defaults.DerivativeTermMaxValue);
+	settings.DerivativeTermMinValue = Scalar(defaults.DerivativeTermMinValue);
+	return settings;
+}
+
+/**
+ * @brief          Turns the PID Engine's terms into a duty cycle, the same way the PID Controller does.
+ *
+ * @tparam         Scalar  The number type the terms are in.
+ * @param  Terms   The Proportional and Derivative terms.
+ * @param  State   The Engine's state, holding the Integral term.
+ *
+ * @return         The duty cycle as a percentage.
+*/
+template <typename Scalar>
+static float getDutyCyclePercent(const PidEngineTerms<Scalar>& Terms, const PidEngineState<Scalar>& State)
+{
+	constexpr PIDControllerInitData defaults = GetDefaultPIDControllerInitData();
+	const float output = static_cast<float>(Terms.ProportionalTerm + State.IntegralAccumulator + Terms.DerivativeTerm);
+	if (output <= 0.0f)
+	{
+		return 0.0f;
+	}
+	return (output >= defaults.OutputMaxValue) ? 100.0f : (output * (100.0f / defaults.OutputMaxValue));
+}
+
+/**
+ * @brief  The Q16.16 fixed point engine's duty cycle stays within 0.01 percentage points of the float engine's, for an
+ *         error that swings through the whole output range as it settles.
+*/
+void test_fixed_point_engine_matches_float()
+{
+	const PidEngineSettings<float> floatSettings = getDefaultEngineSettings<float>();
+	const PidEngineSettings<FixedPoint<16>> fixedPointSettings = getDefaultEngineSettings<FixedPoint<16>>();
+	PidEngineState<float> floatState = {};
+	PidEngineState<FixedPoint<16>> fixedPointState = {};
+
+	float worstDifferencePercent = 0.0f;
+	for (uint32_t loop = 0; loop < 3000; ++loop)
+	{
+		const float error = (12.0f * std::exp(-static_cast<float>(loop) / 600) * std::cos(static_cast<float>(loop) / 40)) + 0.3f;
+		const auto floatTerms = PidEngine<true, true, true, float>::Calculate(error, floatSettings, floatState);
+		const auto fixedPointTerms = PidEngine<true, true, true, FixedPoint<16>>::Calculate(FixedPoint<16>(error), fixedPointSettings, fixedPointState);
+
+		const float difference = std::fabs(getDutyCyclePercent(floatTerms, floatState) - getDutyCyclePercent(fixedPointTerms, fixedPointState));
+		worstDifferencePercent = std::fmax(worstDifferencePercent, difference);
+	}
+
+	SerialHandler::SafeWriteLn(Utils::StringFormat("Worst fixed point duty cycle difference: %0.5f%%", worstDifferencePercent), true);
+	TEST_ASSERT_LESS_THAN_FLOAT(MAX_DUTY_CYCLE_DIFFERENCE_PERCENT, worstDifferencePercent);
+}
+
+/**
+ * @brief  A Multi-Zone PID Controller zone produces the same duty cycle as the PID Controller given the same settings
+ *         and readings. With -DPID_USE_FIXED_POINT, only the PID Controller is in fixed point, so the two may differ by
+ *         the same amount as the engines do.
+*/
+void test_multi_zone_matches_single_zone()
+{
+	constexpr PIDControllerInitData defaults = GetDefaultPIDControllerInitData();
+	simulatedMillis = 0;
+
+	startPidController(defaults);
+
+	MultiZonePIDController multiZonePidController;
+	multiZonePidController.SetTimeSource(getSimulatedMillis);
+	multiZonePidController.Init(2, defaults.LoopTimeStepMs);
+	for (uint8_t zone = 0; zone < 2; ++zone)
+	{
+		multiZonePidController.ConfigureZone(zone, defaults);
+		multiZonePidController.SetZoneIsEnabled(zone, true);
+	}
+
+	uint32_t loopsCompared = 0;
+	for (uint32_t loop = 0; loop < 600; ++loop)
+	{
+		simulatedMillis += defaults.LoopTimeStepMs;
+		const float temperature = 18.0f + (0.01f * static_cast<float>(loop)) + (0.05f * static_cast<float>(loop % 7));
+		PIDController::SetCurrentTemperature(temperature, simulatedMillis);
+		PIDController::Update();
+		multiZonePidController.SetCurrentTemperature(0, temperature);
+		multiZonePidController.SetCurrentTemperature(1, temperature - 1.0f);
+		if (!multiZonePidController.Update() || !PIDController::HasNewLoopRunSinceLastCheck())
+		{
+			continue;
+		}
+
+		TEST_ASSERT_FLOAT_WITHIN(MAX_DUTY_CYCLE_DIFFERENCE_PERCENT, PIDController::GetCurrentDutyCyclePercent(), multiZonePidController.GetCurrentDutyCyclePercent(0));
+		loopsCompared++;
+	}
+
+	PIDController::SetTimeSource(nullptr);
+	TEST_ASSERT_GREATER_THAN(500, loopsCompared);
+}
+
+/**
+ * @brief  Zones whose gains pick different PID Engine variants, listed out of variant order, each give the same duty
+ *         cycle as they do when run on their own, so the passes grouped by variant visit every zone exactly once.
+*/
+void test_multi_zone_mixed_variants_match_separate_zones()
+{
+	constexpr PIDControllerInitData defaults = GetDefaultPIDControllerInitData();
+	constexpr uint8_t zoneCount = 3;
+	std::array<PIDControllerInitData, zoneCount> zoneData = {defaults, defaults, defaults};
+	zoneData[1].IntegralGain = 0.0f;
+	zoneData[1].DerivativeGain = 0.0f;
+	zoneData[2].DerivativeGain = 0.0f;
+	simulatedMillis = 0;
+
+	MultiZonePIDController mixedController;
+	std::array<MultiZonePIDController, zoneCount> separateControllers;
+	mixedController.SetTimeSource(getSimulatedMillis);
+	mixedController.Init(zoneCount, defaults.LoopTimeStepMs);
+	for (uint8_t zone = 0; zone < zoneCount; ++zone)
+	{
+		mixedController.ConfigureZone(zone, zoneData[zone]);
+		mixedController.SetZoneIsEnabled(zone, true);
+		separateControllers[zone].SetTimeSource(getSimulatedMillis);
+		separateControllers[zone].Init(1, defaults.LoopTimeStepMs);
+		separateControllers[zone].ConfigureZone(0, zoneData[zone]);
+		separateControllers[zone].SetZoneIsEnabled(0, true);
+	}
+
+	uint32_t loopsCompared = 0;
+	for (uint32_t loop = 0; loop < 200; ++loop)
+	{
+		simulatedMillis += defaults.LoopTimeStepMs;
+		for (uint8_t zone = 0; zone < zoneCount; ++zone)
+		{
+			const float temperature = 16.0f + static_cast<float>(zone) + (0.02f * static_cast<float>(loop));
+			mixedController.SetCurrentTemperature(zone, temperature);
+			separateControllers[zone].SetCurrentTemperature(0, temperature);
+			std::ignore = separateControllers[zone].Update();
+		}
+		if (!mixedController.Update())
+		{
+			continue;
+		}
+
+		for (uint8_t zone = 0; zone < zoneCount; ++zone)
+		{
+			TEST_ASSERT_EQUAL_FLOAT(separateControllers[zone].GetCurrentDutyCyclePercent(0), mixedController.GetCurrentDutyCyclePercent(zone));
+		}
+		loopsCompared++;
+	}
+
+	TEST_ASSERT_GREATER_THAN(150, loopsCompared);
+}
+
+/**
+ * @brief  With readings 100 ms apart, up to 30 ms of jitter and the odd one missing, the loop runs on the reading
+ *         nearest each time step's tick, so it keeps to the time step instead of drifting late.
+*/
+void test_loop_runs_on_time_step_grid()
+{
+	constexpr PIDControllerInitData defaults = GetDefaultPIDControllerInitData();
+	simulatedMillis = 0;
+	std::srand(1);
+
+	startPidController(defaults);
+
+	uint32_t loopsRun = 0;
+	uint32_t loopsOnGrid = 0;
+	uint32_t millisValueAtLastLoop = 0;
+	for (uint32_t reading = 0; reading < 3000; ++reading)
+	{
+		simulatedMillis = (reading * READING_INTERVAL_MS) + static_cast<uint32_t>(std::rand() % MAX_READING_JITTER_MS);
+		if ((reading % 97) == 50)
+		{
+			continue;
+		}
+
+		PIDController::SetCurrentTemperature(20.0f, simulatedMillis);
+		PIDController::Update();
+		if (!PIDController::HasNewLoopRunSinceLastCheck())
+		{
+			continue;
+		}
+
+		const uint32_t loopIntervalMs = simulatedMillis - millisValueAtLastLoop;
+		if ((loopsRun > 0) && (std::abs(static_cast<int32_t>(loopIntervalMs) - defaults.LoopTimeStepMs) <= (MAX_READING_JITTER_MS + LOOP_TICK_TOLERANCE_MS)))
+		{
+			loopsOnGrid++;
+		}
+		loopsRun++;
+		millisValueAtLastLoop = simulatedMillis;
+	}
+
+	PIDController::SetTimeSource(nullptr);
+	SerialHandler::SafeWriteLn(Utils::StringFormat("Time step grid: %u of %u loops on the grid", loopsOnGrid, loopsRun), true);
+
+	// 3000 readings 100 ms apart cover 600 time steps, and each missing reading can push at most one loop off the grid.
+	TEST_ASSERT_UINT32_WITHIN(3, 600, loopsRun);
+	TEST_ASSERT_GREATER_OR_EQUAL(loopsRun - 1 - (3000 / 97) - 1, loopsOnGrid);
+}
+
+/**
+ * @brief  With the heater derated, the duty cycle never goes above the limit, and the integral doesn't wind up beyond
+ *         it, so the output comes straight back down when the error does.
+*/
+void test_output_limit_caps_duty_cycle_and_integral()
+{
+	constexpr PIDControllerInitData defaults = GetDefaultPIDControllerInitData();
+	simulatedMillis = 0;
+
+	startPidController(defaults);
+	PIDController::SetOutputLimitPercent(60.0f);
+
+	for (uint32_t loop = 0; loop < 400; ++loop)
+	{
+		simulatedMillis += defaults.LoopTimeStepMs;
+		PIDController::SetCurrentTemperature(defaults.TemperatureSetPointDegCent - 5.0f, simulatedMillis);
+		PIDController::Update();
+		TEST_ASSERT_LESS_OR_EQUAL(60, static_cast<int32_t>(PIDController::GetCurrentDutyCyclePercent()));
+	}
+
+	// Right on the set point, only the integral is left, and it was held at the limit.
+	simulatedMillis += defaults.LoopTimeStepMs;
+	PIDController::SetCurrentTemperature(defaults.TemperatureSetPointDegCent, simulatedMillis);
+	PIDController::Update();
+	TEST_ASSERT_LESS_THAN_FLOAT(60.5f, PIDController::GetCurrentDutyCyclePercent());
+
+	PIDController::SetOutputLimitPercent(100.0f);
+	PIDController::SetTimeSource(nullptr);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_fixed_point_engine_matches_float);
+	RUN_TEST(test_multi_zone_matches_single_zone);
+	RUN_TEST(test_multi_zone_mixed_variants_match_separate_zones);
+	RUN_TEST(test_loop_runs_on_time_step_grid);
+	RUN_TEST(test_output_limit_caps_duty_cycle_and_integral);
+	return UNITY_END();
+}
@@ -0,0 +1,111 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include <cstdint>
+#include <unity.h>
+
+#include "Control/PowerBudget.h"
+#include "IO/FanControl.h"
+#include "IO/HeaterControl.h"
+#include "NativeShims.h"
+
+
+/**
+ * @brief                        Runs the Power Budget for a while with the same requests, 100 ms apart.
+ *
+ * @param  HeaterRequestPercent  The heater power level requested.
+ * @param  FanDutyCyclePercent   The fan's duty cycle.
+ * @param  Updates               The number of updates to run.
+*/
+static void runUpdates(const float HeaterRequestPercent, const float FanDutyCyclePercent, const uint32_t Updates)
+{
+	for (uint32_t update = 0; update < Updates; ++update)
+	{
+		NativeShims::AdvanceMicros(100000);
+		PowerBudget::Update(HeaterRequestPercent, FanDutyCyclePercent);
+	}
+}
+
+#ifndef POWER_BUDGET_MAX_WATTS
+/**
+ * @brief  Without a budget set, the heater gets whatever it asks for, whatever the fan is doing.
+*/
+void test_heater_never_limited_without_budget()
+{
+	PowerBudget::Init();
+	runUpdates(100.0f, 100.0f, 50);
+	TEST_ASSERT_FALSE(PowerBudget::IsHeaterLimited());
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f, PowerBudget::GetHeaterPowerLevel());
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f, PowerBudget::GetHeaterPowerLimit());
+}
+#else
+#define HEATER_LIMIT_WITH_FAN_OFF_PERCENT   (100.0f * POWER_BUDGET_MAX_WATTS / HEATER_ELEMENT_WATTAGE)
+#define HEATER_LIMIT_WITH_FAN_ON_PERCENT    (100.0f * (POWER_BUDGET_MAX_WATTS - FAN_RATED_WATTAGE) / HEATER_ELEMENT_WATTAGE)
+
+/**
+ * @brief  A budget below the element's rating limits the heater even with the fan off, e.g. 1200 W leaves 80% of the
+ *         1500 W element, and the fan's 6 W at full speed takes the limit down to 79.6% straight away. A request under the limit is passed through as it is, and the heater is
+ *         only reported as no longer limited once it has stayed under the limit for a while.
+*/
+void test_heater_derated_to_budget()
+{
+	PowerBudget::Init();
+	runUpdates(100.0f, 0.0f, 50);
+	TEST_ASSERT_TRUE(PowerBudget::IsHeaterLimited());
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, HEATER_LIMIT_WITH_FAN_OFF_PERCENT, PowerBudget::GetHeaterPowerLevel());
+
+	runUpdates(100.0f, 100.0f, 1);
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, HEATER_LIMIT_WITH_FAN_ON_PERCENT, PowerBudget::GetHeaterPowerLimit());
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, HEATER_LIMIT_WITH_FAN_ON_PERCENT, PowerBudget::GetHeaterPowerLevel());
+
+	const float requestJustUnderLimit = HEATER_LIMIT_WITH_FAN_ON_PERCENT - 0.6f;
+	runUpdates(requestJustUnderLimit, 100.0f, 10);
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, requestJustUnderLimit, PowerBudget::GetHeaterPowerLevel());
+	TEST_ASSERT_TRUE(PowerBudget::IsHeaterLimited());
+
+	const float requestWellUnderLimit = HEATER_LIMIT_WITH_FAN_ON_PERCENT / 2;
+	runUpdates(requestWellUnderLimit, 100.0f, 100);
+	TEST_ASSERT_FALSE(PowerBudget::IsHeaterLimited());
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, requestWellUnderLimit, PowerBudget::GetHeaterPowerLevel());
+}
+
+/**
+ * @brief  The fan's draw rises with the cube of its speed, so at half speed it only takes an eighth of its rating.
+*/
+void test_fan_draw_follows_cube_of_speed()
+{
+	PowerBudget::Init();
+	runUpdates(100.0f, 50.0f, 1);
+	TEST_ASSERT_FLOAT_WITHIN(0.001f, 100.0f * (POWER_BUDGET_MAX_WATTS - (FAN_RATED_WATTAGE / 8.0f)) / HEATER_ELEMENT_WATTAGE, PowerBudget::GetHeaterPowerLimit());
+}
+#endif
+
+void setUp()
+{
+	NativeShims::Reset();
+}
+
+void tearDown()
+{
+}
+
+int main()
+{
+	UNITY_BEGIN();
+#ifndef POWER_BUDGET_MAX_WATTS
+	RUN_TEST(test_heater_never_limited_without_budget);
+#else
+	RUN_TEST(test_heater_derated_to_budget);
+	RUN_TEST(test_fan_draw_follows_cube_of_speed);
+#endif
+	return UNITY_END();
+}
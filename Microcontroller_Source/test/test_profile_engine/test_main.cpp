@@ -0,0 +1,60 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include <array>
+#include <cstdint>
+#include <unity.h>
+
+#include "Control/ProfileEngine.h"
+#include "NativeShims.h"
+
+
+/**
+ * @brief  Ramps to the set point limits themselves are accepted, and the profile runs.
+*/
+void test_ramps_to_the_set_point_limits_are_accepted()
+{
+	constexpr std::array<ProfileStep, 3> steps = {ProfileEngine::Ramp(40.0, 0.0), ProfileEngine::Ramp(-20.0, 0.0), ProfileEngine::End()};
+	TEST_ASSERT_TRUE(ProfileEngine::Start(steps.data(), steps.size(), 20.0f));
+	ProfileEngine::Stop();
+}
+
+/**
+ * @brief  A ramp above 40 °C or below -20 °C is rejected, as the PID Controller would clamp the set point it asks for.
+*/
+void test_ramps_past_the_set_point_limits_are_rejected()
+{
+	constexpr std::array<ProfileStep, 2> tooHotSteps = {ProfileEngine::Ramp(40.1, 1.0), ProfileEngine::End()};
+	constexpr std::array<ProfileStep, 3> tooColdSteps = {ProfileEngine::Soak(1), ProfileEngine::Ramp(-20.1, 1.0), ProfileEngine::End()};
+	TEST_ASSERT_FALSE(ProfileEngine::Start(tooHotSteps.data(), tooHotSteps.size(), 20.0f));
+	TEST_ASSERT_FALSE(ProfileEngine::Start(tooColdSteps.data(), tooColdSteps.size(), 20.0f));
+	TEST_ASSERT_FALSE(ProfileEngine::IsRunning());
+}
+
+void setUp()
+{
+	NativeShims::Reset();
+}
+
+void tearDown()
+{
+}
+
+int main()
+{
+	ProfileEngine::Init();
+
+	UNITY_BEGIN();
+	RUN_TEST(test_ramps_to_the_set_point_limits_are_accepted);
+	RUN_TEST(test_ramps_past_the_set_point_limits_are_rejected);
+	return UNITY_END();
+}
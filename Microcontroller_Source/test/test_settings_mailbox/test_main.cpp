@@ -0,0 +1,141 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include <Arduino.h>
+#include <cstdint>
+#include <string>
+#include <unity.h>
+
+#include "Control/PIDController.h"
+#include "InitDataTypes/PIDSettingsSchema.h"
+#include "Misc/HeapAllocationCounter.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/SettingsMailbox.h"
+#include "NativeShims.h"
+
+
+/**
+ * @brief  Packets come out in the order they went in, and a full mailbox turns new packets away rather than
+ *         overwriting old ones.
+*/
+void test_mailbox_is_fifo_and_holds_capacity_minus_one()
+{
+	SettingsMailbox<PIDIntDataPacket, 4> mailbox;
+	for (int32_t value = 0; value < 3; ++value)
+	{
+		TEST_ASSERT_TRUE(mailbox.Push({LoopTimeStep, value}));
+	}
+	TEST_ASSERT_FALSE(mailbox.Push({LoopTimeStep, 3}));
+
+	PIDIntDataPacket packet = {};
+	for (int32_t value = 0; value < 3; ++value)
+	{
+		TEST_ASSERT_TRUE(mailbox.Pop(&packet));
+		TEST_ASSERT_EQUAL_INT32(value, packet.Value);
+	}
+	TEST_ASSERT_FALSE(mailbox.Pop(&packet));
+}
+
+/**
+ * @brief  Wrapping round the end of the slots doesn't lose or reorder packets.
+*/
+void test_mailbox_wraps_around()
+{
+	SettingsMailbox<PIDIntDataPacket, 4> mailbox;
+	PIDIntDataPacket packet = {};
+	for (int32_t value = 0; value < 20; ++value)
+	{
+		TEST_ASSERT_TRUE(mailbox.Push({LoopTimeStep, value}));
+		TEST_ASSERT_TRUE(mailbox.Pop(&packet));
+		TEST_ASSERT_EQUAL_INT32(value, packet.Value);
+	}
+}
+
+/**
+ * @brief  Handing settings to the PID Controller through the mailbox, and running its loop, doesn't touch the heap.
+*/
+void test_settings_changes_do_not_allocate()
+{
+	PIDController::Init(GetDefaultPIDControllerInitData());
+	PIDController::SetControlLoopIsEnabled(true);
+
+	uint32_t allocations = 0;
+	uint32_t loopsRun = 0;
+	for (uint32_t loop = 0; loop < 4000; ++loop)
+	{
+		NativeShims::AdvanceMicros(50000);
+		const uint32_t countAtStartOfLoop = HeapAllocationCounter::GetCount();
+
+		if ((loop % 500) == 0)
+		{
+			TEST_ASSERT_TRUE(SettingsMailboxes::FloatSettings.Push({ProportionalGain, 2.0f + (static_cast<float>(loop) / 1000)}));
+		}
+		PIDFloatDataPacket changedFloatSetting = {};
+		while (SettingsMailboxes::FloatSettings.Pop(&changedFloatSetting))
+		{
+			PIDController::ChangeFloatSetting(changedFloatSetting);
+		}
+		if ((loop % 10) == 0)
+		{
+			PIDController::SetCurrentTemperature(20.0f + (static_cast<float>(loop) / 1000), millis());
+		}
+		PIDController::Update();
+		loopsRun += PIDController::HasNewLoopRunSinceLastCheck() ? 1 : 0;
+
+		allocations += HeapAllocationCounter::GetCount() - countAtStartOfLoop;
+	}
+
+	TEST_ASSERT_GREATER_THAN(300, loopsRun);
+	TEST_ASSERT_EQUAL_UINT32(0, allocations);
+}
+
+/**
+ * @brief  The allocation counter sees allocations, so the checks that none were made mean something.
+*/
+void test_allocation_counter_counts()
+{
+	const uint32_t countBeforeAllocation = HeapAllocationCounter::GetCount();
+	const std::string longMessage(100, 'x');
+	TEST_ASSERT_EQUAL(100, longMessage.size());
+	TEST_ASSERT_GREATER_THAN(countBeforeAllocation, HeapAllocationCounter::GetCount());
+}
+
+/**
+ * @brief  A message that isn't going to be written doesn't allocate, so debug messages cost nothing while their
+ *         trigger is off.
+*/
+void test_unwritten_message_does_not_allocate()
+{
+	const uint32_t countBeforeWrite = HeapAllocationCounter::GetCount();
+	SerialHandler::SafeWriteLn("Not written.", false);
+	TEST_ASSERT_EQUAL_UINT32(countBeforeWrite, HeapAllocationCounter::GetCount());
+}
+
+void setUp()
+{
+	NativeShims::Reset();
+}
+
+void tearDown()
+{
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_mailbox_is_fifo_and_holds_capacity_minus_one);
+	RUN_TEST(test_mailbox_wraps_around);
+	RUN_TEST(test_allocation_counter_counts);
+	RUN_TEST(test_settings_changes_do_not_allocate);
+	RUN_TEST(test_unwritten_message_does_not_allocate);
+	return UNITY_END();
+}
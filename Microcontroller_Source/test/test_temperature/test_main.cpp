@@ -0,0 +1,339 @@
+// This code is provided under the MPL v2.0 license. Copyright 2025 Xavier du Hecquet de Rauville
+// Details may be found in License.txt
+//
+//  This Source Code Form is subject to the terms of the Mozilla Public
+//  License, v. 2.0. If a copy of the MPL was not distributed with this
+//  file, You can obtain one at https://mozilla.org/MPL/2.0/.
+//
+//  This Source Code Form is "Incompatible With Secondary Licenses", as
+//  defined by the Mozilla Public License, v. 2.0.
+
+
+
+#include <Arduino.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <unity.h>
+
+#include "IO/PolledThermistorAdc.h"
+#include "IO/Temperature.h"
+#include "IO/ThermistorLookupTable.h"
+#include "Misc/SerialHandler.h"
+#include "Misc/Utils.h"
+#include "NativeShims.h"
+#include "Simulation/FakeThermistorAdc.h"
+
+
+#define UNPLUGGED_ADC_CODE          0
+#define SHORT_CIRCUIT_ADC_CODE      4095
+#define VARIANCE_TOLERANCE          0.001f
+#define FULL_READING_TIMEOUT_MS     1000
+#define MAX_TABLE_ERROR_C           0.085
+#define TABLE_CHECK_MIN_C           (-20.0)
+#define TABLE_CHECK_MAX_C           40.0
+
+
+/**
+ * @brief  A known burst, and what reducing it should give. The out of range samples come first, then the in range
+ *         samples alternate between the even and odd sample codes.
+*/
+struct burstCase
+{
+	uint16_t BurstLength;
+	uint16_t EvenSampleAdcCode;
+	uint16_t OddSampleAdcCode;
+	uint16_t UnpluggedSamples;
+	uint16_t ShortCircuitSamples;
+	TempReadingResult ExpectedResult;
+	uint32_t ExpectedAverageAdcCode;
+	float ExpectedSampleVariance;
+};
+
+
+static FakeThermistorAdc fakeAdc;
+
+
+/**
+ * @brief        Gives the Fake Thermistor ADC a case's burst.
+ *
+ * @param  Case  The case to make the burst for.
+*/
+static void setBurstSamples(const burstCase& Case)
+{
+	ThermistorAdc::burstSamples samples = {};
+	for (uint16_t i = 0; i < samples.size(); ++i)
+	{
+		if (i < Case.UnpluggedSamples)
+		{
+			samples[i] = UNPLUGGED_ADC_CODE;
+		}
+		else if (i < (Case.UnpluggedSamples + Case.ShortCircuitSamples))
+		{
+			samples[i] = SHORT_CIRCUIT_ADC_CODE;
+		}
+		else
+		{
+			samples[i] = ((i % 2) == 0) ? Case.EvenSampleAdcCode : Case.OddSampleAdcCode;
+		}
+	}
+	fakeAdc.SetBurstSamples(samples);
+}
+
+/**
+ * @brief        Collects a case's burst from the Fake Thermistor ADC, reduces it, and checks it against the expected
+ *               values. The average and variance are only checked when the burst didn't indicate a fault.
+ *
+ * @param  Case  The case to check.
+*/
+static void checkReduction(const burstCase& Case)
+{
+	setBurstSamples(Case);
+	fakeAdc.SetBurstLength(Case.BurstLength);
+	fakeAdc.StartBurst();
+	TEST_ASSERT_TRUE(fakeAdc.IsBurstComplete());
+
+	uint32_t averageAdcCode = 0;
+	uint16_t outlierSamples = 0;
+	float sampleVariance = 0.0f;
+	const TempReadingResult result = Temperature::ReduceBurstSamples(fakeAdc.GetBurstSamples(OutletProbe), fakeAdc.GetBurstLength(),
+	                                                                 &averageAdcCode, &outlierSamples, &sampleVariance);
+
+	TEST_ASSERT_EQUAL(Case.ExpectedResult, result);
+	TEST_ASSERT_EQUAL_UINT16(Case.UnpluggedSamples + Case.ShortCircuitSamples, outlierSamples);
+	if (result == TempReadingResult::TempReadSuccessfully)
+	{
+		TEST_ASSERT_EQUAL_UINT32(Case.ExpectedAverageAdcCode, averageAdcCode);
+		TEST_ASSERT_FLOAT_WITHIN(VARIANCE_TOLERANCE, Case.ExpectedSampleVariance, sampleVariance);
+	}
+}
+
+/**
+ * @brief    Polls the Temperature class until it finishes a reading.
+ *
+ * @return   The reading, or the last in progress result if it timed out.
+*/
+static TempReadData readUntilComplete()
+{
+	const uint32_t millisValueAtStart = millis();
+	TempReadData readData = {};
+	do
+	{
+		NativeShims::AdvanceMicros(1000);
+		readData = Temperature::Read();
+	}
+	while ((readData.Result == TempReadingResult::ProcessingCurrentRequest) && ((millis() - millisValueAtStart) < FULL_READING_TIMEOUT_MS));
+	return readData;
+}
+
+// Averages carry THERMISTOR_ADC_CODE_FRACTIONAL_BITS fractional bits, so 350 codes is 5600. Variances are in codes squared.
+void test_steady_burst()
+{
+	checkReduction({200, 350, 350, 0, 0, TempReadingResult::TempReadSuccessfully, 5600, 0.0f});
+}
+
+void test_burst_alternating_by_one_code()
+{
+	checkReduction({200, 349, 351, 0, 0, TempReadingResult::TempReadSuccessfully, 5600, 200.0f / 199});
+}
+
+void test_burst_alternating_by_half_a_code()
+{
+	checkReduction({200, 350, 351, 0, 0, TempReadingResult::TempReadSuccessfully, 5608, 50.0f / 199});
+}
+
+void test_burst_with_a_few_dropouts()
+{
+	checkReduction({200, 349, 351, 10, 0, TempReadingResult::TempReadSuccessfully, 5600, 190.0f / 189});
+}
+
+void test_shortest_burst()
+{
+	checkReduction({16, 352, 352, 0, 0, TempReadingResult::TempReadSuccessfully, 5632, 0.0f});
+}
+
+void test_unplugged_probe()
+{
+	checkReduction({200, 350, 350, 200, 0, TempReadingResult::ProbeUnplugged, 0, 0.0f});
+}
+
+void test_short_circuited_probe()
+{
+	checkReduction({200, 350, 350, 0, 200, TempReadingResult::ProbeShortCircuit, 0, 0.0f});
+}
+
+/**
+ * @brief  A burst taken all the way through Temperature::Read comes out as a reading with the burst's sample count,
+ *         outliers and variance. Short enough on dropouts to pass whatever burst length the Temperature class is using.
+*/
+void test_full_reading_through_fake_adc()
+{
+	const burstCase fullReadingCase = {Temperature::GetSamplesPerBurst(), 350, 350, 2, 0, TempReadingResult::TempReadSuccessfully, 5600, 0.0f};
+	setBurstSamples(fullReadingCase);
+	Temperature::SetAdc(&fakeAdc);
+
+	const TempReadData readData = readUntilComplete();
+	Temperature::SetAdc(nullptr);
+
+	TEST_ASSERT_EQUAL(TempReadingResult::TempReadSuccessfully, readData.Result);
+	TEST_ASSERT_EQUAL_UINT16(fullReadingCase.BurstLength, readData.SampleCount);
+	TEST_ASSERT_EQUAL_UINT16(2, readData.OutlierSamples);
+	TEST_ASSERT_FLOAT_WITHIN(VARIANCE_TOLERANCE, 0.0f, readData.SampleVariance);
+	TEST_ASSERT_FLOAT_WITHIN(0.1f, 20.0f, readData.Temp);
+}
+
+/**
+ * @brief  The polled ADC expects its next burst to take as long per sample as the last one actually did, rather than
+ *         THERMISTOR_ADC_SAMPLE_PERIOD_US, so a main loop that polls it slowly doesn't get bursts scheduled across a
+ *         heater switch.
+*/
+void test_polled_burst_duration_follows_polling()
+{
+	PolledThermistorAdc polledAdc;
+	const uint8_t adcChannel = 0;
+	polledAdc.SetChannels(&adcChannel, 1);
+	polledAdc.SetBurstLength(20);
+	TEST_ASSERT_EQUAL_UINT32(20 * THERMISTOR_ADC_SAMPLE_PERIOD_US, polledAdc.GetExpectedBurstDurationUs(20));
+
+	const uint32_t pollPeriodUs = 4 * THERMISTOR_ADC_SAMPLE_PERIOD_US;
+	polledAdc.StartBurst();
+	while (!polledAdc.IsBurstComplete())
+	{
+		NativeShims::AdvanceMicros(pollPeriodUs);
+	}
+
+	// The first sample is taken straight away, so the burst is one poll short of a full period per sample.
+	const uint32_t expectedDurationUs = polledAdc.GetExpectedBurstDurationUs(40);
+	TEST_ASSERT_UINT32_WITHIN(2 * pollPeriodUs, 40 * pollPeriodUs, expectedDurationUs);
+}
+
+/**
+ * @brief  The lookup table's interpolation, fractional bits included, stays within 0.085 °C of the Beta equation across
+ *         -20 °C to 40 °C. The compile time check covers the same bound; this one runs the conversion the firmware uses.
+*/
+void test_lookup_table_matches_beta_equation()
+{
+	constexpr uint32_t maxAdcCode = (THERMISTOR_TABLE_ADC_CODES - 1) << THERMISTOR_ADC_CODE_FRACTIONAL_BITS;
+	constexpr double fractionalCodesPerCode = 1 << THERMISTOR_ADC_CODE_FRACTIONAL_BITS;
+
+	uint32_t codesChecked = 0;
+	double worstErrorC = 0.0;
+	for (uint32_t adcCode = 0; adcCode <= maxAdcCode; ++adcCode)
+	{
+		const double expectedC = ThermistorLookupTable::CalculateTemperatureC(adcCode / fractionalCodesPerCode);
+		if ((expectedC < TABLE_CHECK_MIN_C) || (expectedC > TABLE_CHECK_MAX_C))
+		{
+			continue;
+		}
+
+		const double convertedC = ThermistorLookupTable::ConvertToCentiDegreesC(adcCode) * 0.01;
+		worstErrorC = std::fmax(worstErrorC, std::fabs(convertedC - expectedC));
+		codesChecked++;
+	}
+
+	SerialHandler::SafeWriteLn(Utils::StringFormat("Lookup table: worst error %0.4f°C over %u codes", worstErrorC, codesChecked), true);
+	TEST_ASSERT_GREATER_THAN(1000, codesChecked);
+	TEST_ASSERT_LESS_THAN_FLOAT(MAX_TABLE_ERROR_C, worstErrorC);
+}
+
+#ifdef TEMPERATURE_ADAPTIVE_OVERSAMPLING
+static std::mt19937 noiseGenerator;
+static float noiseStandardDeviation = 0.0f;
+
+/**
+ * @brief         Stands in for analogRead, returning a steady 20 °C code with Gaussian noise. Each conversion takes
+ *                15 µs, like the real ADC.
+ *
+ * @param  Pin    The pin being read. Unused.
+ *
+ * @return        The noisy ADC code.
+*/
+static uint16_t readNoisyAdc([[maybe_unused]] const uint8_t Pin)
+{
+	NativeShims::AdvanceMicros(15);
+	std::normal_distribution<float> noise(350.0f, noiseStandardDeviation);
+	return static_cast<uint16_t>(std::lround(noise(noiseGenerator)));
+}
+
+/**
+ * @brief                      Takes readings from a probe with the given noise until the burst length has settled.
+ *
+ * @param  StandardDeviation   The noise on each sample, in ADC codes.
+ *
+ * @return                     The average number of samples in the settled bursts.
+*/
+static float measureSettledBurstLength(const float StandardDeviation)
+{
+	noiseStandardDeviation = StandardDeviation;
+	uint32_t readings = 0;
+	uint32_t settledSampleTotal = 0;
+	while (readings < 200)
+	{
+		const TempReadData readData = readUntilComplete();
+		TEST_ASSERT_EQUAL(TempReadingResult::TempReadSuccessfully, readData.Result);
+		readings++;
+		if (readings > 100)
+		{
+			settledSampleTotal += readData.SampleCount;
+		}
+	}
+	return static_cast<float>(settledSampleTotal) / 100;
+}
+
+/**
+ * @brief  The burst length follows the probe's noise: quiet probes get short bursts, noisy ones long bursts, and the
+ *         length comes back down when the noise does.
+*/
+void test_adaptive_oversampling_follows_noise()
+{
+	NativeShims::SetAnalogReadSource(readNoisyAdc);
+	noiseGenerator.seed(1);
+	Temperature::Init();
+
+	std::array<float, 5> burstLengths = {};
+	const std::array<float, 5> standardDeviations = {0.5f, 1.0f, 2.0f, 4.0f, 1.0f};
+	for (uint8_t i = 0; i < standardDeviations.size(); ++i)
+	{
+		burstLengths[i] = measureSettledBurstLength(standardDeviations[i]);
+		SerialHandler::SafeWriteLn(Utils::StringFormat("Noise %0.1f codes: %0.1f samples per burst", standardDeviations[i], burstLengths[i]), true);
+	}
+
+	TEST_ASSERT_LESS_THAN_FLOAT(24.0f, burstLengths[0]);
+	TEST_ASSERT_LESS_THAN_FLOAT(burstLengths[2], burstLengths[1]);
+	TEST_ASSERT_LESS_THAN_FLOAT(burstLengths[3], burstLengths[2]);
+	TEST_ASSERT_GREATER_THAN_FLOAT(190.0f, burstLengths[3]);
+	TEST_ASSERT_FLOAT_WITHIN(0.25f * burstLengths[1], burstLengths[1], burstLengths[4]);
+	NativeShims::SetAnalogReadSource(nullptr);
+}
+#endif
+
+void setUp()
+{
+	NativeShims::Reset();
+}
+
+void tearDown()
+{
+}
+
+int main()
+{
+	Temperature::Init();
+
+	UNITY_BEGIN();
+	RUN_TEST(test_steady_burst);
+	RUN_TEST(test_burst_alternating_by_one_code);
+	RUN_TEST(test_burst_alternating_by_half_a_code);
+	RUN_TEST(test_burst_with_a_few_dropouts);
+	RUN_TEST(test_shortest_burst);
+	RUN_TEST(test_unplugged_probe);
+	RUN_TEST(test_short_circuited_probe);
+	RUN_TEST(test_full_reading_through_fake_adc);
+	RUN_TEST(test_polled_burst_duration_follows_polling);
+	RUN_TEST(test_lookup_table_matches_beta_equation);
+#ifdef TEMPERATURE_ADAPTIVE_OVERSAMPLING
+	RUN_TEST(test_adaptive_oversampling_follows_noise);
+#endif
+	return UNITY_END();
+}